@@ -0,0 +1,105 @@
+#include <ktl/atomic>
+
+#include "bench.hh"
+
+HOST_BENCH(atomic_u64_load) {
+    ktl::atomic_u64 a(1);
+    u64 sum = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        sum += a.load();
+    }
+    hostbench::doNotOptimize(sum);
+}
+
+HOST_BENCH(atomic_u64_store) {
+    ktl::atomic_u64 a(0);
+    for (u64 i = 0; i < iters; ++i) {
+        a.store(i);
+    }
+    hostbench::doNotOptimize(a);
+}
+
+HOST_BENCH(atomic_u64_fetch_add) {
+    ktl::atomic_u64 a(0);
+    for (u64 i = 0; i < iters; ++i) {
+        a.fetch_add(1);
+    }
+    hostbench::doNotOptimize(a);
+}
+
+HOST_BENCH(atomic_u64_exchange) {
+    ktl::atomic_u64 a(0);
+    for (u64 i = 0; i < iters; ++i) {
+        hostbench::doNotOptimize(a.exchange(i));
+    }
+}
+
+HOST_BENCH(atomic_u64_compare_exchange) {
+    ktl::atomic_u64 a(0);
+    for (u64 i = 0; i < iters; ++i) {
+        u64 expected = i;
+        a.compare_exchange_strong(expected, i + 1);
+    }
+    hostbench::doNotOptimize(a);
+}
+
+HOST_BENCH(atomic_u32_fetch_add) {
+    ktl::atomic_u32 a(0);
+    for (u64 i = 0; i < iters; ++i) {
+        a.fetch_add(1);
+    }
+    hostbench::doNotOptimize(a);
+}
+
+HOST_BENCH(atomic_u64_fetch_add_relaxed) {
+    ktl::atomic_u64 a(0);
+    for (u64 i = 0; i < iters; ++i) {
+        a.fetch_add(1, ktl::memory_order_relaxed);
+    }
+    hostbench::doNotOptimize(a);
+}
+
+HOST_BENCH(atomic_u64_load_acquire) {
+    ktl::atomic_u64 a(1);
+    u64 sum = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        sum += a.load(ktl::memory_order_acquire);
+    }
+    hostbench::doNotOptimize(sum);
+}
+
+HOST_BENCH(atomic_u64_store_release) {
+    ktl::atomic_u64 a(0);
+    for (u64 i = 0; i < iters; ++i) {
+        a.store(i, ktl::memory_order_release);
+    }
+    hostbench::doNotOptimize(a);
+}
+
+HOST_BENCH(atomic_u64_fetch_or) {
+    ktl::atomic_u64 a(0);
+    for (u64 i = 0; i < iters; ++i) {
+        hostbench::doNotOptimize(a.fetch_or(i & 63));
+    }
+}
+
+HOST_BENCH(atomic_u8_exchange) {
+    ktl::atomic_u8 a(0);
+    for (u64 i = 0; i < iters; ++i) {
+        hostbench::doNotOptimize(a.exchange(static_cast<u8>(i)));
+    }
+}
+
+HOST_BENCH(atomic_tagged_ptr_compare_exchange) {
+    struct Tagged {
+        void* ptr;
+        u64   tag;
+    };
+
+    ktl::atomic<Tagged> a(Tagged { nullptr, 0 });
+    for (u64 i = 0; i < iters; ++i) {
+        Tagged expected = a.load(ktl::memory_order_relaxed);
+        a.compare_exchange_weak(expected, Tagged { expected.ptr, expected.tag + 1 });
+    }
+    hostbench::doNotOptimize(a);
+}
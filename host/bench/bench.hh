@@ -0,0 +1,170 @@
+#ifndef HOST_BENCH_HH
+#define HOST_BENCH_HH
+
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Minimal microbenchmark registry for the host build. A benchmark body runs
+// `iters` iterations of the operation under test; the driver in main.cc
+// picks the iteration count, repeats the run and reports ns/op.
+
+namespace hostbench {
+
+struct Benchmark {
+    const char* name;
+    void      (*fn)(u64 iters);
+    Benchmark*  next;
+};
+
+inline Benchmark* g_head = nullptr;
+inline Benchmark* g_tail = nullptr;
+
+struct Registrar {
+    explicit Registrar(Benchmark& b) {
+        if (g_tail) {
+            g_tail->next = &b;
+        } else {
+            g_head = &b;
+        }
+        g_tail = &b;
+    }
+};
+
+// Optional extra figure a benchmark can report next to its timings, e.g. a
+// fairness percentage. The value from the last run is printed.
+inline const char* g_counter_name  = nullptr;
+inline u64         g_counter_value = 0;
+
+inline void counter(const char* name, u64 value) {
+    g_counter_name  = name;
+    g_counter_value = value;
+}
+
+// Called from a body that cannot run meaningfully on this machine.
+inline const char* g_skip_reason = nullptr;
+
+inline void skip(const char* reason) {
+    g_skip_reason = reason;
+}
+
+// Hardware cache misses of the calling thread between start() and stop(),
+// for benchmarks whose point is memory behaviour. valid() is false where
+// the PMU is not exposed (VMs without vPMU, containers, strict
+// perf_event_paranoid); callers then just skip the figure.
+class CacheMisses {
+public:
+    CacheMisses() {
+        perf_event_attr attr {};
+        attr.size           = sizeof(attr);
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    ~CacheMisses() {
+        if (m_fd >= 0) {
+            close(m_fd);
+        }
+    }
+
+    CacheMisses(const CacheMisses&) = delete;
+    CacheMisses& operator=(const CacheMisses&) = delete;
+
+    bool valid() const { return m_fd >= 0; }
+
+    void start() {
+        if (m_fd >= 0) {
+            ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    u64 stop() {
+        u64 count = 0;
+        if (m_fd >= 0) {
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(m_fd, &count, sizeof(count)) != sizeof(count)) {
+                count = 0;
+            }
+        }
+        return count;
+    }
+
+private:
+    int m_fd;
+};
+
+inline int cpuCount() {
+    return static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+}
+
+// Runs fn(index, ctx) on `count` threads, thread i pinned to CPU i, and
+// waits for all of them. The threads are released together once all have
+// started. Callers should skip() when count exceeds cpuCount(): spinning
+// threads sharing a CPU measure the scheduler rather than the code.
+inline void runThreads(int count, void (*fn)(int index, void* ctx), void* ctx) {
+    constexpr int kMaxThreads = 64;
+
+    struct Start {
+        void (*fn)(int, void*);
+        void*   ctx;
+        int     index;
+        int*    ready;
+        int     count;
+    };
+
+    int       ready = 0;
+    Start     starts[kMaxThreads];
+    pthread_t threads[kMaxThreads];
+
+    auto entry = [](void* arg) -> void* {
+        auto* s = static_cast<Start*>(arg);
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(s->index, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+
+        __atomic_add_fetch(s->ready, 1, __ATOMIC_ACQ_REL);
+        while (__atomic_load_n(s->ready, __ATOMIC_ACQUIRE) != s->count) {
+            __builtin_ia32_pause();
+        }
+        s->fn(s->index, s->ctx);
+        return nullptr;
+    };
+
+    for (int i = 0; i < count && i < kMaxThreads; ++i) {
+        starts[i] = { fn, ctx, i, &ready, count };
+        pthread_create(&threads[i], nullptr, entry, &starts[i]);
+    }
+    for (int i = 0; i < count && i < kMaxThreads; ++i) {
+        pthread_join(threads[i], nullptr);
+    }
+}
+
+template<typename T>
+inline void doNotOptimize(const T& value) {
+    __asm__ volatile ("" : : "r,m"(value) : "memory");
+}
+
+inline void clobberMemory() {
+    __asm__ volatile ("" : : : "memory");
+}
+
+} // namespace hostbench
+
+#define HOST_BENCH(_name_)                                                        \
+    static void _name_##_body(u64 iters);                                         \
+    static ::hostbench::Benchmark _name_##_bench { #_name_, _name_##_body, nullptr }; \
+    static ::hostbench::Registrar _name_##_registrar { _name_##_bench };          \
+    static void _name_##_body([[maybe_unused]] u64 iters)
+
+#endif // HOST_BENCH_HH
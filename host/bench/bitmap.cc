@@ -0,0 +1,118 @@
+#include <ktl/bitset>
+
+#include "bench.hh"
+
+// Scans over a 1M-bit bitmap, the size of a PMM bitmap for 4 GiB of
+// 4 KiB pages: walking the set bits of a sparse map word by word against
+// testing every bit, counting with popcnt against the SWAR fallback, and
+// the allocation paths (contiguous runs, atomic single-bit claims).
+
+namespace {
+
+constexpr usize kBits = 1 << 20;
+
+u64 s_sparse_words[kBits / 64];
+u64 s_fragmented_words[kBits / 64];
+
+u64 xorshift(u64& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// About one bit in 256 set, then a fragmented free map for the run
+// search: 3/4 of the bits set in random 1..32-bit stretches.
+struct Maps {
+    ktl::bitmap sparse { s_sparse_words, kBits };
+    ktl::bitmap fragmented { s_fragmented_words, kBits };
+
+    Maps() {
+        u64 seed = 0x9e3779b97f4a7c15ULL;
+        for (usize i = 0; i < kBits / 256; ++i) {
+            sparse.set(xorshift(seed) % kBits);
+        }
+        usize at = 0;
+        while (at < kBits) {
+            const u64   r   = xorshift(seed);
+            const usize len = 1 + (r & 31);
+            const usize n   = len < kBits - at ? len : kBits - at;
+            if ((r >> 8) & 3) {
+                fragmented.set_range(at, n);
+            }
+            at += n;
+        }
+    }
+};
+
+Maps s_maps;
+
+void countBits(u64 iters, bool hardware) {
+    const bool had_popcnt = ktl::detail::g_has_popcnt;
+    ktl::enable_bit_instructions(hardware && __builtin_cpu_supports("popcnt"),
+                                 ktl::detail::g_has_lzcnt);
+    if (hardware && !ktl::detail::g_has_popcnt) {
+        hostbench::skip("no popcnt");
+    }
+    usize total = 0;
+    for (u64 i = 0; i < iters; i += kBits / 64) {
+        total += s_maps.sparse.count();
+    }
+    hostbench::doNotOptimize(total);
+    ktl::enable_bit_instructions(had_popcnt, ktl::detail::g_has_lzcnt);
+}
+
+} // namespace
+
+// ns/op is per set bit visited.
+HOST_BENCH(bitmap_walk_set_bits_1m) {
+    u64   visited = 0;
+    usize i       = s_maps.sparse.find_first_set();
+    while (visited < iters) {
+        if (i == ktl::bitmap::npos) {
+            i = s_maps.sparse.find_first_set();
+        }
+        hostbench::doNotOptimize(i);
+        i = s_maps.sparse.find_next_set(i + 1);
+        ++visited;
+    }
+}
+
+HOST_BENCH(bitmap_walk_set_bits_1m_bit_by_bit) {
+    u64   visited = 0;
+    usize i       = 0;
+    while (visited < iters) {
+        if (s_maps.sparse.test(i)) {
+            hostbench::doNotOptimize(i);
+            ++visited;
+        }
+        i = i + 1 == kBits ? 0 : i + 1;
+    }
+}
+
+// ns/op is per 64-bit word.
+HOST_BENCH(bitmap_count_popcnt) { countBits(iters, true); }
+HOST_BENCH(bitmap_count_swar)   { countBits(iters, false); }
+
+// An 8-bit run from a random start in the fragmented map.
+HOST_BENCH(bitmap_find_clear_run_8) {
+    u64   seed  = 0x2545f4914f6cdd1dULL;
+    usize found = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        found += s_maps.fragmented.find_clear_run(8, xorshift(seed) % kBits);
+    }
+    hostbench::doNotOptimize(found);
+}
+
+// Claim and release one bit of a nearly full map, as a vector or ID
+// allocator would.
+HOST_BENCH(bitmap_atomic_find_and_set) {
+    static u64 words[16];
+    ktl::bitmap ids(words, 1024);
+    ids.set_all();
+    ids.reset(1000);
+    for (u64 i = 0; i < iters; ++i) {
+        const usize id = ids.atomic_find_and_set();
+        ids.atomic_reset(id);
+    }
+}
@@ -0,0 +1,30 @@
+#include <core/format.hh>
+
+#include "bench.hh"
+
+using Out = FmtBase<SerialCOM2>;
+
+HOST_BENCH(fmt_print_literal) {
+    for (u64 i = 0; i < iters; ++i) {
+        Out::print("GDT: setting TSS.rsp0\n");
+    }
+}
+
+HOST_BENCH(fmt_printf_dec) {
+    for (u64 i = 0; i < iters; ++i) {
+        Out::printf("PMM debug: Memory map contains {} entries\n", i);
+    }
+}
+
+HOST_BENCH(fmt_printf_hex) {
+    for (u64 i = 0; i < iters; ++i) {
+        Out::printf("Loading IDT @ {:#016x}, limit={} bytes\n", i * 0x1000, 4095);
+    }
+}
+
+HOST_BENCH(fmt_printf_mixed) {
+    const ktl::string_view name = "COM2";
+    for (u64 i = 0; i < iters; ++i) {
+        Out::printf("{} entry {}: base={:#x} type={} ok={}\n", name, i, i << 12, 7, true);
+    }
+}
@@ -0,0 +1,59 @@
+#include <ktl/function>
+
+#include "bench.hh"
+
+// Call cost of the type-erased callables against a plain function pointer,
+// which is what they replace for interrupt handlers. Each keeps the target
+// opaque to the optimizer so the indirect call is what gets measured.
+
+namespace {
+
+struct Counter {
+    u64 value = 0;
+};
+
+[[gnu::noinline]] void bump(Counter* c) { ++c->value; }
+
+} // namespace
+
+HOST_BENCH(function_call_pointer) {
+    Counter c;
+    void (*fn)(Counter*) = bump;
+    for (u64 i = 0; i < iters; ++i) {
+        hostbench::doNotOptimize(fn);
+        fn(&c);
+    }
+    hostbench::doNotOptimize(c.value);
+}
+
+HOST_BENCH(function_call_inplace) {
+    Counter c;
+    ktl::inplace_function<void()> fn = [&c] { ++c.value; };
+    for (u64 i = 0; i < iters; ++i) {
+        hostbench::doNotOptimize(fn);
+        fn();
+    }
+    hostbench::doNotOptimize(c.value);
+}
+
+HOST_BENCH(function_call_ref) {
+    Counter c;
+    auto lambda = [&c] { ++c.value; };
+    ktl::function_ref<void()> fn = lambda;
+    for (u64 i = 0; i < iters; ++i) {
+        hostbench::doNotOptimize(fn);
+        fn();
+    }
+    hostbench::doNotOptimize(c.value);
+}
+
+// Copying is what the IDT does to every handler on each table update.
+HOST_BENCH(function_copy_inplace) {
+    Counter c;
+    ktl::inplace_function<void()> a = [&c] { ++c.value; };
+    ktl::inplace_function<void()> b;
+    for (u64 i = 0; i < iters; ++i) {
+        b = a;
+        hostbench::doNotOptimize(b);
+    }
+}
@@ -0,0 +1,167 @@
+#include <ktl/flat_hash_map>
+#include <ktl/list>
+#include <stdlib.h>
+
+#include "bench.hh"
+
+// flat_hash_map against a chained table of the kind the kernel would write
+// by hand: a power-of-two array of intrusive hlist buckets, one bucket per
+// entry, nodes from a preallocated pool. Both hold kEntries u64 -> u64
+// entries; ns/op is per operation.
+
+namespace {
+
+constexpr u64 kEntries = 1 << 16;
+
+struct HeapAllocator {
+    void* allocate(usize bytes, usize) noexcept { return malloc(bytes); }
+    void  deallocate(void* ptr, usize, usize) noexcept { free(ptr); }
+};
+
+class ChainedMap {
+public:
+    explicit ChainedMap(u64 buckets)
+        : m_buckets(static_cast<Bucket*>(calloc(buckets, sizeof(Bucket)))),
+          m_nodes(static_cast<Node*>(calloc(buckets, sizeof(Node)))),
+          m_mask(buckets - 1) {}
+
+    ~ChainedMap() {
+        free(m_buckets);
+        free(m_nodes);
+    }
+
+    bool insert(u64 key, u64 value) {
+        Bucket& b = bucket(key);
+        for (Node& n : b) {
+            if (n.key == key) {
+                return false;
+            }
+        }
+        Node* n = m_free;
+        if (n) {
+            m_free = n->next_free;
+        } else {
+            n = &m_nodes[m_used++];
+        }
+        n->key   = key;
+        n->value = value;
+        b.push_front(*n);
+        return true;
+    }
+
+    u64* find(u64 key) {
+        for (Node& n : bucket(key)) {
+            if (n.key == key) {
+                return &n.value;
+            }
+        }
+        return nullptr;
+    }
+
+    bool erase(u64 key) {
+        for (Node& n : bucket(key)) {
+            if (n.key == key) {
+                Bucket::remove(n);
+                n.next_free = m_free;
+                m_free = &n;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Node {
+        u64             key;
+        u64             value;
+        ktl::hlist_node link;
+        Node*           next_free;
+    };
+    using Bucket = ktl::intrusive_hlist<Node, &Node::link>;
+
+    Bucket& bucket(u64 key) { return m_buckets[ktl::hash_mix(key) & m_mask]; }
+
+    Bucket* m_buckets;
+    Node*   m_nodes;
+    Node*   m_free = nullptr;
+    u64     m_used = 0;
+    u64     m_mask;
+};
+
+using FlatMap = ktl::flat_hash_map<u64, u64, HeapAllocator>;
+
+// Distinct, scattered keys; key(i + kEntries) is never inserted.
+u64 key(u64 i) { return ktl::hash_mix(i + 1) | 1; }
+
+template<typename Map>
+void fill(Map& m) {
+    for (u64 i = 0; i < kEntries; ++i) {
+        m.insert(key(i), i);
+    }
+}
+
+// Prefilled at startup so the first, calibrating run of a lookup bench
+// does not pay for it.
+struct Filled {
+    FlatMap    flat;
+    ChainedMap chained { kEntries };
+
+    Filled() {
+        flat.reserve(kEntries);
+        fill(flat);
+        fill(chained);
+    }
+};
+
+Filled s_filled;
+
+// Inserts `iters` entries in total, starting a fresh table every kEntries.
+template<typename Map, typename Make>
+void insert(u64 iters, Make make) {
+    for (u64 done = 0; done < iters; ) {
+        Map m = make();
+        for (u64 i = 0; i < kEntries && done < iters; ++i, ++done) {
+            m.insert(key(i), i);
+        }
+        hostbench::doNotOptimize(m);
+    }
+}
+
+template<typename Map>
+void lookup(Map& m, u64 iters, u64 offset) {
+    u64 sum = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        const u64* v = m.find(key((i & (kEntries - 1)) + offset));
+        sum += v ? *v : 1;
+    }
+    hostbench::doNotOptimize(sum);
+}
+
+// Erases and reinserts existing keys: steady-state churn.
+template<typename Map>
+void churn(Map& m, u64 iters) {
+    for (u64 i = 0; i < iters; ++i) {
+        const u64 k = key(i & (kEntries - 1));
+        m.erase(k);
+        m.insert(k, i);
+    }
+}
+
+} // namespace
+
+HOST_BENCH(hash_insert_flat) {
+    insert<FlatMap>(iters, [] { FlatMap m; m.reserve(kEntries); return m; });
+}
+HOST_BENCH(hash_insert_flat_grow) {
+    insert<FlatMap>(iters, [] { return FlatMap(); });
+}
+HOST_BENCH(hash_insert_chained) {
+    insert<ChainedMap>(iters, [] { return ChainedMap(kEntries); });
+}
+
+HOST_BENCH(hash_lookup_hit_flat)      { lookup(s_filled.flat, iters, 0); }
+HOST_BENCH(hash_lookup_hit_chained)   { lookup(s_filled.chained, iters, 0); }
+HOST_BENCH(hash_lookup_miss_flat)     { lookup(s_filled.flat, iters, kEntries); }
+HOST_BENCH(hash_lookup_miss_chained)  { lookup(s_filled.chained, iters, kEntries); }
+HOST_BENCH(hash_erase_insert_flat)    { churn(s_filled.flat, iters); }
+HOST_BENCH(hash_erase_insert_chained) { churn(s_filled.chained, iters); }
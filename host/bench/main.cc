@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+
+#include "bench.hh"
+
+// Each benchmark is first scaled until one run takes at least kTargetNs,
+// then run kRuns times. The median is reported as the headline number and
+// the minimum next to it; pinning to one CPU keeps both stable.
+
+static constexpr u64 kTargetNs = 20'000'000;
+static constexpr int kRuns     = 7;
+
+static u64 nowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<u64>(ts.tv_sec) * 1'000'000'000ULL + static_cast<u64>(ts.tv_nsec);
+}
+
+static u64 timeRun(const hostbench::Benchmark& b, u64 iters) {
+    const u64 start = nowNs();
+    b.fn(iters);
+    return nowNs() - start;
+}
+
+static void sortRuns(double* v, int n) {
+    for (int i = 1; i < n; ++i) {
+        double x = v[i];
+        int j = i;
+        for (; j > 0 && v[j - 1] > x; --j) {
+            v[j] = v[j - 1];
+        }
+        v[j] = x;
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(0, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        fprintf(stderr, "warning: could not pin to CPU 0, numbers may be noisy\n");
+    }
+
+    printf("%-40s %12s %12s %12s\n", "benchmark", "ns/op", "min ns/op", "iters");
+    for (auto* b = hostbench::g_head; b; b = b->next) {
+        if (filter && !strstr(b->name, filter)) {
+            continue;
+        }
+
+        hostbench::g_counter_name = nullptr;
+        hostbench::g_skip_reason  = nullptr;
+
+        u64 iters = 1;
+        while (timeRun(*b, iters) < kTargetNs / 8 && iters < (1ULL << 40)) {
+            if (hostbench::g_skip_reason) {
+                break;
+            }
+            iters *= 2;
+        }
+        if (hostbench::g_skip_reason) {
+            printf("%-40s skipped: %s\n", b->name, hostbench::g_skip_reason);
+            continue;
+        }
+        iters *= 8;
+
+        double runs[kRuns];
+        for (int i = 0; i < kRuns; ++i) {
+            runs[i] = static_cast<double>(timeRun(*b, iters)) / static_cast<double>(iters);
+        }
+        sortRuns(runs, kRuns);
+
+        printf("%-40s %12.3f %12.3f %12llu",
+               b->name, runs[kRuns / 2], runs[0],
+               static_cast<unsigned long long>(iters));
+        if (hostbench::g_counter_name) {
+            printf("  %s=%llu", hostbench::g_counter_name,
+                   static_cast<unsigned long long>(hostbench::g_counter_value));
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,265 @@
+#include <ktl/ring>
+#include <ktl/spinlock>
+
+#include "bench.hh"
+
+// Throughput and latency of the ktl queues against a SpinLock-protected
+// ring, the only option before them.
+//
+// Throughput: P producers push `iters` items in total while C consumers pop
+// them; ns/op is wall time per item. The _b16 variants move items in
+// batches of 16. Latency: two threads bounce one item through a pair of
+// queues; ns/op is one round trip.
+//
+// The work-stealing deque is measured the way a worker uses it: its owner
+// pushing and popping alone, and its owner pushing `iters` items (popping
+// for itself whenever the deque is full) while thieves steal. ns/op is per
+// item; stolen_pct says how much the thieves got.
+
+namespace {
+
+constexpr usize kCapacity = 1024;
+constexpr usize kBatch    = 16;
+
+// Baseline: a plain ring behind a SpinLock.
+template<typename T, usize N>
+class LockedRing {
+public:
+    bool try_push(const T& value) { return push_bulk(&value, 1) == 1; }
+    bool try_pop(T& out)          { return pop_bulk(&out, 1) == 1; }
+
+    usize push_bulk(const T* values, usize count) {
+        ktl::AutoLock<ktl::SpinLock> guard(_lock);
+        if (count > N - (_tail - _head)) {
+            count = N - (_tail - _head);
+        }
+        for (usize i = 0; i < count; ++i) {
+            _slots[(_tail + i) % N] = values[i];
+        }
+        _tail += count;
+        return count;
+    }
+
+    usize pop_bulk(T* out, usize count) {
+        ktl::AutoLock<ktl::SpinLock> guard(_lock);
+        if (count > _tail - _head) {
+            count = _tail - _head;
+        }
+        for (usize i = 0; i < count; ++i) {
+            out[i] = _slots[(_head + i) % N];
+        }
+        _head += count;
+        return count;
+    }
+
+private:
+    ktl::SpinLock _lock;
+    usize         _head = 0;
+    usize         _tail = 0;
+    T             _slots[N] {};
+};
+
+template<typename Queue>
+struct Transfer {
+    Queue queue;
+    int   producers = 0;
+    usize batch = 1;
+    u64   per_producer = 0;
+    u64   total = 0;
+    alignas(64) u64 consumed = 0;
+
+    static void run(int index, void* ctx) {
+        auto* t = static_cast<Transfer*>(ctx);
+        u64 items[kBatch];
+
+        if (index < t->producers) {
+            for (u64 i = 0; i < kBatch; ++i) {
+                items[i] = i;
+            }
+            for (u64 sent = 0; sent < t->per_producer; ) {
+                u64 want = t->per_producer - sent;
+                if (want > t->batch) want = t->batch;
+                const usize n = t->queue.push_bulk(items, want);
+                if (n == 0) {
+                    __builtin_ia32_pause();
+                }
+                sent += n;
+            }
+            return;
+        }
+
+        u64 sum = 0;
+        while (__atomic_load_n(&t->consumed, __ATOMIC_RELAXED) < t->total) {
+            const usize n = t->queue.pop_bulk(items, t->batch);
+            if (n == 0) {
+                __builtin_ia32_pause();
+                continue;
+            }
+            for (usize i = 0; i < n; ++i) {
+                sum += items[i];
+            }
+            __atomic_add_fetch(&t->consumed, n, __ATOMIC_RELAXED);
+        }
+        hostbench::doNotOptimize(sum);
+    }
+};
+
+template<typename Queue, int Producers, int Consumers, usize Batch = 1>
+void transfer(u64 iters) {
+    if (hostbench::cpuCount() < Producers + Consumers) {
+        hostbench::skip("not enough CPUs");
+        return;
+    }
+
+    static Transfer<Queue> t;
+    t.consumed     = 0;
+    t.producers    = Producers;
+    t.batch        = Batch;
+    t.per_producer = iters / Producers + 1;
+    t.total        = t.per_producer * Producers;
+    hostbench::runThreads(Producers + Consumers, Transfer<Queue>::run, &t);
+}
+
+template<typename Queue>
+struct PingPong {
+    Queue ping;
+    Queue pong;
+    u64   rounds = 0;
+
+    static void run(int index, void* ctx) {
+        auto* p = static_cast<PingPong*>(ctx);
+        Queue& in  = index == 0 ? p->pong : p->ping;
+        Queue& out = index == 0 ? p->ping : p->pong;
+
+        u64 value = 0;
+        for (u64 i = 0; i < p->rounds; ++i) {
+            if (index == 0) {
+                while (!out.try_push(i)) {}
+                while (!in.try_pop(value)) __builtin_ia32_pause();
+            } else {
+                while (!in.try_pop(value)) __builtin_ia32_pause();
+                while (!out.try_push(value)) {}
+            }
+        }
+        hostbench::doNotOptimize(value);
+    }
+};
+
+template<typename Queue>
+void roundTrip(u64 iters) {
+    if (hostbench::cpuCount() < 2) {
+        hostbench::skip("not enough CPUs");
+        return;
+    }
+
+    static PingPong<Queue> p;
+    p.rounds = iters;
+    hostbench::runThreads(2, PingPong<Queue>::run, &p);
+}
+
+struct Stealing {
+    ktl::ws_deque<u64, kCapacity> deque;
+    u64 total = 0;
+    alignas(64) u64 consumed = 0;
+    alignas(64) u64 stolen   = 0;
+    alignas(64) u64 sum      = 0;
+
+    static void run(int index, void* ctx) {
+        auto* s = static_cast<Stealing*>(ctx);
+        u64 sum   = 0;
+        u64 taken = 0;
+        u64 value;
+
+        if (index == 0) {
+            for (u64 i = 0; i < s->total; ++i) {
+                while (!s->deque.try_push(i)) {
+                    if (s->deque.try_pop(value)) {
+                        sum += value;
+                        ++taken;
+                    }
+                }
+            }
+            while (s->deque.try_pop(value)) {
+                sum += value;
+                ++taken;
+            }
+        }
+        while (__atomic_load_n(&s->consumed, __ATOMIC_RELAXED) + taken < s->total) {
+            if (index == 0) {
+                __builtin_ia32_pause();
+            } else if (s->deque.try_steal(value)) {
+                sum += value;
+                __atomic_add_fetch(&s->consumed, 1, __ATOMIC_RELAXED);
+                __atomic_add_fetch(&s->stolen, 1, __ATOMIC_RELAXED);
+            }
+        }
+        if (index == 0) {
+            __atomic_add_fetch(&s->consumed, taken, __ATOMIC_RELAXED);
+        }
+        __atomic_add_fetch(&s->sum, sum, __ATOMIC_RELAXED);
+    }
+};
+
+template<int Thieves>
+void stealing(u64 iters) {
+    if (hostbench::cpuCount() < 1 + Thieves) {
+        hostbench::skip("not enough CPUs");
+        return;
+    }
+
+    static Stealing s;
+    s.total    = iters;
+    s.consumed = 0;
+    s.stolen   = 0;
+    s.sum      = 0;
+    hostbench::runThreads(1 + Thieves, Stealing::run, &s);
+    if (s.sum != iters * (iters - 1) / 2) {
+        hostbench::skip("ws_deque lost or duplicated items");
+        return;
+    }
+    hostbench::counter("stolen_pct", s.stolen * 100 / iters);
+}
+
+template<typename Queue>
+void singleThread(u64 iters) {
+    static Queue q;
+    u64 value = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        q.try_push(i);
+        q.try_pop(value);
+    }
+    hostbench::doNotOptimize(value);
+}
+
+using Spsc   = ktl::spsc_ring<u64, kCapacity>;
+using Mpmc   = ktl::mpmc_queue<u64, kCapacity>;
+using Locked = LockedRing<u64, kCapacity>;
+using Deque  = ktl::ws_deque<u64, kCapacity>;
+
+} // namespace
+
+HOST_BENCH(ring_push_pop_spsc)   { singleThread<Spsc>(iters); }
+HOST_BENCH(ring_push_pop_mpmc)   { singleThread<Mpmc>(iters); }
+HOST_BENCH(ring_push_pop_locked) { singleThread<Locked>(iters); }
+HOST_BENCH(ring_push_pop_ws_deque) { singleThread<Deque>(iters); }
+
+HOST_BENCH(ring_latency_spsc)   { roundTrip<Spsc>(iters); }
+HOST_BENCH(ring_latency_mpmc)   { roundTrip<Mpmc>(iters); }
+HOST_BENCH(ring_latency_locked) { roundTrip<Locked>(iters); }
+
+HOST_BENCH(ring_spsc_1p1c)         { transfer<Spsc, 1, 1>(iters); }
+HOST_BENCH(ring_spsc_1p1c_b16)     { transfer<Spsc, 1, 1, kBatch>(iters); }
+HOST_BENCH(ring_mpmc_1p1c)         { transfer<Mpmc, 1, 1>(iters); }
+HOST_BENCH(ring_mpmc_1p1c_b16)     { transfer<Mpmc, 1, 1, kBatch>(iters); }
+HOST_BENCH(ring_mpmc_2p2c)         { transfer<Mpmc, 2, 2>(iters); }
+HOST_BENCH(ring_mpmc_2p2c_b16)     { transfer<Mpmc, 2, 2, kBatch>(iters); }
+HOST_BENCH(ring_mpmc_4p4c)         { transfer<Mpmc, 4, 4>(iters); }
+HOST_BENCH(ring_mpmc_4p4c_b16)     { transfer<Mpmc, 4, 4, kBatch>(iters); }
+HOST_BENCH(ring_mpmc_7p1c)         { transfer<Mpmc, 7, 1>(iters); }
+HOST_BENCH(ring_locked_1p1c)       { transfer<Locked, 1, 1>(iters); }
+HOST_BENCH(ring_locked_2p2c)       { transfer<Locked, 2, 2>(iters); }
+HOST_BENCH(ring_locked_4p4c)       { transfer<Locked, 4, 4>(iters); }
+HOST_BENCH(ring_locked_4p4c_b16)   { transfer<Locked, 4, 4, kBatch>(iters); }
+
+HOST_BENCH(ring_ws_deque_1o1t) { stealing<1>(iters); }
+HOST_BENCH(ring_ws_deque_1o3t) { stealing<3>(iters); }
@@ -0,0 +1,104 @@
+#include <ktl/seqlock>
+#include <ktl/spinlock>
+
+#include "bench.hh"
+
+// Read-side scalability of the read-mostly primitives: every thread reads a
+// small record `iters / threads` times with no writers. ns/op is wall time
+// per read across all threads, so a primitive that scales keeps it falling
+// as threads are added, while one that bounces a line between readers
+// (SpinLock, and the reader count of rw_spinlock) does not.
+
+namespace {
+
+struct Record {
+    u64 a, b, c, d;
+};
+
+struct SpinLocked {
+    ktl::SpinLock lock;
+    Record        value {};
+
+    Record read() {
+        ktl::AutoLock<ktl::SpinLock> guard(lock);
+        return value;
+    }
+};
+
+struct RwLocked {
+    ktl::rw_spinlock lock;
+    Record           value {};
+
+    Record read() {
+        ktl::SharedAutoLock<ktl::rw_spinlock> guard(lock);
+        return value;
+    }
+};
+
+struct SeqLocked {
+    ktl::seqlocked<Record> value;
+
+    Record read() {
+        return value.load();
+    }
+};
+
+template<typename Shared>
+struct Readers {
+    alignas(64) Shared shared;
+    u64 per_thread = 0;
+
+    static void run(int, void* ctx) {
+        auto* r = static_cast<Readers*>(ctx);
+        u64 sum = 0;
+        for (u64 i = 0; i < r->per_thread; ++i) {
+            sum += r->shared.read().a;
+        }
+        hostbench::doNotOptimize(sum);
+    }
+};
+
+template<typename Shared, int Threads>
+void readers(u64 iters) {
+    if (hostbench::cpuCount() < Threads) {
+        hostbench::skip("not enough CPUs");
+        return;
+    }
+
+    Readers<Shared> r;
+    r.per_thread = iters / Threads + 1;
+    hostbench::runThreads(Threads, Readers<Shared>::run, &r);
+}
+
+} // namespace
+
+HOST_BENCH(rwlock_read_spinlock_1t) { readers<SpinLocked, 1>(iters); }
+HOST_BENCH(rwlock_read_spinlock_2t) { readers<SpinLocked, 2>(iters); }
+HOST_BENCH(rwlock_read_spinlock_4t) { readers<SpinLocked, 4>(iters); }
+HOST_BENCH(rwlock_read_spinlock_8t) { readers<SpinLocked, 8>(iters); }
+HOST_BENCH(rwlock_read_rwlock_1t)   { readers<RwLocked, 1>(iters); }
+HOST_BENCH(rwlock_read_rwlock_2t)   { readers<RwLocked, 2>(iters); }
+HOST_BENCH(rwlock_read_rwlock_4t)   { readers<RwLocked, 4>(iters); }
+HOST_BENCH(rwlock_read_rwlock_8t)   { readers<RwLocked, 8>(iters); }
+HOST_BENCH(rwlock_read_seqlock_1t)  { readers<SeqLocked, 1>(iters); }
+HOST_BENCH(rwlock_read_seqlock_2t)  { readers<SeqLocked, 2>(iters); }
+HOST_BENCH(rwlock_read_seqlock_4t)  { readers<SeqLocked, 4>(iters); }
+HOST_BENCH(rwlock_read_seqlock_8t)  { readers<SeqLocked, 8>(iters); }
+
+HOST_BENCH(rwlock_write_rwlock) {
+    ktl::rw_spinlock lock;
+    u64 value = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::AutoLock<ktl::rw_spinlock> guard(lock);
+        ++value;
+    }
+    hostbench::doNotOptimize(value);
+}
+
+HOST_BENCH(rwlock_write_seqlock) {
+    ktl::seqlocked<Record> value;
+    for (u64 i = 0; i < iters; ++i) {
+        value.store(Record { i, i, i, i });
+    }
+    hostbench::doNotOptimize(value);
+}
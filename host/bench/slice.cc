@@ -0,0 +1,35 @@
+#include <ktl/slice>
+
+#include "bench.hh"
+
+static u64 s_values[1024];
+
+HOST_BENCH(slice_iterate_1024) {
+    ktl::slice<u64> s(s_values);
+    for (u64 i = 0; i < iters; ++i) {
+        u64 sum = 0;
+        for (u64 v : s) {
+            sum += v;
+        }
+        hostbench::doNotOptimize(sum);
+        hostbench::clobberMemory();
+    }
+}
+
+HOST_BENCH(slice_subslice) {
+    ktl::slice<u64> s(s_values);
+    for (u64 i = 0; i < iters; ++i) {
+        auto sub = s.subslice(i & 511, 256);
+        hostbench::doNotOptimize(sub);
+    }
+}
+
+HOST_BENCH(slice_equal_1024) {
+    static u64 other[1024];
+    ktl::slice<u64> a(s_values);
+    ktl::slice<u64> b(other);
+    for (u64 i = 0; i < iters; ++i) {
+        hostbench::doNotOptimize(a == b);
+        hostbench::clobberMemory();
+    }
+}
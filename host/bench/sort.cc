@@ -0,0 +1,128 @@
+#include <ktl/algorythm>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.hh"
+
+// ktl sorting against libc qsort (a comparison through a function pointer
+// per step), and the two binary searches on a small and a large table.
+// Sort benches report ns per sort of the whole array; each sorts a fresh
+// copy of the same random input.
+
+namespace {
+
+constexpr usize kSmall = 1024;
+constexpr usize kLarge = 64 * 1024;
+
+u64 xorshift(u64& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+struct Input {
+    u64 random[kLarge];
+    u64 sorted[kLarge];
+
+    Input() {
+        u64 seed = 0x9e3779b97f4a7c15ULL;
+        for (usize i = 0; i < kLarge; ++i) {
+            random[i] = xorshift(seed);
+            sorted[i] = i * 3;
+        }
+    }
+};
+
+Input s_input;
+u64   s_work[kLarge];
+
+int compareU64(const void* a, const void* b) {
+    const u64 x = *static_cast<const u64*>(a);
+    const u64 y = *static_cast<const u64*>(b);
+    return (x > y) - (x < y);
+}
+
+template<typename Sort>
+void sortBench(u64 iters, usize n, Sort&& sort) {
+    for (u64 i = 0; i < iters; ++i) {
+        memcpy(s_work, s_input.random, n * sizeof(u64));
+        sort(s_work, s_work + n);
+        hostbench::doNotOptimize(s_work[0]);
+    }
+}
+
+template<typename Search>
+void searchBench(u64 iters, usize n, Search&& search) {
+    u64 seed = 0x2545f4914f6cdd1dULL;
+    u64 sum  = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        const u64 key = xorshift(seed) % (3 * n);
+        sum += static_cast<u64>(search(s_input.sorted, s_input.sorted + n, key) - s_input.sorted);
+    }
+    hostbench::doNotOptimize(sum);
+}
+
+} // namespace
+
+HOST_BENCH(sort_1k_ktl) {
+    sortBench(iters, kSmall, [](u64* first, u64* last) { ktl::sort(first, last); });
+}
+
+HOST_BENCH(sort_1k_qsort) {
+    sortBench(iters, kSmall, [](u64* first, u64* last) { qsort(first, last - first, sizeof(u64), compareU64); });
+}
+
+HOST_BENCH(sort_64k_ktl) {
+    sortBench(iters, kLarge, [](u64* first, u64* last) { ktl::sort(first, last); });
+}
+
+HOST_BENCH(sort_64k_qsort) {
+    sortBench(iters, kLarge, [](u64* first, u64* last) { qsort(first, last - first, sizeof(u64), compareU64); });
+}
+
+HOST_BENCH(sort_64k_stable) {
+    sortBench(iters, kLarge, [](u64* first, u64* last) { ktl::stable_sort(first, last); });
+}
+
+HOST_BENCH(sort_64k_heap) {
+    sortBench(iters, kLarge, [](u64* first, u64* last) {
+        ktl::make_heap(first, last);
+        ktl::sort_heap(first, last);
+    });
+}
+
+HOST_BENCH(sort_64k_nth_element_median) {
+    sortBench(iters, kLarge, [](u64* first, u64* last) { ktl::nth_element(first, first + (last - first) / 2, last); });
+}
+
+// A timer queue: pop the earliest deadline, push a later one. ns/op is
+// per pop + push on a 1024-entry min-heap.
+HOST_BENCH(sort_heap_timer_queue_1k) {
+    auto later = [](u64 a, u64 b) { return a > b; };
+    memcpy(s_work, s_input.random, kSmall * sizeof(u64));
+    ktl::make_heap(s_work, s_work + kSmall, later);
+    u64 seed = 0x853c49e6748fea9bULL;
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::pop_heap(s_work, s_work + kSmall, later);
+        s_work[kSmall - 1] += xorshift(seed) >> 40;
+        ktl::push_heap(s_work, s_work + kSmall, later);
+    }
+    hostbench::doNotOptimize(s_work[0]);
+}
+
+HOST_BENCH(search_32_lower_bound) {
+    searchBench(iters, 32, [](const u64* f, const u64* l, u64 k) { return ktl::lower_bound(f, l, k); });
+}
+
+HOST_BENCH(search_32_branchless) {
+    searchBench(iters, 32, [](const u64* f, const u64* l, u64 k) { return ktl::branchless_lower_bound(f, l, k); });
+}
+
+HOST_BENCH(search_64k_lower_bound) {
+    searchBench(iters, kLarge, [](const u64* f, const u64* l, u64 k) { return ktl::lower_bound(f, l, k); });
+}
+
+HOST_BENCH(search_64k_branchless) {
+    searchBench(iters, kLarge, [](const u64* f, const u64* l, u64 k) { return ktl::branchless_lower_bound(f, l, k); });
+}
@@ -0,0 +1,120 @@
+#include <ktl/spinlock>
+
+#include "bench.hh"
+
+namespace {
+
+// The test-and-set lock ktl::SpinLock used to be, kept as the baseline.
+class TasLock {
+    alignas(1) volatile uint8_t _flag = 0;
+
+public:
+    void lock() noexcept {
+        uint8_t tmp = 1;
+        for (;;) {
+            asm volatile ("lock xchg %0, %1"
+                        : "+r"(tmp), "+m"(_flag)
+                        :
+                        : "memory");
+            if (tmp == 0)
+                return;
+            tmp = 1;
+        }
+    }
+
+    void unlock() noexcept {
+        asm volatile ("" ::: "memory");
+        _flag = 0;
+        asm volatile ("" ::: "memory");
+    }
+};
+
+template<typename Lock>
+void uncontended(u64 iters) {
+    Lock lock;
+    u64 counter = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::AutoLock<Lock> guard(lock);
+        ++counter;
+    }
+    hostbench::doNotOptimize(counter);
+}
+
+// Threads race to take the lock until `iters` critical sections have run
+// in total. ns/op is wall time per critical section; fairness is the
+// fewest acquisitions any thread got as a percentage of the most (100 =
+// perfectly even).
+template<typename Lock>
+struct Contention {
+    static constexpr int kMaxThreads = 8;
+
+    Lock lock;
+    u64  done = 0;
+    u64  total = 0;
+    u64  acquired[kMaxThreads] = {};
+
+    static void run(int index, void* ctx) {
+        auto* c = static_cast<Contention*>(ctx);
+        u64 mine = 0;
+        for (;;) {
+            ktl::AutoLock<Lock> guard(c->lock);
+            if (c->done == c->total) {
+                break;
+            }
+            c->done = c->done + 1;
+            hostbench::clobberMemory();
+            ++mine;
+        }
+        c->acquired[index] = mine;
+    }
+};
+
+template<typename Lock, int Threads>
+void contended(u64 iters) {
+    static_assert(Threads <= Contention<Lock>::kMaxThreads);
+
+    if (hostbench::cpuCount() < Threads) {
+        hostbench::skip("not enough CPUs");
+        return;
+    }
+
+    Contention<Lock> c;
+    c.total = iters;
+    hostbench::runThreads(Threads, Contention<Lock>::run, &c);
+
+    u64 least = c.acquired[0];
+    u64 most  = c.acquired[0];
+    for (int i = 1; i < Threads; ++i) {
+        if (c.acquired[i] < least) least = c.acquired[i];
+        if (c.acquired[i] > most)  most  = c.acquired[i];
+    }
+    hostbench::counter("fairness%", most ? least * 100 / most : 100);
+}
+
+} // namespace
+
+HOST_BENCH(spinlock_tas_uncontended)    { uncontended<TasLock>(iters); }
+HOST_BENCH(spinlock_ticket_uncontended) { uncontended<ktl::TicketLock>(iters); }
+HOST_BENCH(spinlock_mcs_uncontended)    { uncontended<ktl::McsLock>(iters); }
+
+HOST_BENCH(spinlock_ticket_try_lock) {
+    ktl::TicketLock lock;
+    for (u64 i = 0; i < iters; ++i) {
+        if (lock.try_lock()) {
+            lock.unlock();
+        }
+    }
+}
+
+HOST_BENCH(spinlock_tas_1t)    { contended<TasLock, 1>(iters); }
+HOST_BENCH(spinlock_tas_2t)    { contended<TasLock, 2>(iters); }
+HOST_BENCH(spinlock_tas_4t)    { contended<TasLock, 4>(iters); }
+HOST_BENCH(spinlock_tas_8t)    { contended<TasLock, 8>(iters); }
+HOST_BENCH(spinlock_ticket_1t) { contended<ktl::TicketLock, 1>(iters); }
+HOST_BENCH(spinlock_ticket_2t) { contended<ktl::TicketLock, 2>(iters); }
+HOST_BENCH(spinlock_ticket_4t) { contended<ktl::TicketLock, 4>(iters); }
+HOST_BENCH(spinlock_ticket_8t) { contended<ktl::TicketLock, 8>(iters); }
+HOST_BENCH(spinlock_mcs_1t)    { contended<ktl::McsLock, 1>(iters); }
+HOST_BENCH(spinlock_mcs_2t)    { contended<ktl::McsLock, 2>(iters); }
+HOST_BENCH(spinlock_mcs_4t)    { contended<ktl::McsLock, 4>(iters); }
+HOST_BENCH(spinlock_mcs_8t)    { contended<ktl::McsLock, 8>(iters); }
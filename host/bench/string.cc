@@ -0,0 +1,70 @@
+#include <string.h>
+#include <kstring.h>
+
+#include "bench.hh"
+
+// Each kernel routine is paired with the host C library as a reference.
+
+alignas(4096) static char s_src[1 << 16];
+alignas(4096) static char s_dst[1 << 16];
+
+#define STRING_COPY_BENCH(_fn_, _size_)                                       \
+    HOST_BENCH(_fn_##_##_size_) {                                             \
+        for (u64 i = 0; i < iters; ++i) {                                     \
+            kstr_##_fn_(s_dst, s_src, _size_);                                \
+            hostbench::clobberMemory();                                       \
+        }                                                                     \
+    }                                                                         \
+    HOST_BENCH(libc_##_fn_##_##_size_) {                                      \
+        for (u64 i = 0; i < iters; ++i) {                                     \
+            _fn_(s_dst, s_src, _size_);                                       \
+            hostbench::clobberMemory();                                       \
+        }                                                                     \
+    }
+
+#define STRING_SET_BENCH(_size_)                                              \
+    HOST_BENCH(memset_##_size_) {                                             \
+        for (u64 i = 0; i < iters; ++i) {                                     \
+            kstr_memset(s_dst, static_cast<int>(i), _size_);                  \
+            hostbench::clobberMemory();                                       \
+        }                                                                     \
+    }                                                                         \
+    HOST_BENCH(libc_memset_##_size_) {                                        \
+        for (u64 i = 0; i < iters; ++i) {                                     \
+            memset(s_dst, static_cast<int>(i), _size_);                       \
+            hostbench::clobberMemory();                                       \
+        }                                                                     \
+    }
+
+#define STRING_SCAN_BENCH(_name_, _len_, _expr_)                              \
+    HOST_BENCH(_name_##_##_len_) {                                            \
+        memset(s_src, 'a', _len_);                                            \
+        s_src[_len_] = 0;                                                     \
+        memcpy(s_dst, s_src, _len_ + 1);                                      \
+        for (u64 i = 0; i < iters; ++i) {                                     \
+            hostbench::doNotOptimize(kstr_##_expr_);                          \
+            hostbench::clobberMemory();                                       \
+        }                                                                     \
+    }                                                                         \
+    HOST_BENCH(libc_##_name_##_##_len_) {                                     \
+        memset(s_src, 'a', _len_);                                            \
+        s_src[_len_] = 0;                                                     \
+        memcpy(s_dst, s_src, _len_ + 1);                                      \
+        for (u64 i = 0; i < iters; ++i) {                                     \
+            hostbench::doNotOptimize(_expr_);                                 \
+            hostbench::clobberMemory();                                       \
+        }                                                                     \
+    }
+
+STRING_COPY_BENCH(memcpy, 64)
+STRING_COPY_BENCH(memcpy, 4096)
+STRING_COPY_BENCH(memcpy, 65536)
+STRING_COPY_BENCH(memmove, 4096)
+STRING_SET_BENCH(64)
+STRING_SET_BENCH(4096)
+
+STRING_SCAN_BENCH(strlen, 16, strlen(s_src))
+STRING_SCAN_BENCH(strlen, 256, strlen(s_src))
+STRING_SCAN_BENCH(strchr, 256, strchr(s_src, 'z'))
+STRING_SCAN_BENCH(memchr, 256, memchr(s_src, 'z', 256))
+STRING_SCAN_BENCH(strcmp, 256, strcmp(s_src, s_dst))
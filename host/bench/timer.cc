@@ -0,0 +1,110 @@
+#include <ktl/rbtree>
+#include <ktl/timer_wheel>
+#include <stdlib.h>
+
+#include "bench.hh"
+
+// A million pending timeouts, as a busy network stack might keep: the
+// hierarchical timing wheel against a red-black tree keyed by deadline.
+// The arm/cancel benches cancel a random pending timer and arm it again
+// with a new deadline, so the set stays at 1M; ns/op is per cancel + arm.
+// Deadlines are 1 to 2^20 ticks out, spread over every wheel level.
+//
+// The advance benches move the clock one tick per iteration and re-arm
+// whatever expired, so ns/op includes expiry and, for the wheel, the
+// amortised cost of cascading. Both sets are built once at startup.
+
+namespace {
+
+constexpr u64 kTimers = 1 << 20;
+constexpr u64 kRange  = 1 << 20;
+
+struct Timeout {
+    u64             deadline;
+    ktl::wheel_node wheel_link;
+    ktl::rb_node    tree_link;
+};
+
+struct DeadlineKey {
+    static u64 key(const Timeout& t) { return t.deadline; }
+};
+
+u64 xorshift(u64& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+struct Sets {
+    Timeout*                                                      wheel_timers;
+    Timeout*                                                      tree_timers;
+    ktl::timer_wheel<Timeout, &Timeout::wheel_link>               wheel;
+    ktl::intrusive_rbtree<Timeout, &Timeout::tree_link, DeadlineKey> tree;
+    u64                                                           tree_now = 0;
+
+    Sets()
+        : wheel_timers(static_cast<Timeout*>(calloc(kTimers, sizeof(Timeout)))),
+          tree_timers(static_cast<Timeout*>(calloc(kTimers, sizeof(Timeout))))
+    {
+        u64 seed = 0x9e3779b97f4a7c15ULL;
+        for (u64 i = 0; i < kTimers; ++i) {
+            const u64 deadline = 1 + xorshift(seed) % kRange;
+            wheel.insert(wheel_timers[i], deadline);
+            tree_timers[i].deadline = deadline;
+            tree.insert(tree_timers[i]);
+        }
+    }
+};
+
+Sets s_sets;
+
+} // namespace
+
+HOST_BENCH(timer_wheel_arm_cancel_1m) {
+    u64 seed = 0x2545f4914f6cdd1dULL;
+    for (u64 i = 0; i < iters; ++i) {
+        Timeout& t = s_sets.wheel_timers[xorshift(seed) & (kTimers - 1)];
+        s_sets.wheel.erase(t);
+        s_sets.wheel.insert(t, s_sets.wheel.now() + 1 + xorshift(seed) % kRange);
+    }
+    hostbench::doNotOptimize(s_sets.wheel.size());
+}
+
+HOST_BENCH(timer_rbtree_arm_cancel_1m) {
+    u64 seed = 0x2545f4914f6cdd1dULL;
+    for (u64 i = 0; i < iters; ++i) {
+        Timeout& t = s_sets.tree_timers[xorshift(seed) & (kTimers - 1)];
+        s_sets.tree.erase(t);
+        t.deadline = s_sets.tree_now + 1 + xorshift(seed) % kRange;
+        s_sets.tree.insert(t);
+    }
+    hostbench::doNotOptimize(s_sets.tree.size());
+}
+
+HOST_BENCH(timer_wheel_advance_1m) {
+    u64 seed = 0x853c49e6748fea9bULL;
+    for (u64 i = 0; i < iters; ++i) {
+        const u64 now = s_sets.wheel.now() + 1;
+        while (Timeout* t = s_sets.wheel.pop_expired(now)) {
+            s_sets.wheel.insert(*t, now + 1 + xorshift(seed) % kRange);
+        }
+    }
+    hostbench::doNotOptimize(s_sets.wheel.size());
+}
+
+HOST_BENCH(timer_rbtree_advance_1m) {
+    u64 seed = 0x853c49e6748fea9bULL;
+    for (u64 i = 0; i < iters; ++i) {
+        const u64 now = ++s_sets.tree_now;
+        while (Timeout* t = s_sets.tree.first()) {
+            if (t->deadline > now) {
+                break;
+            }
+            s_sets.tree.erase(*t);
+            t->deadline = now + 1 + xorshift(seed) % kRange;
+            s_sets.tree.insert(*t);
+        }
+    }
+    hostbench::doNotOptimize(s_sets.tree.size());
+}
@@ -0,0 +1,172 @@
+#include <ktl/interval_tree>
+#include <ktl/radix_tree>
+#include <ktl/rbtree>
+#include <stdlib.h>
+
+#include "bench.hh"
+
+// Random lookups among 1M dense keys (page-cache style indices): the
+// red-black tree against the radix tree, with binary search over a sorted
+// array as the pointer-free baseline. Where the PMU is available each
+// lookup bench also reports cache misses per 1000 lookups; the structures
+// are built once at startup and are far larger than the caches.
+//
+// The interval benches model an address space of 64K mappings.
+
+namespace {
+
+constexpr u64 kKeys = 1 << 20;
+
+struct HeapAllocator {
+    void* allocate(usize bytes, usize align) noexcept { return aligned_alloc(align, (bytes + align - 1) & ~(align - 1)); }
+    void  deallocate(void* ptr, usize, usize) noexcept { free(ptr); }
+};
+
+struct Page {
+    u64           index;
+    ktl::rb_node  link;
+};
+
+struct PageKey {
+    static u64 key(const Page& p) { return p.index; }
+};
+
+u64 xorshift(u64& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+struct Index {
+    Page*                                           pages;
+    u64*                                            sorted;
+    ktl::intrusive_rbtree<Page, &Page::link, PageKey> rbtree;
+    ktl::radix_tree<Page, HeapAllocator>            radix;
+
+    Index()
+        : pages(static_cast<Page*>(calloc(kKeys, sizeof(Page)))),
+          sorted(static_cast<u64*>(calloc(kKeys, sizeof(u64))))
+    {
+        // Insert in a shuffled order so rbtree nodes are not laid out in
+        // key order.
+        u64* order = static_cast<u64*>(calloc(kKeys, sizeof(u64)));
+        for (u64 i = 0; i < kKeys; ++i) {
+            order[i] = i;
+        }
+        u64 seed = 0x9e3779b97f4a7c15ULL;
+        for (u64 i = kKeys - 1; i > 0; --i) {
+            const u64 j = xorshift(seed) % (i + 1);
+            const u64 t = order[i];
+            order[i] = order[j];
+            order[j] = t;
+        }
+        for (u64 i = 0; i < kKeys; ++i) {
+            Page& p = pages[i];
+            p.index = order[i];
+            rbtree.insert(p);
+            radix.store(p.index, &p);
+            sorted[i] = i;
+        }
+        free(order);
+    }
+};
+
+Index s_index;
+
+hostbench::CacheMisses s_misses;
+
+void reportMisses(u64 misses, u64 iters) {
+    if (s_misses.valid()) {
+        hostbench::counter("miss_per_1k", misses * 1000 / iters);
+    }
+}
+
+template<typename Lookup>
+void lookupBench(u64 iters, Lookup&& lookup) {
+    u64 seed  = 0x2545f4914f6cdd1dULL;
+    u64 found = 0;
+    s_misses.start();
+    for (u64 i = 0; i < iters; ++i) {
+        found += lookup(xorshift(seed) & (kKeys - 1));
+    }
+    const u64 misses = s_misses.stop();
+    hostbench::doNotOptimize(found);
+    reportMisses(misses, iters);
+}
+
+constexpr u64 kMappings = 1 << 16;
+constexpr u64 kPage     = 4096;
+
+struct Mapping {
+    ktl::interval_node range;
+};
+
+// Mappings of 1 to 16 pages separated by holes of 0 to 3 pages.
+struct AddressSpace {
+    Mapping*                                       mappings;
+    ktl::interval_tree<Mapping, &Mapping::range>  tree;
+    u64                                            top;
+
+    AddressSpace() : mappings(static_cast<Mapping*>(calloc(kMappings, sizeof(Mapping)))) {
+        u64 seed = 0xda942042e4dd58b5ULL;
+        u64 addr = kPage;
+        for (u64 i = 0; i < kMappings; ++i) {
+            const u64 r     = xorshift(seed);
+            const u64 pages = 1 + (r & 15);
+            tree.insert(mappings[i], addr, addr + pages * kPage);
+            addr += (pages + ((r >> 8) & 3)) * kPage;
+        }
+        top = addr;
+    }
+};
+
+AddressSpace s_space;
+
+} // namespace
+
+HOST_BENCH(tree_lookup_1m_rbtree) {
+    lookupBench(iters, [](u64 key) { return s_index.rbtree.find(key) != nullptr; });
+}
+
+HOST_BENCH(tree_lookup_1m_radix) {
+    lookupBench(iters, [](u64 key) { return s_index.radix.find(key) != nullptr; });
+}
+
+HOST_BENCH(tree_lookup_1m_sorted_array) {
+    lookupBench(iters, [](u64 key) {
+        u64 lo = 0;
+        u64 hi = kKeys;
+        while (lo < hi) {
+            const u64 mid = (lo + hi) / 2;
+            if (s_index.sorted[mid] < key) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo < kKeys && s_index.sorted[lo] == key;
+    });
+}
+
+HOST_BENCH(tree_interval_find_containing_64k) {
+    u64 seed  = 0x853c49e6748fea9bULL;
+    u64 found = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        found += s_space.tree.find_containing(xorshift(seed) % s_space.top) != nullptr;
+    }
+    hostbench::doNotOptimize(found);
+}
+
+// A 4-page hole aligned to 16K, searched from a random point: the gap
+// augment skips the subtrees whose holes are all smaller.
+HOST_BENCH(tree_interval_find_gap_64k) {
+    u64 seed  = 0x6a09e667f3bcc909ULL;
+    u64 found = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        const u64 lo  = xorshift(seed) % s_space.top;
+        const auto at = s_space.tree.find_gap(4 * kPage, 4 * kPage, lo, ~0ULL);
+        found += at.has_value() ? at.value() : 0;
+    }
+    hostbench::doNotOptimize(found);
+}
@@ -0,0 +1,76 @@
+#include <ktl/list>
+#include <ktl/vector>
+
+#include "bench.hh"
+
+// Container hot paths: appending to a vector (growing vs. reserved, arena
+// vs. inline), and the push/pop pattern of a run queue on an intrusive list
+// compared with a vector of pointers.
+
+namespace {
+
+constexpr u64 kElements = 64;
+
+ktl::inline_arena<64 * 1024> s_arena;
+
+void appendArena(u64 iters, bool reserve) {
+    for (u64 i = 0; i < iters; i += kElements) {
+        s_arena.reset();
+        ktl::vector<u64, ktl::arena_allocator> v { ktl::arena_allocator(s_arena) };
+        if (reserve) {
+            v.reserve(kElements);
+        }
+        for (u64 j = 0; j < kElements; ++j) {
+            v.push_back(j);
+        }
+        hostbench::doNotOptimize(v.data());
+    }
+}
+
+struct Task {
+    u64             id;
+    ktl::list_node  link;
+};
+
+Task s_tasks[kElements];
+
+} // namespace
+
+HOST_BENCH(vector_push_back_64_arena)          { appendArena(iters, false); }
+HOST_BENCH(vector_push_back_64_arena_reserved) { appendArena(iters, true); }
+
+HOST_BENCH(vector_push_back_64_small_inline) {
+    for (u64 i = 0; i < iters; i += kElements) {
+        ktl::small_vector<u64, kElements> v;
+        for (u64 j = 0; j < kElements; ++j) {
+            v.push_back(j);
+        }
+        hostbench::doNotOptimize(v.data());
+    }
+}
+
+HOST_BENCH(vector_run_queue_intrusive) {
+    ktl::intrusive_list<Task, &Task::link> queue;
+    for (Task& t : s_tasks) {
+        queue.push_back(t);
+    }
+    for (u64 i = 0; i < iters; ++i) {
+        Task* t = queue.pop_front();
+        queue.push_back(*t);
+    }
+    hostbench::doNotOptimize(queue.front().id);
+    queue.clear();
+}
+
+HOST_BENCH(vector_run_queue_vector) {
+    ktl::small_vector<Task*, kElements> queue;
+    for (Task& t : s_tasks) {
+        queue.push_back(&t);
+    }
+    for (u64 i = 0; i < iters; ++i) {
+        Task* t = queue.front();
+        queue.erase(queue.begin());
+        queue.push_back(t);
+    }
+    hostbench::doNotOptimize(queue.front());
+}
@@ -0,0 +1,72 @@
+#ifndef SERIAL_HH
+#define SERIAL_HH
+
+// Host stand-in for kernel/Source/arch/serial.hh. It is found first on the
+// include path, so FmtBase and anything else built on Serial compile
+// unchanged. Output goes into a buffer instead of an I/O port; echo() turns
+// on copying to stdout.
+
+#include <stdio.h>
+#include <ktl/string_view>
+
+template<
+    u16     PORT_BASE = 0x3F8,
+    u32     BAUD      = 115200,
+    u8      ILCR      = 0x03
+>
+class Serial {
+public:
+    static void init() {
+        s_len = 0;
+    }
+
+    [[nodiscard]] static bool tx_ready() { return true; }
+    [[nodiscard]] static bool rx_ready() { return false; }
+
+    static void put(char c) {
+        s_buffer[s_len++ & (kBufferSize - 1)] = c;
+        if (s_echo) {
+            fputc(c, stdout);
+        }
+    }
+
+    static char get() { return 0; }
+
+    static void flush() {
+        if (s_echo) {
+            fflush(stdout);
+        }
+    }
+
+    static void echo(bool on) { s_echo = on; }
+
+    static usize written() { return s_len; }
+
+    static ktl::string_view captured() {
+        return { s_buffer, s_len < kBufferSize ? s_len : kBufferSize };
+    }
+
+    static void reset() { s_len = 0; }
+
+    static constexpr ktl::string_view port_name() noexcept {
+        if constexpr (PORT_BASE == 0x3F8) return "COM1";
+        else if constexpr (PORT_BASE == 0x2F8) return "COM2";
+        else if constexpr (PORT_BASE == 0x3E8) return "COM3";
+        else if constexpr (PORT_BASE == 0x2E8) return "COM4";
+        else return "COM?";
+    }
+
+private:
+    static constexpr usize kBufferSize = 4096;
+
+    static inline char  s_buffer[kBufferSize] = {};
+    static inline usize s_len  = 0;
+    static inline bool  s_echo = false;
+};
+
+using SerialCOM1 = Serial<0x3F8>;
+using SerialCOM2 = Serial<0x2F8>;
+using SerialCOM3 = Serial<0x3E8>;
+using SerialCOM4 = Serial<0x2E8>;
+
+#endif //SERIAL_HH
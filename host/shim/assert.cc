@@ -0,0 +1,14 @@
+// Host stand-in for kernel/Source/ktl/assert.cc: report on stderr and abort
+// so a failed ktl assertion shows up as a crash of the bench binary.
+
+#include <ktl/assert>
+#include <stdio.h>
+#include <stdlib.h>
+
+[[noreturn]] void ktl::assertion_failure(const char* expr,
+                                         const char* file,
+                                         int         line)
+{
+    fprintf(stderr, "Assertion failed: %s\n  at %s:%d\n", expr, file, line);
+    abort();
+}
@@ -0,0 +1,12 @@
+#ifndef PREEMPT_HH
+#define PREEMPT_HH
+
+// Host stand-in for kernel/Source/core/preempt.hh. Host threads are
+// preempted by the OS whatever the count says, so there is nothing to
+// track; the calls compile away and lock benchmarks measure the locks.
+
+inline void preempt_disable() {}
+inline void preempt_enable() {}
+inline bool preemptible() { return true; }
+
+#endif // PREEMPT_HH
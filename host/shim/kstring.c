@@ -0,0 +1,46 @@
+// See kstring.h.
+
+#define memcpy kstr_memcpy
+#define memmove kstr_memmove
+#define strcpy kstr_strcpy
+#define strncpy kstr_strncpy
+#define strcat kstr_strcat
+#define strncat kstr_strncat
+#define memcmp kstr_memcmp
+#define strcmp kstr_strcmp
+#define strncmp kstr_strncmp
+#define memchr kstr_memchr
+#define strchr kstr_strchr
+#define strrchr kstr_strrchr
+#define strdup kstr_strdup
+#define strlen kstr_strlen
+#define strnlen kstr_strnlen
+#define memset kstr_memset
+#define strspn kstr_strspn
+#define strcspn kstr_strcspn
+#define strpbrk kstr_strpbrk
+#define strstr kstr_strstr
+#define strtok kstr_strtok
+#define isalnum kstr_isalnum
+#define isalpha kstr_isalpha
+#define iscntrl kstr_iscntrl
+#define isdigit kstr_isdigit
+#define isgraph kstr_isgraph
+#define islower kstr_islower
+#define isprint kstr_isprint
+#define ispunct kstr_ispunct
+#define isspace kstr_isspace
+#define isupper kstr_isupper
+#define isxdigit kstr_isxdigit
+#define tolower kstr_tolower
+#define toupper kstr_toupper
+#define atoi kstr_atoi
+#define atol kstr_atol
+#define atoll kstr_atoll
+#define itoa kstr_itoa
+#define ltoa kstr_ltoa
+#define lltoa kstr_lltoa
+#define strtol kstr_strtol
+#define strtoll kstr_strtoll
+
+#include "../../kernel/Source/util/string.c"
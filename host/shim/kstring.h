@@ -0,0 +1,95 @@
+#ifndef KSTRING_H
+#define KSTRING_H
+
+// The kernel's util/string.c, built for the host under a kstr_ prefix so it
+// can be linked (and compared) next to the C library's own routines.
+
+#define memcpy kstr_memcpy
+#define memmove kstr_memmove
+#define strcpy kstr_strcpy
+#define strncpy kstr_strncpy
+#define strcat kstr_strcat
+#define strncat kstr_strncat
+#define memcmp kstr_memcmp
+#define strcmp kstr_strcmp
+#define strncmp kstr_strncmp
+#define memchr kstr_memchr
+#define strchr kstr_strchr
+#define strrchr kstr_strrchr
+#define strdup kstr_strdup
+#define strlen kstr_strlen
+#define strnlen kstr_strnlen
+#define memset kstr_memset
+#define strspn kstr_strspn
+#define strcspn kstr_strcspn
+#define strpbrk kstr_strpbrk
+#define strstr kstr_strstr
+#define strtok kstr_strtok
+#define isalnum kstr_isalnum
+#define isalpha kstr_isalpha
+#define iscntrl kstr_iscntrl
+#define isdigit kstr_isdigit
+#define isgraph kstr_isgraph
+#define islower kstr_islower
+#define isprint kstr_isprint
+#define ispunct kstr_ispunct
+#define isspace kstr_isspace
+#define isupper kstr_isupper
+#define isxdigit kstr_isxdigit
+#define tolower kstr_tolower
+#define toupper kstr_toupper
+#define atoi kstr_atoi
+#define atol kstr_atol
+#define atoll kstr_atoll
+#define itoa kstr_itoa
+#define ltoa kstr_ltoa
+#define lltoa kstr_lltoa
+#define strtol kstr_strtol
+#define strtoll kstr_strtoll
+
+#include <util/string.h>
+
+#undef memcpy
+#undef memmove
+#undef strcpy
+#undef strncpy
+#undef strcat
+#undef strncat
+#undef memcmp
+#undef strcmp
+#undef strncmp
+#undef memchr
+#undef strchr
+#undef strrchr
+#undef strdup
+#undef strlen
+#undef strnlen
+#undef memset
+#undef strspn
+#undef strcspn
+#undef strpbrk
+#undef strstr
+#undef strtok
+#undef isalnum
+#undef isalpha
+#undef iscntrl
+#undef isdigit
+#undef isgraph
+#undef islower
+#undef isprint
+#undef ispunct
+#undef isspace
+#undef isupper
+#undef isxdigit
+#undef tolower
+#undef toupper
+#undef atoi
+#undef atol
+#undef atoll
+#undef itoa
+#undef ltoa
+#undef lltoa
+#undef strtol
+#undef strtoll
+
+#endif // KSTRING_H
@@ -0,0 +1,68 @@
+// Host stand-in for kernel/Source/ktl/rcu.cc. There are no per-CPU
+// quiescent states to track on the host, and the code built here only
+// reads RCU-protected data from the thread that updates it, so a grace
+// period ends at the next synchronize_rcu() or rcu_quiescent_state().
+// call_rcu() callbacks still wait for that, so a test can tell a node
+// freed early from one freed after its grace period.
+
+#include <ktl/rcu>
+#include <ktl/spinlock>
+
+namespace {
+
+ktl::SpinLock   s_lock;
+ktl::rcu_head*  s_head = nullptr;
+ktl::rcu_head** s_tail = &s_head;
+
+void runCallbacks() {
+    s_lock.lock();
+    ktl::rcu_head* list = s_head;
+    s_head = nullptr;
+    s_tail = &s_head;
+    s_lock.unlock();
+
+    while (list) {
+        ktl::rcu_head* next = list->next;
+        list->func(list);
+        list = next;
+    }
+}
+
+} // namespace
+
+void ktl::synchronize_rcu() {
+    runCallbacks();
+}
+
+void ktl::call_rcu(rcu_head* head, void (*func)(rcu_head*)) {
+    head->func = func;
+    head->next = nullptr;
+
+    s_lock.lock();
+    *s_tail = head;
+    s_tail = &head->next;
+    s_lock.unlock();
+}
+
+bool ktl::rcu_pending() {
+    s_lock.lock();
+    const bool pending = s_head != nullptr;
+    s_lock.unlock();
+    return pending;
+}
+
+void ktl::rcu_quiescent_state() {
+    runCallbacks();
+}
+
+void ktl::rcu_idle_enter() {
+    runCallbacks();
+}
+
+void ktl::rcu_idle_exit() {}
+
+bool ktl::rcu_irq_enter() { return false; }
+void ktl::rcu_irq_exit(bool) {}
+
+void ktl::rcu_cpu_online(u32) {}
+void ktl::rcu_cpu_offline(u32) {}
@@ -0,0 +1,35 @@
+// Host stand-in for kernel/Source/core/sched_hooks.cc, on Linux's own
+// futex(2). Deadlines are CLOCK_MONOTONIC readings in ns.
+
+#include <ktl/sched_hooks>
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace ktl::hooks {
+
+bool futex_wait(const u32* addr, u32 expected, u64 deadline) noexcept {
+    if (deadline == kWaitForever) {
+        syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+        return true;
+    }
+
+    // FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC time.
+    const timespec at = {
+        .tv_sec  = static_cast<time_t>(deadline / 1'000'000'000),
+        .tv_nsec = static_cast<long>(deadline % 1'000'000'000),
+    };
+    const long r = syscall(SYS_futex, addr, FUTEX_WAIT_BITSET_PRIVATE, expected, &at,
+                           nullptr, FUTEX_BITSET_MATCH_ANY);
+    return !(r == -1 && errno == ETIMEDOUT);
+}
+
+u32 futex_wake(const u32* addr, u32 count) noexcept {
+    const int n = count > 0x7fffffff ? 0x7fffffff : static_cast<int>(count);
+    const long woken = syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, n, nullptr, nullptr, 0);
+    return woken > 0 ? static_cast<u32>(woken) : 0;
+}
+
+} // namespace ktl::hooks
@@ -0,0 +1,274 @@
+#include <stdlib.h>
+#include <ktl/algorythm>
+
+#include "test.hh"
+
+// ktl/algorythm against qsort and linear scans: the sorts and
+// nth_element over random sizes and input shapes (random, few distinct
+// values, sorted, reversed, organ pipe), the binary searches at every
+// boundary, and the heap operations under random push/pop sequences.
+
+namespace {
+
+constexpr usize kMaxLen = 3000;
+
+int compareU32(const void* a, const void* b) {
+    const u32 x = *static_cast<const u32*>(a);
+    const u32 y = *static_cast<const u32*>(b);
+    return (x > y) - (x < y);
+}
+
+void fill(u32* a, usize n, hosttest::Rng& rng) {
+    const u64 shape = rng.below(6);
+    for (usize i = 0; i < n; ++i) {
+        switch (shape) {
+        case 0: a[i] = static_cast<u32>(rng.next()); break;
+        case 1: a[i] = static_cast<u32>(rng.below(4)); break;
+        case 2: a[i] = static_cast<u32>(i); break;
+        case 3: a[i] = static_cast<u32>(n - i); break;
+        case 4: a[i] = static_cast<u32>(i < n / 2 ? i : n - i); break;
+        // Sorted with a few strays.
+        case 5: a[i] = static_cast<u32>(rng.below(32) ? i : rng.below(n)); break;
+        }
+    }
+}
+
+bool same(const u32* a, const u32* b, usize n) {
+    for (usize i = 0; i < n; ++i) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Greater {
+    constexpr bool operator()(u32 a, u32 b) const { return a > b; }
+};
+
+} // namespace
+
+HOST_TEST(algorythm_sort_matches_qsort) {
+    static u32 input[kMaxLen];
+    static u32 want[kMaxLen];
+    static u32 got[kMaxLen];
+    hosttest::Rng rng(1);
+    for (usize round = 0; round < 600; ++round) {
+        const usize n = round < 40 ? round : rng.below(kMaxLen + 1);
+        fill(input, n, rng);
+        for (usize i = 0; i < n; ++i) {
+            want[i] = got[i] = input[i];
+        }
+        qsort(want, n, sizeof(u32), compareU32);
+
+        ktl::sort(got, got + n);
+        bool ok = same(got, want, n) && ktl::is_sorted(got, got + n);
+
+        // Descending with a comparator, then back through the heap sort.
+        ktl::sort(got, got + n, Greater {});
+        for (usize i = 0; i < n; ++i) {
+            ok &= got[i] == want[n - 1 - i];
+        }
+        ok &= ktl::is_sorted(got, got + n, Greater {});
+        ktl::make_heap(got, got + n);
+        ok &= ktl::is_heap(got, got + n);
+        ktl::sort_heap(got, got + n);
+        ok &= same(got, want, n);
+
+        if (!ok) {
+            CHECK(ok);
+            fprintf(stderr, "    round %zu, length %zu\n", round, n);
+            return;
+        }
+    }
+}
+
+namespace {
+
+// Sorted by key only; index records the original position.
+struct Keyed {
+    u32 key;
+    u32 index;
+};
+
+struct ByKey {
+    constexpr bool operator()(const Keyed& a, const Keyed& b) const { return a.key < b.key; }
+};
+
+int compareKeyThenIndex(const void* a, const void* b) {
+    const auto& x = *static_cast<const Keyed*>(a);
+    const auto& y = *static_cast<const Keyed*>(b);
+    if (x.key != y.key) {
+        return (x.key > y.key) - (x.key < y.key);
+    }
+    return (x.index > y.index) - (x.index < y.index);
+}
+
+} // namespace
+
+HOST_TEST(algorythm_stable_sort_keeps_equal_keys_in_order) {
+    static Keyed want[kMaxLen];
+    static Keyed got[kMaxLen];
+    hosttest::Rng rng(2);
+    for (usize round = 0; round < 300; ++round) {
+        const usize n = round < 40 ? round : rng.below(kMaxLen + 1);
+        const u64 keys = 1 + rng.below(round % 2 ? 8 : 100'000);
+        for (usize i = 0; i < n; ++i) {
+            want[i] = got[i] = { static_cast<u32>(rng.below(keys)), static_cast<u32>(i) };
+        }
+        qsort(want, n, sizeof(Keyed), compareKeyThenIndex);
+        ktl::stable_sort(got, got + n, ByKey {});
+
+        bool ok = true;
+        for (usize i = 0; i < n; ++i) {
+            ok &= got[i].key == want[i].key && got[i].index == want[i].index;
+        }
+        if (!ok) {
+            CHECK(ok);
+            fprintf(stderr, "    round %zu, length %zu\n", round, n);
+            return;
+        }
+    }
+}
+
+HOST_TEST(algorythm_nth_element_partitions) {
+    static u32 sorted[kMaxLen];
+    static u32 got[kMaxLen];
+    hosttest::Rng rng(3);
+    for (usize round = 0; round < 600; ++round) {
+        const usize n = 1 + rng.below(round < 100 ? 40 : kMaxLen);
+        fill(got, n, rng);
+        for (usize i = 0; i < n; ++i) {
+            sorted[i] = got[i];
+        }
+        qsort(sorted, n, sizeof(u32), compareU32);
+
+        const usize nth = rng.below(n);
+        ktl::nth_element(got, got + nth, got + n);
+        bool ok = got[nth] == sorted[nth];
+        for (usize i = 0; i < n; ++i) {
+            ok &= i < nth ? got[i] <= got[nth] : got[i] >= got[nth];
+        }
+        // Still a permutation of the input.
+        qsort(got, n, sizeof(u32), compareU32);
+        ok &= same(got, sorted, n);
+        if (!ok) {
+            CHECK(ok);
+            fprintf(stderr, "    round %zu, length %zu, nth %zu\n", round, n, nth);
+            return;
+        }
+    }
+}
+
+HOST_TEST(algorythm_binary_searches_match_linear_scan) {
+    static u32 a[512];
+    hosttest::Rng rng(4);
+    for (usize round = 0; round < 400; ++round) {
+        const usize n = rng.below(513);
+        const u64 spread = 1 + rng.below(round % 2 ? 16 : 4096);
+        for (usize i = 0; i < n; ++i) {
+            a[i] = static_cast<u32>(rng.below(spread));
+        }
+        qsort(a, n, sizeof(u32), compareU32);
+
+        bool ok = true;
+        // Every value in range plus one either side of it.
+        for (u32 v = 0; v <= spread + 1 && ok; ++v) {
+            usize lo = 0;
+            while (lo < n && a[lo] < v) {
+                ++lo;
+            }
+            usize hi = lo;
+            while (hi < n && a[hi] == v) {
+                ++hi;
+            }
+            ok &= ktl::lower_bound(a, a + n, v) == a + lo;
+            ok &= ktl::branchless_lower_bound(a, a + n, v) == a + lo;
+            ok &= ktl::upper_bound(a, a + n, v) == a + hi;
+            const auto range = ktl::equal_range(a, a + n, v);
+            ok &= range.first == a + lo && range.last == a + hi;
+            ok &= ktl::binary_search(a, a + n, v) == (hi > lo);
+            if (!ok) {
+                CHECK(ok);
+                fprintf(stderr, "    round %zu, length %zu, value %u\n", round, n, v);
+            }
+        }
+        if (!ok) {
+            return;
+        }
+    }
+}
+
+HOST_TEST(algorythm_heap_random_push_pop) {
+    for (u64 seed = 1; seed <= 8; ++seed) {
+        hosttest::Rng rng(seed);
+        u32 heap[256];
+        u32 model[256];
+        usize n = 0;
+        for (usize step = 0; step < 5000; ++step) {
+            bool ok = true;
+            if (n < 256 && (n == 0 || rng.below(2))) {
+                const u32 v = static_cast<u32>(rng.below(1000));
+                heap[n] = model[n] = v;
+                ++n;
+                ktl::push_heap(heap, heap + n);
+            } else {
+                // The model's largest, removed by swapping in the last.
+                usize top = 0;
+                for (usize i = 1; i < n; ++i) {
+                    top = model[i] > model[top] ? i : top;
+                }
+                ktl::pop_heap(heap, heap + n);
+                ok &= heap[n - 1] == model[top];
+                model[top] = model[--n];
+            }
+            ok &= ktl::is_heap(heap, heap + n);
+            if (!ok) {
+                CHECK(ok);
+                fprintf(stderr, "    seed %llu, step %zu\n", static_cast<unsigned long long>(seed), step);
+                break;
+            }
+        }
+    }
+}
+
+HOST_TEST(algorythm_rotate) {
+    u32 a[64];
+    for (usize n = 0; n <= 64; ++n) {
+        for (usize mid = 0; mid <= n; ++mid) {
+            for (usize i = 0; i < n; ++i) {
+                a[i] = static_cast<u32>(i);
+            }
+            u32* const result = ktl::rotate(a, a + mid, a + n);
+            bool ok = result == a + (n - mid);
+            for (usize i = 0; i < n; ++i) {
+                ok &= a[i] == (i + mid) % n;
+            }
+            if (!ok) {
+                CHECK(ok);
+                fprintf(stderr, "    length %zu, middle %zu\n", n, mid);
+                return;
+            }
+        }
+    }
+}
+
+namespace {
+
+constexpr bool sortsAtCompileTime() {
+    u32 a[40] = {};
+    for (u32 i = 0; i < 40; ++i) {
+        a[i] = (i * 17) % 40;
+    }
+    ktl::sort(a, a + 40);
+    for (u32 i = 0; i < 40; ++i) {
+        if (a[i] != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(sortsAtCompileTime());
+
+} // namespace
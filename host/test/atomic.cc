@@ -0,0 +1,105 @@
+#include <ktl/atomic>
+
+#include "test.hh"
+
+HOST_TEST(atomic_integral_ops) {
+    ktl::atomic<u32> a { 5 };
+    CHECK_EQ(a.load(), 5u);
+    a.store(7);
+    CHECK_EQ(a.exchange(9), 7u);
+    CHECK_EQ(a.fetch_add(3), 9u);
+    CHECK_EQ(a.fetch_sub(2), 12u);
+    CHECK_EQ(a.fetch_or(0x100), 10u);
+    CHECK_EQ(a.fetch_and(0x10f), 0x10au);
+    CHECK_EQ(a.fetch_xor(0xff), 0x10au);
+    CHECK_EQ(a.load(), 0x1f5u);
+
+    CHECK_EQ(++a, 0x1f6u);
+    CHECK_EQ(a++, 0x1f6u);
+    CHECK_EQ(--a, 0x1f6u);
+    CHECK_EQ(a--, 0x1f6u);
+    CHECK_EQ(a += 11, 0x200u);
+    CHECK_EQ(a -= 0x100, 0x100u);
+    CHECK_EQ(a |= 1, 0x101u);
+    CHECK_EQ(a &= 0xf, 1u);
+    CHECK_EQ(a ^= 3, 2u);
+}
+
+HOST_TEST(atomic_wraps_like_unsigned) {
+    ktl::atomic<u8> a { 0xff };
+    CHECK_EQ(a.fetch_add(1), 0xff);
+    CHECK_EQ(a.load(), 0);
+    CHECK_EQ(a.fetch_sub(1), 0);
+    CHECK_EQ(a.load(), 0xff);
+}
+
+HOST_TEST(atomic_compare_exchange) {
+    ktl::atomic<u64> a { 1 };
+    u64 expected = 2;
+    CHECK(!a.compare_exchange_strong(expected, 3));
+    CHECK_EQ(expected, 1u);
+    CHECK(a.compare_exchange_strong(expected, 3));
+    CHECK_EQ(a.load(), 3u);
+
+    // Weak may fail spuriously, but not forever.
+    expected = 3;
+    while (!a.compare_exchange_weak(expected, 4)) {
+        CHECK_EQ(expected, 3u);
+    }
+    CHECK_EQ(a.load(), 4u);
+}
+
+HOST_TEST(atomic_pointer_scaled) {
+    u64 array[8] = {};
+    ktl::atomic<u64*> p { array };
+    CHECK_EQ(p.fetch_add(3), &array[0]);
+    CHECK_EQ(p.load(), &array[3]);
+    CHECK_EQ(p.fetch_sub(1), &array[3]);
+    CHECK_EQ(p += 4, &array[6]);
+    CHECK_EQ(p -= 6, &array[0]);
+}
+
+HOST_TEST(atomic_ref_and_flag) {
+    u32 plain = 10;
+    ktl::atomic_ref<u32> ref(plain);
+    CHECK_EQ(ref.fetch_add(5), 10u);
+    ref = 40;
+    CHECK_EQ(plain, 40u);
+
+    ktl::atomic_flag flag;
+    CHECK(!flag.test());
+    CHECK(!flag.test_and_set());
+    CHECK(flag.test_and_set());
+    flag.clear();
+    CHECK(!flag.test());
+}
+
+namespace {
+
+constexpr u64 kAdds = 100'000;
+
+struct Counters {
+    ktl::atomic<u64> sum { 0 };
+    ktl::atomic<u32> cas_sum { 0 };
+};
+
+} // namespace
+
+// No increment is lost when threads add concurrently, either through
+// fetch_add or through a compare-exchange loop.
+HOST_TEST(atomic_concurrent_adds) {
+    constexpr int kThreads = 4;
+    Counters counters;
+    hosttest::runThreads(kThreads, [](int, void* ctx) {
+        auto& c = *static_cast<Counters*>(ctx);
+        for (u64 i = 0; i < kAdds; ++i) {
+            c.sum.fetch_add(1, ktl::memory_order_relaxed);
+            u32 v = c.cas_sum.load(ktl::memory_order_relaxed);
+            while (!c.cas_sum.compare_exchange_weak(v, v + 1, ktl::memory_order_relaxed,
+                                                    ktl::memory_order_relaxed)) {
+            }
+        }
+    }, &counters);
+    CHECK_EQ(counters.sum.load(), kThreads * kAdds);
+    CHECK_EQ(counters.cas_sum.load(), kThreads * kAdds);
+}
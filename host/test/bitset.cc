@@ -0,0 +1,263 @@
+#include <ktl/atomic>
+#include <ktl/bitset>
+
+#include "test.hh"
+
+// ktl::bitset and ktl::bitmap under random single-bit, range and atomic
+// operations, checked against a bool array: every bit, the counts and each
+// search must agree with it, and the bits past size() in the last word
+// must stay clear. Sizes straddle word boundaries on purpose.
+
+namespace {
+
+constexpr usize kMaxBits = 320;
+constexpr usize npos     = ktl::bitmap::npos;
+
+struct Model {
+    bool  bits[kMaxBits] = {};
+    usize size = 0;
+
+    usize count() const {
+        usize n = 0;
+        for (usize i = 0; i < size; ++i) {
+            n += bits[i];
+        }
+        return n;
+    }
+
+    usize findNext(usize from, bool value) const {
+        for (usize i = from; i < size; ++i) {
+            if (bits[i] == value) {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+    usize findLastSet() const {
+        for (usize i = size; i-- > 0;) {
+            if (bits[i]) {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+    usize findClearRun(usize length, usize from) const {
+        for (usize start = from; start + length <= size; ++start) {
+            usize run = 0;
+            while (run < length && !bits[start + run]) {
+                ++run;
+            }
+            if (run == length) {
+                return start;
+            }
+        }
+        return npos;
+    }
+};
+
+template<typename Bits>
+bool matches(Bits& b, const Model& m, hosttest::Rng& rng) {
+    if (b.size() != m.size) {
+        return false;
+    }
+    for (usize i = 0; i < m.size; ++i) {
+        if (b.test(i) != m.bits[i] || b.atomic_test(i) != m.bits[i]) {
+            return false;
+        }
+    }
+    // Nothing leaks past the last valid bit.
+    const u64* words = b.words();
+    const usize tail = m.size % 64;
+    if (tail && (words[m.size / 64] >> tail) != 0) {
+        return false;
+    }
+
+    const usize count = m.count();
+    if (b.count() != count || b.any() != (count != 0) || b.none() != (count == 0)) {
+        return false;
+    }
+    if (b.find_first_set() != m.findNext(0, true) || b.find_first_clear() != m.findNext(0, false)) {
+        return false;
+    }
+    if (b.find_last_set() != m.findLastSet()) {
+        return false;
+    }
+    for (int probe = 0; probe < 8; ++probe) {
+        const usize from = rng.below(m.size + 2);
+        if (b.find_next_set(from) != m.findNext(from, true) ||
+            b.find_next_clear(from) != m.findNext(from, false))
+        {
+            return false;
+        }
+        const usize length = 1 + rng.below(80);
+        if (b.find_clear_run(length, from) != m.findClearRun(length, from)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Bits>
+void randomOps(Bits& b, Model& m, u64 seed) {
+    hosttest::Rng rng(seed);
+    for (usize step = 0; step < 4000; ++step) {
+        const usize i = rng.below(m.size);
+        bool ok = true;
+        switch (rng.below(10)) {
+        case 0:
+            b.set(i);
+            m.bits[i] = true;
+            break;
+        case 1:
+            b.reset(i);
+            m.bits[i] = false;
+            break;
+        case 2:
+            b.flip(i);
+            m.bits[i] = !m.bits[i];
+            break;
+        case 3: {
+            const bool value = rng.below(2);
+            b.set(i, value);
+            m.bits[i] = value;
+            break;
+        }
+        case 4:
+        case 5: {
+            // Ranges of every length, including empty and full-width.
+            const usize length = rng.below(m.size - i + 1);
+            const bool  value  = rng.below(2);
+            value ? b.set_range(i, length) : b.reset_range(i, length);
+            for (usize k = i; k < i + length; ++k) {
+                m.bits[k] = value;
+            }
+            break;
+        }
+        case 6:
+            ok &= b.atomic_test_and_set(i) == m.bits[i];
+            m.bits[i] = true;
+            break;
+        case 7:
+            ok &= b.atomic_test_and_reset(i) == m.bits[i];
+            m.bits[i] = false;
+            break;
+        case 8: {
+            const usize got = b.atomic_find_and_set(i);
+            const usize want = m.findNext(i, false);
+            ok &= got == want;
+            if (want != npos) {
+                m.bits[want] = true;
+            }
+            break;
+        }
+        case 9:
+            if (rng.below(32) == 0) {
+                b.set_all();
+                for (usize k = 0; k < m.size; ++k) {
+                    m.bits[k] = true;
+                }
+            } else if (rng.below(32) == 0) {
+                b.reset_all();
+                for (usize k = 0; k < m.size; ++k) {
+                    m.bits[k] = false;
+                }
+            } else {
+                rng.below(2) ? b.atomic_set(i) : b.atomic_reset(i);
+                m.bits[i] = b.test(i);
+            }
+            break;
+        }
+        ok &= matches(b, m, rng);
+        if (!ok) {
+            CHECK(ok);
+            fprintf(stderr, "    seed %llu, step %zu\n", static_cast<unsigned long long>(seed), step);
+            return;
+        }
+    }
+}
+
+} // namespace
+
+HOST_TEST(bitset_random_ops) {
+    for (u64 seed = 1; seed <= 4; ++seed) {
+        ktl::bitset<130> b;
+        Model m;
+        m.size = 130;
+        randomOps(b, m, seed);
+    }
+    for (u64 seed = 1; seed <= 4; ++seed) {
+        ktl::bitset<64> b;
+        Model m;
+        m.size = 64;
+        randomOps(b, m, seed);
+    }
+}
+
+HOST_TEST(bitmap_random_ops) {
+    static constexpr usize kSizes[] = { 1, 63, 200, 256, 317 };
+    for (const usize bits : kSizes) {
+        for (u64 seed = 1; seed <= 4; ++seed) {
+            u64 words[kMaxBits / 64] = {};
+            ktl::bitmap b(ktl::slice<u64>(words, ktl::bitmap::words_for(bits)), bits);
+            Model m;
+            m.size = bits;
+            randomOps(b, m, seed);
+        }
+    }
+}
+
+HOST_TEST(bitset_equality) {
+    ktl::bitset<100> a;
+    ktl::bitset<100> b;
+    CHECK(a == b);
+    a.set(99);
+    CHECK(!(a == b));
+    b.set_range(90, 10);
+    b.reset_range(90, 9);
+    CHECK(a == b);
+}
+
+namespace {
+
+constexpr int   kClaimers = 4;
+constexpr usize kClaimBits = 4096;
+
+// Threads race atomic_find_and_set until the map is full; each bit must
+// go to exactly one of them.
+struct ClaimShared {
+    u64         words[kClaimBits / 64] = {};
+    ktl::bitmap map { ktl::slice<u64>(words, kClaimBits / 64) };
+    ktl::atomic<u8> owners[kClaimBits] {};
+};
+
+void claimSide(int index, void* ctx) {
+    auto& s = *static_cast<ClaimShared*>(ctx);
+    usize from = static_cast<usize>(index) * (kClaimBits / kClaimers);
+    for (;;) {
+        usize bit = s.map.atomic_find_and_set(from);
+        if (bit == npos) {
+            bit = s.map.atomic_find_and_set(0);
+        }
+        if (bit == npos) {
+            return;
+        }
+        s.owners[bit].fetch_add(1, ktl::memory_order_relaxed);
+        from = bit;
+    }
+}
+
+} // namespace
+
+HOST_TEST(bitmap_threads_claim_exactly_once) {
+    static ClaimShared s;
+    hosttest::runThreads(kClaimers, claimSide, &s);
+
+    u64 wrong = 0;
+    for (const auto& o : s.owners) {
+        wrong += o.load(ktl::memory_order_relaxed) != 1;
+    }
+    CHECK_EQ(wrong, 0u);
+    CHECK_EQ(s.map.count(), kClaimBits);
+}
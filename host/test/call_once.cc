@@ -0,0 +1,53 @@
+#include <ktl/call_once>
+#include <ktl/sched_hooks>
+#include <time.h>
+
+#include "test.hh"
+
+// ktl::call_once and the futex hooks it sleeps on.
+
+namespace {
+
+u64 monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<u64>(ts.tv_sec) * 1'000'000'000 + static_cast<u64>(ts.tv_nsec);
+}
+
+struct OnceCtx {
+    ktl::once_flag flag;
+    u32            calls = 0;
+    u32            seen  = 0;
+};
+
+} // namespace
+
+HOST_TEST(call_once_runs_once) {
+    OnceCtx ctx;
+    hosttest::runThreads(8, [](int, void* p) {
+        auto* c = static_cast<OnceCtx*>(p);
+        ktl::call_once(c->flag, [c] {
+            // Long enough that the losers get to sleep on the flag.
+            timespec ts = { 0, 2'000'000 };
+            nanosleep(&ts, nullptr);
+            __atomic_fetch_add(&c->calls, 1, __ATOMIC_RELAXED);
+        });
+        // Everybody returns only after the call has finished.
+        if (__atomic_load_n(&c->calls, __ATOMIC_RELAXED) == 1) {
+            __atomic_fetch_add(&c->seen, 1, __ATOMIC_RELAXED);
+        }
+    }, &ctx);
+    CHECK_EQ(ctx.calls, 1u);
+    CHECK_EQ(ctx.seen, 8u);
+}
+
+HOST_TEST(futex_wait_times_out) {
+    u32 word = 0;
+    const u64 start = monotonicNs();
+    CHECK(!ktl::hooks::futex_wait(&word, 0, start + 5'000'000));
+    CHECK(monotonicNs() - start >= 5'000'000);
+
+    // A changed word returns at once, deadline or not.
+    CHECK(ktl::hooks::futex_wait(&word, 1, start));
+    CHECK_EQ(ktl::hooks::futex_wake(&word), 0u);
+}
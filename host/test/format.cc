@@ -0,0 +1,73 @@
+#include <core/format.hh>
+#include <string.h>
+
+#include "test.hh"
+
+namespace {
+
+using Out = FmtBase<SerialCOM3>;
+
+// True if the output since the last reset is exactly expected.
+bool printed(const char* expected) {
+    const ktl::string_view got = SerialCOM3::captured();
+    const bool same = got.size() == strlen(expected) && memcmp(got.data(), expected, got.size()) == 0;
+    if (!same) {
+        fprintf(stderr, "    printed \"%.*s\", expected \"%s\"\n",
+                static_cast<int>(got.size()), got.data(), expected);
+    }
+    SerialCOM3::reset();
+    return same;
+}
+
+} // namespace
+
+HOST_TEST(fmt_print_values) {
+    SerialCOM3::reset();
+    Out::print("literal");
+    CHECK(printed("literal"));
+    Out::print(u64 { 18446744073709551615ULL });
+    CHECK(printed("18446744073709551615"));
+    Out::print(u32 { 0 });
+    CHECK(printed("0"));
+    Out::print(true);
+    CHECK(printed("true"));
+    Out::print(ktl::string_view("view", 2));
+    CHECK(printed("vi"));
+    Out::print('c');
+    CHECK(printed("c"));
+}
+
+HOST_TEST(fmt_printf_decimal) {
+    SerialCOM3::reset();
+    Out::printf("{} entries", 42);
+    CHECK(printed("42 entries"));
+    Out::printf("{} + {} = {}", 1, 2u, u64 { 3 });
+    CHECK(printed("1 + 2 = 3"));
+    Out::printf("[{:5}] [{:05}]", 42, 42);
+    CHECK(printed("[   42] [00042]"));
+    Out::printf("no args {{ here");
+    CHECK(printed("no args {{ here"));
+    Out::printf("{{{}", 7);
+    CHECK(printed("{7"));
+}
+
+HOST_TEST(fmt_printf_hex_and_binary) {
+    SerialCOM3::reset();
+    Out::printf("{:x} {:X} {:#x}", 0xbeef, 0xbeef, 0);
+    CHECK(printed("beef BEEF 0x0"));
+    Out::printf("{:#016x}", 0x1000);
+    CHECK(printed("0x0000000000001000"));
+    Out::printf("{:x}", u64 { 0xffffffffffffffffULL });
+    CHECK(printed("ffffffffffffffff"));
+    Out::printf("{:b} {:#b} {:08b}", 5, 2, 5);
+    CHECK(printed("101 0b10 00000101"));
+}
+
+HOST_TEST(fmt_printf_strings_and_newlines) {
+    SerialCOM3::reset();
+    const char* name = "COM3";
+    Out::printf("{} on {}\n", name, ktl::string_view("port"));
+    CHECK(printed("COM3 on port\r\n"));
+    Out::printf("{} {}", true, false);
+    CHECK(printed("true false"));
+}
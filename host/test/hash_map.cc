@@ -0,0 +1,228 @@
+#include <stdlib.h>
+#include <ktl/flat_hash_map>
+
+#include "test.hh"
+
+// ktl::flat_hash_map under random insert/assign/erase sequences, checked
+// against a direct-indexed array over a small key space: every lookup,
+// the size and a full iteration must agree with it. Weak hashes force
+// long clusters, probe wrap-around and heavy backward shifting.
+
+namespace {
+
+struct MallocAllocator {
+    static inline i64 s_live = 0;
+
+    void* allocate(usize bytes, usize align) noexcept {
+        void* p = aligned_alloc(align, (bytes + align - 1) & ~(align - 1));
+        if (p) {
+            ++s_live;
+        }
+        return p;
+    }
+
+    void deallocate(void* ptr, usize, usize) noexcept {
+        if (ptr) {
+            --s_live;
+            free(ptr);
+        }
+    }
+};
+
+// Everything in four clusters, a third of them homed on the last slot so
+// their probes wrap. The low 7 bits, the tag, still tell keys apart.
+struct ClusteringHash {
+    u64 operator()(u64 key) const noexcept {
+        const u64 h1 = key % 3 == 0 ? ~0ULL : key % 4;
+        return (h1 << 7) | (key & 0x7f);
+    }
+};
+
+// Every key the same hash: lookups come down to key compares.
+struct ConstantHash {
+    u64 operator()(u64) const noexcept { return 0x1234; }
+};
+
+// Values that count their own constructions and destructions.
+struct Value {
+    static inline i64 s_live = 0;
+
+    u64 v;
+
+    Value() : v(0) { ++s_live; }
+    Value(u64 x) : v(x) { ++s_live; }
+    Value(const Value& other) : v(other.v) { ++s_live; }
+    Value(Value&& other) noexcept : v(other.v) { ++s_live; }
+    Value& operator=(const Value&) = default;
+    Value& operator=(Value&&) noexcept = default;
+    ~Value() { --s_live; }
+};
+
+constexpr u64 kKeys = 2048;
+
+struct Model {
+    bool present[kKeys] = {};
+    u64  values[kKeys];
+    u64  size = 0;
+};
+
+template<typename Map>
+bool matches(Map& map, const Model& m) {
+    if (map.size() != m.size || map.empty() != (m.size == 0)) {
+        return false;
+    }
+    for (u64 k = 0; k < kKeys; ++k) {
+        const Value* v = map.find(k);
+        if ((v != nullptr) != m.present[k] || (v && v->v != m.values[k])) {
+            return false;
+        }
+    }
+    // Iteration visits each entry once.
+    u64 seen = 0;
+    for (auto& e : map) {
+        if (e.first >= kKeys || !m.present[e.first] || e.second.v != m.values[e.first]) {
+            return false;
+        }
+        ++seen;
+    }
+    return seen == m.size;
+}
+
+template<typename Hash>
+void randomOps(u64 seed, u64 key_space) {
+    hosttest::Rng rng(seed);
+    ktl::flat_hash_map<u64, Value, MallocAllocator, Hash> map;
+    Model m;
+
+    for (usize step = 0; step < 6000; ++step) {
+        const u64 key   = rng.below(key_space);
+        const u64 value = rng.next();
+        bool ok = true;
+        switch (rng.below(8)) {
+        case 0:
+        case 1: {
+            auto [v, inserted] = map.try_emplace(key, value);
+            ok &= inserted == !m.present[key];
+            if (inserted) {
+                m.present[key] = true;
+                m.values[key]  = value;
+                ++m.size;
+            }
+            ok &= v->v == m.values[key];
+            break;
+        }
+        case 2:
+            map.insert_or_assign(key, value);
+            m.size += !m.present[key];
+            m.present[key] = true;
+            m.values[key]  = value;
+            break;
+        case 3:
+            if (!m.present[key]) {
+                m.present[key] = true;
+                m.values[key]  = 0;
+                ++m.size;
+            }
+            ok &= map[key].v == m.values[key];
+            break;
+        case 4:
+        case 5:
+        case 6:
+            ok &= map.erase(key) == m.present[key];
+            m.size -= m.present[key];
+            m.present[key] = false;
+            break;
+        case 7:
+            if (rng.below(64) == 0) {
+                map.clear();
+                for (bool& p : m.present) {
+                    p = false;
+                }
+                m.size = 0;
+            } else if (rng.below(16) == 0) {
+                map.reserve(m.size + rng.below(256));
+            }
+            break;
+        }
+        // A full comparison is quadratic; do it every few steps and on
+        // any step that already failed.
+        if (!ok || step % 32 == 0) {
+            ok &= matches(map, m);
+        }
+        if (!ok) {
+            CHECK(ok);
+            fprintf(stderr, "    seed %llu, step %zu\n", static_cast<unsigned long long>(seed), step);
+            return;
+        }
+    }
+    CHECK(matches(map, m));
+}
+
+} // namespace
+
+HOST_TEST(hash_map_random_ops) {
+    for (u64 seed = 1; seed <= 8; ++seed) {
+        randomOps<ktl::hash<u64>>(seed, kKeys);
+    }
+    CHECK_EQ(Value::s_live, 0);
+    CHECK_EQ(MallocAllocator::s_live, 0);
+}
+
+HOST_TEST(hash_map_random_ops_clustered) {
+    for (u64 seed = 1; seed <= 8; ++seed) {
+        randomOps<ClusteringHash>(seed, kKeys);
+    }
+    CHECK_EQ(Value::s_live, 0);
+    CHECK_EQ(MallocAllocator::s_live, 0);
+}
+
+HOST_TEST(hash_map_random_ops_one_hash) {
+    for (u64 seed = 1; seed <= 4; ++seed) {
+        randomOps<ConstantHash>(seed, 128);
+    }
+    CHECK_EQ(Value::s_live, 0);
+    CHECK_EQ(MallocAllocator::s_live, 0);
+}
+
+HOST_TEST(hash_map_hashed_calls_and_move) {
+    ktl::flat_hash_map<u64, u64, MallocAllocator> map;
+    for (u64 k = 0; k < 1000; ++k) {
+        const u64 h = map.hash_of(k);
+        CHECK(map.try_emplace_hashed(h, k, k * 3).second);
+    }
+    CHECK_EQ(map.size(), 1000u);
+    CHECK(map.capacity() >= 1000);
+    for (u64 k = 0; k < 1000; ++k) {
+        const u64* v = map.find_hashed(k, map.hash_of(k));
+        CHECK(v && *v == k * 3);
+    }
+    for (u64 k = 0; k < 1000; k += 2) {
+        CHECK(map.erase_hashed(k, map.hash_of(k)));
+    }
+    CHECK(!map.erase(0));
+    CHECK_EQ(map.size(), 500u);
+
+    ktl::flat_hash_map<u64, u64, MallocAllocator> moved(ktl::move(map));
+    CHECK(map.empty());
+    CHECK(map.find(1) == nullptr);
+    CHECK_EQ(moved.size(), 500u);
+    for (u64 k = 0; k < 1000; ++k) {
+        CHECK_EQ(moved.contains(k), k % 2 == 1);
+    }
+}
+
+HOST_TEST(hash_map_reserve_keeps_storage) {
+    ktl::flat_hash_map<u64, u64, MallocAllocator> map;
+    map.reserve(500);
+    const usize capacity = map.capacity();
+    for (u64 k = 0; k < 500; ++k) {
+        map[k] = k;
+    }
+    CHECK_EQ(map.capacity(), capacity);
+
+    // A table that cannot allocate reports it instead of asserting.
+    ktl::flat_hash_map<u64, u64, ktl::null_allocator> none;
+    CHECK(!none.try_reserve(1));
+    CHECK(none.find(1) == nullptr);
+    CHECK(!none.erase(1));
+}
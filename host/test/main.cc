@@ -0,0 +1,36 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "test.hh"
+
+// Runs every registered test, or those whose name contains the first
+// argument, and exits with 1 if any check failed.
+
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+
+    u64 run    = 0;
+    u64 failed = 0;
+    for (auto* t = hosttest::g_head; t; t = t->next) {
+        if (filter && !strstr(t->name, filter)) {
+            continue;
+        }
+
+        hosttest::g_failures = 0;
+        t->fn();
+        ++run;
+        if (hosttest::g_failures) {
+            ++failed;
+            printf("%-40s FAILED (%llu checks)\n", t->name,
+                   static_cast<unsigned long long>(hosttest::g_failures));
+        } else {
+            printf("%-40s ok\n", t->name);
+        }
+        fflush(stdout);
+    }
+
+    printf("%llu tests, %llu failed\n",
+           static_cast<unsigned long long>(run),
+           static_cast<unsigned long long>(failed));
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,319 @@
+#include <ktl/ring>
+
+#include "test.hh"
+
+// The lock-free queues in ktl/ring: first single-threaded under random
+// operation sequences against a plain circular-buffer model, then with
+// real producers, consumers and thieves, checking that every item comes
+// out exactly once and in the order each queue promises.
+
+namespace {
+
+constexpr usize kCapacity = 64;
+
+// Double-ended FIFO over a circular buffer, the reference for all three.
+struct Model {
+    static constexpr usize kSlots = 1024;
+
+    u64   values[kSlots];
+    usize head = 0;
+    usize tail = 0;
+
+    usize size() const { return tail - head; }
+
+    void push_back(u64 v) { values[tail++ % kSlots] = v; }
+    u64  pop_front()      { return values[head++ % kSlots]; }
+    u64  pop_back()       { return values[--tail % kSlots]; }
+};
+
+// Random single and bulk pushes and pops on a FIFO queue.
+template<typename Queue>
+void randomFifo(Queue& q, u64 seed) {
+    hosttest::Rng rng(seed);
+    Model m;
+    u64 next = 1;
+    u64 buffer[kCapacity + 8];
+
+    for (usize step = 0; step < 20'000; ++step) {
+        bool ok = true;
+        switch (rng.below(4)) {
+        case 0: {
+            const bool pushed = q.try_push(next);
+            ok &= pushed == (m.size() < kCapacity);
+            if (pushed) {
+                m.push_back(next++);
+            }
+            break;
+        }
+        case 1: {
+            const usize want = 1 + rng.below(kCapacity / 4);
+            for (usize i = 0; i < want; ++i) {
+                buffer[i] = next + i;
+            }
+            const usize room = kCapacity - m.size();
+            const usize n = q.push_bulk(buffer, want);
+            ok &= n == (want < room ? want : room);
+            for (usize i = 0; i < n; ++i) {
+                m.push_back(next++);
+            }
+            break;
+        }
+        case 2: {
+            u64 out = 0;
+            const bool popped = q.try_pop(out);
+            ok &= popped == (m.size() != 0);
+            if (popped) {
+                ok &= out == m.pop_front();
+            }
+            break;
+        }
+        case 3: {
+            const usize want = 1 + rng.below(kCapacity / 4);
+            const usize avail = m.size();
+            const usize n = q.pop_bulk(buffer, want);
+            ok &= n == (want < avail ? want : avail);
+            for (usize i = 0; i < n; ++i) {
+                ok &= buffer[i] == m.pop_front();
+            }
+            break;
+        }
+        }
+        ok &= q.size() == m.size() && q.empty() == (m.size() == 0);
+        if (!ok) {
+            CHECK(ok);
+            fprintf(stderr, "    seed %llu, step %zu\n", static_cast<unsigned long long>(seed), step);
+            return;
+        }
+    }
+}
+
+} // namespace
+
+HOST_TEST(ring_spsc_random_ops) {
+    for (u64 seed = 1; seed <= 8; ++seed) {
+        ktl::spsc_ring<u64, kCapacity> q;
+        randomFifo(q, seed);
+    }
+}
+
+HOST_TEST(ring_mpmc_random_ops) {
+    for (u64 seed = 1; seed <= 8; ++seed) {
+        ktl::mpmc_queue<u64, kCapacity> q;
+        randomFifo(q, seed);
+    }
+}
+
+HOST_TEST(ring_ws_deque_random_ops) {
+    for (u64 seed = 1; seed <= 8; ++seed) {
+        hosttest::Rng rng(seed);
+        ktl::ws_deque<u64, kCapacity> q;
+        Model m;
+        u64 next = 1;
+
+        for (usize step = 0; step < 20'000; ++step) {
+            bool ok = true;
+            u64 out = 0;
+            switch (rng.below(3)) {
+            case 0: {
+                const bool pushed = q.try_push(next);
+                ok &= pushed == (m.size() < kCapacity);
+                if (pushed) {
+                    m.push_back(next++);
+                }
+                break;
+            }
+            case 1: {
+                // The owner pops what it pushed last.
+                const bool popped = q.try_pop(out);
+                ok &= popped == (m.size() != 0);
+                if (popped) {
+                    ok &= out == m.pop_back();
+                }
+                break;
+            }
+            case 2: {
+                // Thieves take the oldest.
+                const bool stolen = q.try_steal(out);
+                ok &= stolen == (m.size() != 0);
+                if (stolen) {
+                    ok &= out == m.pop_front();
+                }
+                break;
+            }
+            }
+            ok &= q.size() == m.size();
+            if (!ok) {
+                CHECK(ok);
+                fprintf(stderr, "    seed %llu, step %zu\n", static_cast<unsigned long long>(seed), step);
+                break;
+            }
+        }
+    }
+}
+
+namespace {
+
+// A side that finds the queue full or empty spins out its time slice, so
+// a single CPU gets far fewer items.
+u64 items() {
+    return hosttest::cpuCount() > 1 ? 1'000'000 : 3'000;
+}
+
+struct SpscShared {
+    ktl::spsc_ring<u64, kCapacity> q;
+    u64  total = 0;
+    bool in_order = true;
+};
+
+void spscSide(int index, void* ctx) {
+    auto& s = *static_cast<SpscShared*>(ctx);
+    u64 buffer[8];
+    if (index == 0) {
+        for (u64 sent = 0; sent < s.total;) {
+            const usize want = s.total - sent < 8 ? s.total - sent : 8;
+            for (usize i = 0; i < want; ++i) {
+                buffer[i] = sent + i;
+            }
+            sent += s.q.push_bulk(buffer, want);
+        }
+    } else {
+        for (u64 received = 0; received < s.total;) {
+            const usize n = s.q.pop_bulk(buffer, 8);
+            for (usize i = 0; i < n; ++i) {
+                s.in_order &= buffer[i] == received + i;
+            }
+            received += n;
+        }
+    }
+}
+
+} // namespace
+
+HOST_TEST(ring_spsc_threads_in_order) {
+    SpscShared s;
+    s.total = items();
+    hosttest::runThreads(2, spscSide, &s);
+    CHECK(s.in_order);
+    CHECK(s.q.empty());
+}
+
+namespace {
+
+constexpr int kProducers = 3;
+constexpr int kConsumers = 3;
+
+// Items are (producer << 32 | sequence). Each consumer sees every
+// producer's items in increasing order; together they see all of them.
+struct MpmcShared {
+    ktl::mpmc_queue<u64, kCapacity> q;
+    u64              per_producer = 0;
+    ktl::atomic<u64> consumed { 0 };
+    ktl::atomic<u64> sum { 0 };
+    ktl::atomic<bool> in_order { true };
+};
+
+void mpmcSide(int index, void* ctx) {
+    auto& s = *static_cast<MpmcShared*>(ctx);
+    const u64 total = s.per_producer * kProducers;
+    if (index < kProducers) {
+        const u64 tag = static_cast<u64>(index) << 32;
+        for (u64 i = 0; i < s.per_producer;) {
+            if (i % 2) {
+                i += s.q.try_push(tag | i) ? 1 : 0;
+            } else {
+                const u64 pair[2] = { tag | i, tag | (i + 1) };
+                i += s.q.push_bulk(pair, i + 1 < s.per_producer ? 2 : 1);
+            }
+        }
+        return;
+    }
+
+    u64 last[kProducers];
+    for (u64& l : last) {
+        l = ~0ULL;
+    }
+    u64 buffer[4];
+    u64 sum = 0;
+    while (s.consumed.load(ktl::memory_order_relaxed) < total) {
+        const usize n = s.q.pop_bulk(buffer, index % 2 ? 1 : 4);
+        for (usize i = 0; i < n; ++i) {
+            const u64 producer = buffer[i] >> 32;
+            const u64 seq      = buffer[i] & 0xffff'ffff;
+            if (producer >= kProducers || (last[producer] != ~0ULL && seq <= last[producer])) {
+                s.in_order.store(false, ktl::memory_order_relaxed);
+            } else {
+                last[producer] = seq;
+            }
+            sum += seq;
+        }
+        s.consumed.fetch_add(n, ktl::memory_order_relaxed);
+    }
+    s.sum.fetch_add(sum, ktl::memory_order_relaxed);
+}
+
+} // namespace
+
+HOST_TEST(ring_mpmc_threads_exactly_once) {
+    MpmcShared s;
+    s.per_producer = items() / kProducers;
+    hosttest::runThreads(kProducers + kConsumers, mpmcSide, &s);
+
+    const u64 n = s.per_producer;
+    CHECK(s.in_order.load(ktl::memory_order_relaxed));
+    CHECK_EQ(s.consumed.load(ktl::memory_order_relaxed), n * kProducers);
+    CHECK_EQ(s.sum.load(ktl::memory_order_relaxed), kProducers * (n * (n - 1) / 2));
+    CHECK(s.q.empty());
+}
+
+namespace {
+
+constexpr int kThieves = 3;
+constexpr u64 kDequeItems = 200'000;
+
+// The owner pushes every item once and pops some back; thieves steal the
+// rest. Each item must be taken exactly once.
+struct DequeShared {
+    ktl::ws_deque<u64, kCapacity> q;
+    ktl::atomic<u8>   taken[kDequeItems] {};
+    ktl::atomic<bool> done { false };
+};
+
+void dequeSide(int index, void* ctx) {
+    auto& s = *static_cast<DequeShared*>(ctx);
+    u64 item = 0;
+    if (index == 0) {
+        hosttest::Rng rng(11);
+        for (u64 next = 0; next < kDequeItems;) {
+            if (rng.below(3) != 0 && s.q.try_push(next)) {
+                ++next;
+            } else if (s.q.try_pop(item)) {
+                s.taken[item].fetch_add(1, ktl::memory_order_relaxed);
+            }
+        }
+        while (s.q.try_pop(item)) {
+            s.taken[item].fetch_add(1, ktl::memory_order_relaxed);
+        }
+        s.done.store(true, ktl::memory_order_release);
+        return;
+    }
+
+    while (!s.done.load(ktl::memory_order_acquire) || !s.q.empty()) {
+        if (s.q.try_steal(item)) {
+            s.taken[item].fetch_add(1, ktl::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace
+
+HOST_TEST(ring_ws_deque_threads_exactly_once) {
+    static DequeShared s;
+    hosttest::runThreads(1 + kThieves, dequeSide, &s);
+
+    u64 wrong = 0;
+    for (const auto& t : s.taken) {
+        wrong += t.load(ktl::memory_order_relaxed) != 1;
+    }
+    CHECK_EQ(wrong, 0u);
+    CHECK(s.q.empty());
+}
@@ -0,0 +1,80 @@
+#include <ktl/slice>
+
+#include "test.hh"
+
+HOST_TEST(slice_construct) {
+    u32 values[5] = { 1, 2, 3, 4, 5 };
+
+    ktl::slice<u32> empty;
+    CHECK(empty.empty());
+    CHECK_EQ(empty.size(), 0u);
+
+    ktl::slice<u32> all(values);
+    CHECK_EQ(all.size(), 5u);
+    CHECK_EQ(all.data(), &values[0]);
+    CHECK_EQ(all.front(), 1u);
+    CHECK_EQ(all.back(), 5u);
+
+    ktl::slice<u32> range(values + 1, values + 4);
+    CHECK_EQ(range.size(), 3u);
+    CHECK_EQ(range[0], 2u);
+
+    ktl::slice<u32, 5> fixed(values);
+    ktl::slice<const u32> widened(fixed);
+    CHECK_EQ(widened.size(), 5u);
+
+    u32 sum = 0;
+    for (u32 v : all) {
+        sum += v;
+    }
+    CHECK_EQ(sum, 15u);
+}
+
+HOST_TEST(slice_subslice_clamps) {
+    u32 values[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    ktl::slice<u32> s(values);
+
+    auto mid = s.subslice(2, 3);
+    CHECK_EQ(mid.size(), 3u);
+    CHECK_EQ(mid[0], 2u);
+
+    auto tail = s.subslice(5);
+    CHECK_EQ(tail.size(), 3u);
+    CHECK_EQ(tail[2], 7u);
+
+    CHECK_EQ(s.subslice(6, 100).size(), 2u);
+    CHECK(s.subslice(8).empty());
+    CHECK(s.subslice(20, 4).empty());
+
+    CHECK_EQ(s.first(3).back(), 2u);
+    CHECK_EQ(s.last(3).front(), 5u);
+}
+
+HOST_TEST(slice_remove_prefix_suffix) {
+    u32 values[6] = { 0, 1, 2, 3, 4, 5 };
+    ktl::slice<u32> s(values);
+    s.remove_prefix(2);
+    CHECK_EQ(s.size(), 4u);
+    CHECK_EQ(s.front(), 2u);
+    s.remove_suffix(1);
+    CHECK_EQ(s.back(), 4u);
+    s.remove_prefix(10);
+    CHECK(s.empty());
+}
+
+HOST_TEST(slice_bytes_and_equality) {
+    u32 a[3] = { 1, 2, 3 };
+    u32 b[3] = { 1, 2, 3 };
+    u32 c[3] = { 1, 2, 4 };
+    CHECK(ktl::slice<u32>(a) == ktl::slice<u32>(b));
+    CHECK(ktl::slice<u32>(a) != ktl::slice<u32>(c));
+    CHECK(ktl::slice<u32>(a) != ktl::slice<u32>(a, 2));
+
+    auto bytes = ktl::slice<u32>(a).as_bytes();
+    CHECK_EQ(bytes.size(), sizeof(a));
+    CHECK_EQ(bytes[4], 2);
+
+    auto writable = ktl::slice<u32>(a).as_writable_bytes();
+    writable[8] = 9;
+    CHECK_EQ(a[2], 9u);
+}
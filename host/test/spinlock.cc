@@ -0,0 +1,132 @@
+#include <ktl/spinlock>
+
+#include "test.hh"
+
+// Each lock guards a plain counter bumped with a non-atomic read-modify-
+// write; any overlap between two holders shows up as a lost increment.
+// Handing a FIFO lock to a thread the host has descheduled costs a time
+// slice, so a single CPU gets far fewer rounds.
+
+namespace {
+
+constexpr int kThreads = 4;
+
+u64 rounds() {
+    return hosttest::cpuCount() > 1 ? 20'000 : 200;
+}
+
+template<typename Lock>
+struct Shared {
+    Lock lock;
+    u64  counter = 0;
+    u64  rounds  = 0;
+};
+
+template<typename Lock>
+void hammer(int, void* ctx) {
+    auto& s = *static_cast<Shared<Lock>*>(ctx);
+    for (u64 i = 0; i < s.rounds; ++i) {
+        ktl::AutoLock<Lock> guard(s.lock);
+        const u64 v = __atomic_load_n(&s.counter, __ATOMIC_RELAXED);
+        __atomic_store_n(&s.counter, v + 1, __ATOMIC_RELAXED);
+    }
+}
+
+template<typename Lock>
+u64 hammered() {
+    Shared<Lock> s;
+    s.rounds = rounds();
+    hosttest::runThreads(kThreads, hammer<Lock>, &s);
+    CHECK(!s.lock.is_locked());
+    return s.counter;
+}
+
+} // namespace
+
+HOST_TEST(spinlock_ticket_excludes) {
+    CHECK_EQ(hammered<ktl::TicketLock>(), kThreads * rounds());
+}
+
+HOST_TEST(spinlock_mcs_excludes) {
+    CHECK_EQ(hammered<ktl::McsLock>(), kThreads * rounds());
+}
+
+HOST_TEST(spinlock_ticket_try_lock) {
+    ktl::SpinLock lock;
+    CHECK(!lock.is_locked());
+    CHECK(lock.try_lock());
+    CHECK(lock.is_locked());
+    CHECK(!lock.try_lock());
+    lock.unlock();
+    CHECK(!lock.is_locked());
+
+    // The u16 tickets wrap around.
+    for (u32 i = 0; i < 70'000; ++i) {
+        lock.lock();
+        lock.unlock();
+    }
+    CHECK(lock.try_lock());
+    lock.unlock();
+}
+
+HOST_TEST(spinlock_mcs_try_lock) {
+    ktl::McsLock lock;
+    ktl::McsLock::Node a;
+    ktl::McsLock::Node b;
+    CHECK(lock.try_lock(a));
+    CHECK(!lock.try_lock(b));
+    lock.unlock(a);
+    CHECK(lock.try_lock(b));
+    lock.unlock(b);
+    CHECK(!lock.is_locked());
+}
+
+HOST_TEST(spinlock_rw_shared_and_exclusive) {
+    ktl::rw_spinlock lock;
+    CHECK(lock.try_lock_shared());
+    CHECK(lock.try_lock_shared());
+    CHECK(!lock.try_lock());
+    lock.unlock_shared();
+    lock.unlock_shared();
+    CHECK(lock.try_lock());
+    CHECK(!lock.try_lock_shared());
+    lock.unlock();
+    CHECK(lock.try_lock_shared());
+    lock.unlock_shared();
+}
+
+namespace {
+
+struct RwShared {
+    ktl::rw_spinlock lock;
+    u64              a      = 0;
+    u64              b      = 0;
+    u64              torn   = 0;
+    u64              rounds = 0;
+};
+
+} // namespace
+
+// Writers keep a == b; a reader holding the lock shared must never see
+// them differ.
+HOST_TEST(spinlock_rw_readers_see_whole_writes) {
+    RwShared s;
+    s.rounds = rounds();
+    hosttest::runThreads(kThreads, [](int index, void* ctx) {
+        auto& s = *static_cast<RwShared*>(ctx);
+        for (u64 i = 0; i < s.rounds; ++i) {
+            if (index == 0) {
+                ktl::AutoLock<ktl::rw_spinlock> guard(s.lock);
+                __atomic_store_n(&s.a, s.a + 1, __ATOMIC_RELAXED);
+                __atomic_store_n(&s.b, s.b + 1, __ATOMIC_RELAXED);
+            } else {
+                ktl::SharedAutoLock<ktl::rw_spinlock> guard(s.lock);
+                if (__atomic_load_n(&s.a, __ATOMIC_RELAXED) != __atomic_load_n(&s.b, __ATOMIC_RELAXED)) {
+                    __atomic_add_fetch(&s.torn, 1, __ATOMIC_RELAXED);
+                }
+            }
+        }
+    }, &s);
+    CHECK_EQ(s.torn, 0u);
+    CHECK_EQ(s.a, s.rounds);
+}
@@ -0,0 +1,138 @@
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <kstring.h>
+
+#include "test.hh"
+
+// The kernel's util/string.c (as kstr_*) against the host C library.
+
+HOST_TEST(string_copy_and_move) {
+    char src[300];
+    char dst[300];
+    char ref[300];
+    for (usize i = 0; i < sizeof(src); ++i) {
+        src[i] = static_cast<char>(i * 7 + 1);
+    }
+    const usize sizes[] = { 0, 1, 7, 8, 9, 63, 64, 65, 255, 256, 299 };
+    for (usize n : sizes) {
+        memset(dst, 0x5a, sizeof(dst));
+        CHECK_EQ(kstr_memcpy(dst, src, n), static_cast<void*>(dst));
+        CHECK(memcmp(dst, src, n) == 0);
+        CHECK(n == sizeof(dst) || dst[n] == 0x5a);
+    }
+
+    // Overlapping both ways.
+    const usize shifts[] = { 1, 3, 8, 17 };
+    for (usize shift : shifts) {
+        memcpy(dst, src, sizeof(src));
+        memcpy(ref, src, sizeof(src));
+        kstr_memmove(dst + shift, dst, 200);
+        memmove(ref + shift, ref, 200);
+        CHECK(memcmp(dst, ref, sizeof(dst)) == 0);
+
+        kstr_memmove(dst, dst + shift, 200);
+        memmove(ref, ref + shift, 200);
+        CHECK(memcmp(dst, ref, sizeof(dst)) == 0);
+    }
+}
+
+HOST_TEST(string_set_and_compare) {
+    unsigned char buf[300];
+    const usize sizes[] = { 0, 1, 15, 16, 17, 255, 299 };
+    for (usize n : sizes) {
+        memset(buf, 0, sizeof(buf));
+        CHECK_EQ(kstr_memset(buf, 0xab, n), static_cast<void*>(buf));
+        bool ok = true;
+        for (usize i = 0; i < sizeof(buf); ++i) {
+            ok &= buf[i] == (i < n ? 0xab : 0);
+        }
+        CHECK(ok);
+    }
+
+    const unsigned char a[] = { 1, 2, 3, 0x80 };
+    const unsigned char b[] = { 1, 2, 3, 0x01 };
+    CHECK(kstr_memcmp(a, b, 3) == 0);
+    CHECK(kstr_memcmp(a, b, 4) > 0);
+    CHECK(kstr_memcmp(b, a, 4) < 0);
+
+    CHECK(kstr_strncmp("abcdef", "abcxyz", 3) == 0);
+    CHECK(kstr_strncmp("abcdef", "abcxyz", 4) < 0);
+    CHECK(kstr_strncmp("abc", "abc", 10) == 0);
+    CHECK(kstr_strncmp("a", "b", 0) == 0);
+}
+
+HOST_TEST(string_str_copy_and_concat) {
+    char buf[32];
+    CHECK_EQ(kstr_strcpy(buf, "hello"), buf);
+    CHECK(strcmp(buf, "hello") == 0);
+    CHECK_EQ(kstr_strcat(buf, ", world"), buf);
+    CHECK(strcmp(buf, "hello, world") == 0);
+
+    memset(buf, 'x', sizeof(buf));
+    kstr_strncpy(buf, "ab", 5);
+    CHECK(memcmp(buf, "ab\0\0\0x", 6) == 0);
+
+    kstr_strcpy(buf, "ab");
+    kstr_strncat(buf, "cdef", 2);
+    CHECK(strcmp(buf, "abcd") == 0);
+}
+
+HOST_TEST(string_search) {
+    const char* s = "key=value; other=thing";
+    CHECK_EQ(kstr_strstr(s, "other"), strstr(s, "other"));
+    CHECK_EQ(kstr_strstr(s, "nothere"), static_cast<char*>(nullptr));
+    CHECK_EQ(kstr_strstr(s, ""), s);
+    CHECK_EQ(kstr_strrchr(s, '='), strrchr(s, '='));
+    CHECK_EQ(kstr_strrchr(s, '\0'), strrchr(s, '\0'));
+    CHECK_EQ(kstr_strpbrk(s, ";="), strpbrk(s, ";="));
+    CHECK_EQ(kstr_strspn(s, "abcdefghijklmnopqrstuvwxyz"), strspn(s, "abcdefghijklmnopqrstuvwxyz"));
+    CHECK_EQ(kstr_strcspn(s, ";"), strcspn(s, ";"));
+
+    char line[] = "root=/dev/sda1  quiet,,splash";
+    const char* tokens[] = { "root=/dev/sda1", "quiet", "splash" };
+    usize count = 0;
+    for (char* tok = kstr_strtok(line, " ,"); tok; tok = kstr_strtok(nullptr, " ,")) {
+        CHECK(count < 3 && strcmp(tok, tokens[count]) == 0);
+        ++count;
+    }
+    CHECK_EQ(count, 3u);
+}
+
+HOST_TEST(string_number_conversion) {
+    const char* inputs[] = { "0", "42", "-17", "  +99xyz", "0x1f", "0755", "9223372036854775807", "" };
+    for (const char* in : inputs) {
+        const int bases[] = { 0, 10, 16 };
+        for (int base : bases) {
+            char* kend = nullptr;
+            char* lend = nullptr;
+            CHECK_EQ(kstr_strtol(in, &kend, base), strtol(in, &lend, base));
+            CHECK_EQ(kend, lend);
+        }
+        CHECK_EQ(kstr_atoi(in), atoi(in));
+        CHECK_EQ(kstr_atoll(in), atoll(in));
+    }
+
+    char buf[72];
+    CHECK(strcmp(kstr_itoa(0, buf, 10), "0") == 0);
+    CHECK(strcmp(kstr_itoa(-1234, buf, 10), "-1234") == 0);
+    CHECK(strcmp(kstr_itoa(255, buf, 16), "ff") == 0);
+    CHECK(strcmp(kstr_ltoa(5, buf, 2), "101") == 0);
+    CHECK(strcmp(kstr_lltoa(1LL << 40, buf, 10), "1099511627776") == 0);
+}
+
+HOST_TEST(string_ctype) {
+    for (int c = 0; c < 128; ++c) {
+        CHECK_EQ(!!kstr_isalnum(c), !!isalnum(c));
+        CHECK_EQ(!!kstr_isalpha(c), !!isalpha(c));
+        CHECK_EQ(!!kstr_isdigit(c), !!isdigit(c));
+        CHECK_EQ(!!kstr_isxdigit(c), !!isxdigit(c));
+        CHECK_EQ(!!kstr_isspace(c), !!isspace(c));
+        CHECK_EQ(!!kstr_isupper(c), !!isupper(c));
+        CHECK_EQ(!!kstr_islower(c), !!islower(c));
+        CHECK_EQ(!!kstr_isprint(c), !!isprint(c));
+        CHECK_EQ(!!kstr_ispunct(c), !!ispunct(c));
+        CHECK_EQ(kstr_toupper(c), toupper(c));
+        CHECK_EQ(kstr_tolower(c), tolower(c));
+    }
+}
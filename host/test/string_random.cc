@@ -0,0 +1,203 @@
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <kstring.h>
+
+#include "test.hh"
+
+// Randomized comparisons of util/string.c against the host C library, and
+// guard-page checks for the word-at-a-time scanners: a string whose last
+// byte is the last byte before an inaccessible page must be scanned without
+// touching that page, at every alignment. A read past the end faults here
+// instead of silently returning the right answer.
+
+namespace {
+
+constexpr size_t kBufSize = 512;
+constexpr int    kRounds  = 20000;
+
+int sign(int v) {
+    return (v > 0) - (v < 0);
+}
+
+// Fills buf with bytes from a small alphabet, so that searches hit and
+// comparisons see long common prefixes. No NULs unless asked for.
+void fill(hosttest::Rng& rng, char* buf, size_t len, bool nuls) {
+    const char alphabet[] = "aab\x80\xff";
+    for (size_t i = 0; i < len; ++i) {
+        buf[i] = alphabet[rng.below(sizeof alphabet - 1)];
+        if (nuls && rng.below(32) == 0) {
+            buf[i] = '\0';
+        }
+    }
+}
+
+// A readable page followed by a PROT_NONE one.
+class GuardedPage {
+public:
+    GuardedPage() {
+        m_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        void* p = mmap(nullptr, 2 * m_size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        m_base = p == MAP_FAILED ? nullptr : static_cast<char*>(p);
+        if (m_base) {
+            mprotect(m_base + m_size, m_size, PROT_NONE);
+            memset(m_base, 'x', m_size);
+        }
+    }
+
+    ~GuardedPage() {
+        if (m_base) {
+            munmap(m_base, 2 * m_size);
+        }
+    }
+
+    bool ok() const { return m_base != nullptr; }
+
+    // Places `len` copies of c and a NUL so the NUL is the page's last byte.
+    char* stringAtEnd(size_t len, char c) {
+        char* s = m_base + m_size - len - 1;
+        memset(s, c, len);
+        s[len] = '\0';
+        return s;
+    }
+
+    // Places `len` bytes of c so the last one is the page's last byte.
+    char* bytesAtEnd(size_t len, char c) {
+        char* s = m_base + m_size - len;
+        memset(s, c, len);
+        return s;
+    }
+
+private:
+    char*  m_base = nullptr;
+    size_t m_size = 0;
+};
+
+} // namespace
+
+HOST_TEST(string_random_mem) {
+    hosttest::Rng rng(27);
+    char a[kBufSize];
+    char b[kBufSize];
+    char k[kBufSize];
+    char c[kBufSize];
+
+    for (int round = 0; round < kRounds; ++round) {
+        const size_t off = rng.below(64);
+        const size_t len = rng.below(kBufSize - 128);
+
+        fill(rng, a, sizeof a, true);
+        memcpy(b, a, sizeof b);
+        if (rng.below(2)) {
+            b[off + rng.below(len + 1)] ^= static_cast<char>(1 + rng.below(255));
+        }
+        CHECK_EQ(sign(kstr_memcmp(a + off, b + off, len)), sign(memcmp(a + off, b + off, len)));
+
+        const char needle = static_cast<char>(a[off + rng.below(len + 1)] + rng.below(2));
+        CHECK(kstr_memchr(a + off, needle, len) == memchr(a + off, needle, len));
+
+        memset(k, 0, sizeof k);
+        memset(c, 0, sizeof c);
+        kstr_memcpy(k + off, a, len);
+        memcpy(c + off, a, len);
+        CHECK(memcmp(k, c, sizeof k) == 0);
+
+        const int fill_byte = static_cast<int>(rng.below(256));
+        kstr_memset(k + off, fill_byte, len);
+        memset(c + off, fill_byte, len);
+        CHECK(memcmp(k, c, sizeof k) == 0);
+
+        // Overlapping moves in both directions.
+        const size_t dst = rng.below(128);
+        memcpy(k, a, sizeof k);
+        memcpy(c, a, sizeof c);
+        kstr_memmove(k + dst, k + off, len);
+        memmove(c + dst, c + off, len);
+        CHECK(memcmp(k, c, sizeof k) == 0);
+    }
+}
+
+HOST_TEST(string_random_str) {
+    hosttest::Rng rng(2701);
+    char a[kBufSize];
+    char b[kBufSize];
+
+    for (int round = 0; round < kRounds; ++round) {
+        const size_t off = rng.below(64);
+        fill(rng, a, sizeof a, true);
+        a[sizeof a - 1] = '\0';
+        memcpy(b, a, sizeof b);
+        if (rng.below(2)) {
+            b[off + rng.below(kBufSize - 65)] = static_cast<char>(rng.below(256));
+        }
+        const char* s = a + off;
+        const char* t = b + off;
+        const size_t n = rng.below(kBufSize);
+
+        CHECK_EQ(kstr_strlen(s), strlen(s));
+        CHECK_EQ(kstr_strnlen(s, n), strnlen(s, n));
+        CHECK_EQ(sign(kstr_strcmp(s, t)), sign(strcmp(s, t)));
+        CHECK_EQ(sign(kstr_strncmp(s, t, n)), sign(strncmp(s, t, n)));
+
+        const char c = "ab\x80\xffz"[rng.below(5)];
+        CHECK(kstr_strchr(s, c) == strchr(s, c));
+        CHECK(kstr_strrchr(s, c) == strrchr(s, c));
+        CHECK(kstr_strchr(s, '\0') == strchr(s, '\0'));
+
+        const char* const sets[] = { "a", "ab", "b\x80", "\xff", "z" };
+        const char* set = sets[rng.below(5)];
+        CHECK_EQ(kstr_strspn(s, set), strspn(s, set));
+        CHECK_EQ(kstr_strcspn(s, set), strcspn(s, set));
+        CHECK(kstr_strpbrk(s, set) == strpbrk(s, set));
+
+        char needle[8];
+        const size_t needle_len = rng.below(sizeof needle);
+        fill(rng, needle, needle_len, false);
+        needle[needle_len] = '\0';
+        CHECK(kstr_strstr(s, needle) == strstr(s, needle));
+    }
+}
+
+HOST_TEST(string_guard_page_scanners) {
+    GuardedPage page;
+    GuardedPage other;
+    CHECK(page.ok() && other.ok());
+    if (!page.ok() || !other.ok()) {
+        return;
+    }
+
+    // Lengths past a few words and across every alignment of the start.
+    for (size_t len = 0; len < 200; ++len) {
+        const char* s = page.stringAtEnd(len, 'a');
+        CHECK_EQ(kstr_strlen(s), len);
+        CHECK_EQ(kstr_strnlen(s, len + 100), len);
+        CHECK_EQ(kstr_strnlen(s, len), len);
+        CHECK(kstr_strchr(s, 'b') == nullptr);
+        CHECK(kstr_strchr(s, '\0') == s + len);
+        CHECK(kstr_strrchr(s, 'b') == nullptr);
+        CHECK(kstr_strrchr(s, 'a') == (len ? s + len - 1 : nullptr));
+
+        const char* t = other.stringAtEnd(len, 'a');
+        CHECK_EQ(kstr_strcmp(s, t), 0);
+        CHECK_EQ(kstr_strncmp(s, t, len + 100), 0);
+
+        const char* m = page.bytesAtEnd(len, 'a');
+        CHECK(kstr_memchr(m, 'b', len) == nullptr);
+        CHECK_EQ(kstr_memcmp(m, other.bytesAtEnd(len, 'a'), len), 0);
+        if (len) {
+            const_cast<char*>(m)[len - 1] = 'b';
+            CHECK(kstr_memchr(m, 'b', len) == m + len - 1);
+        }
+    }
+
+    // strcmp with only one side at the guard: the other string is longer.
+    for (size_t len = 0; len < 64; ++len) {
+        const char* s = page.stringAtEnd(len, 'a');
+        char longer[128];
+        memset(longer, 'a', len + 1);
+        longer[len + 1] = '\0';
+        CHECK(kstr_strcmp(s, longer) < 0);
+        CHECK(kstr_strcmp(longer, s) > 0);
+    }
+}
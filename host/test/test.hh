@@ -0,0 +1,132 @@
+#ifndef HOST_TEST_HH
+#define HOST_TEST_HH
+
+#include <ktl/type_traits>
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+
+// Minimal unit-test registry for the host build. A test body checks its
+// results with CHECK / CHECK_EQ; a failed check is reported with its
+// location and the test carries on, so one run shows every failure. The
+// driver in main.cc runs every test and exits non-zero if any check failed.
+
+namespace hosttest {
+
+struct Test {
+    const char* name;
+    void      (*fn)();
+    Test*       next;
+};
+
+inline Test* g_head = nullptr;
+inline Test* g_tail = nullptr;
+
+struct Registrar {
+    explicit Registrar(Test& t) {
+        if (g_tail) {
+            g_tail->next = &t;
+        } else {
+            g_head = &t;
+        }
+        g_tail = &t;
+    }
+};
+
+// Failed checks in the running test.
+inline u64 g_failures = 0;
+
+inline void fail(const char* expr, const char* file, int line) {
+    fprintf(stderr, "  check failed: %s\n    at %s:%d\n", expr, file, line);
+    ++g_failures;
+}
+
+template<typename A, typename B>
+inline void failEq(const char* a_expr, const char* b_expr, const A& a, const B& b,
+                   const char* file, int line) {
+    fprintf(stderr, "  check failed: %s == %s\n", a_expr, b_expr);
+    if constexpr (ktl::is_integral_v<A> && ktl::is_integral_v<B>) {
+        fprintf(stderr, "    %lld vs %lld\n", static_cast<long long>(a), static_cast<long long>(b));
+    } else if constexpr (ktl::is_pointer_v<A> && ktl::is_pointer_v<B>) {
+        fprintf(stderr, "    %p vs %p\n", static_cast<const void*>(a), static_cast<const void*>(b));
+    }
+    fprintf(stderr, "    at %s:%d\n", file, line);
+    ++g_failures;
+}
+
+// Deterministic pseudo-random numbers, so a failure reproduces.
+class Rng {
+public:
+    explicit Rng(u64 seed) : m_state(seed ? seed : 0x9e3779b97f4a7c15ULL) {}
+
+    u64 next() {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 7;
+        m_state ^= m_state << 17;
+        return m_state;
+    }
+
+    // Uniform enough in [0, bound).
+    u64 below(u64 bound) { return next() % bound; }
+
+private:
+    u64 m_state;
+};
+
+inline int cpuCount() {
+    return static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+}
+
+// Runs fn(index, ctx) on `count` threads and waits for all of them.
+inline void runThreads(int count, void (*fn)(int index, void* ctx), void* ctx) {
+    constexpr int kMaxThreads = 16;
+
+    struct Start {
+        void (*fn)(int, void*);
+        void*   ctx;
+        int     index;
+    };
+
+    Start     starts[kMaxThreads];
+    pthread_t threads[kMaxThreads];
+
+    auto entry = [](void* arg) -> void* {
+        auto* s = static_cast<Start*>(arg);
+        s->fn(s->index, s->ctx);
+        return nullptr;
+    };
+
+    for (int i = 0; i < count && i < kMaxThreads; ++i) {
+        starts[i] = { fn, ctx, i };
+        pthread_create(&threads[i], nullptr, entry, &starts[i]);
+    }
+    for (int i = 0; i < count && i < kMaxThreads; ++i) {
+        pthread_join(threads[i], nullptr);
+    }
+}
+
+} // namespace hosttest
+
+#define HOST_TEST(_name_)                                                     \
+    static void _name_##_body();                                              \
+    static ::hosttest::Test _name_##_test { #_name_, _name_##_body, nullptr }; \
+    static ::hosttest::Registrar _name_##_registrar { _name_##_test };        \
+    static void _name_##_body()
+
+#define CHECK(_cond_)                                                         \
+    do {                                                                      \
+        if (!(_cond_)) {                                                      \
+            ::hosttest::fail(#_cond_, __FILE__, __LINE__);                    \
+        }                                                                     \
+    } while (0)
+
+#define CHECK_EQ(_a_, _b_)                                                    \
+    do {                                                                      \
+        const auto& _check_a_ = (_a_);                                        \
+        const auto& _check_b_ = (_b_);                                        \
+        if (!(_check_a_ == _check_b_)) {                                      \
+            ::hosttest::failEq(#_a_, #_b_, _check_a_, _check_b_, __FILE__, __LINE__); \
+        }                                                                     \
+    } while (0)
+
+#endif // HOST_TEST_HH
@@ -0,0 +1,199 @@
+#include <ktl/timer_wheel>
+
+#include "test.hh"
+
+// ktl::timer_wheel under random insert/erase/advance sequences, checked
+// against a brute-force set of deadlines. A timer must come out of
+// pop_expired() exactly once, with now() at its deadline (or at the tick
+// it was inserted, if that deadline had already passed), and
+// next_expiry() must never be later than the earliest pending deadline.
+// Deadlines and clock jumps are spread over every wheel level so that
+// cascades run at every boundary.
+
+namespace {
+
+struct Timeout {
+    ktl::wheel_node node;
+    usize           id;
+};
+
+using Wheel = ktl::timer_wheel<Timeout, &Timeout::node>;
+
+constexpr usize kTimers = 512;
+
+struct Model {
+    bool pending[kTimers] = {};
+    u64  due[kTimers];
+    usize size = 0;
+
+    u64 earliest() const {
+        u64 best = Wheel::kNever;
+        for (usize i = 0; i < kTimers; ++i) {
+            if (pending[i] && due[i] < best) {
+                best = due[i];
+            }
+        }
+        return best;
+    }
+};
+
+// A distance drawn evenly over the levels, occasionally past the wheel's
+// reach.
+u64 randomDelta(hosttest::Rng& rng) {
+    const u64 level = rng.below(Wheel::kLevels + 1);
+    if (level == Wheel::kLevels) {
+        return rng.below(8) ? rng.below(Wheel::kMaxDelta + 1) : Wheel::kMaxDelta + 1 + rng.below(1 << 20);
+    }
+    return rng.below(1ULL << (level * Wheel::kSlotBits + Wheel::kSlotBits));
+}
+
+// Pops everything due by tick; every timer must come out at its due tick.
+bool advance(Wheel& wheel, Model& m, Timeout* timers, u64 tick) {
+    const u64 start = wheel.now();
+    u64 last = start;
+    while (Timeout* t = wheel.pop_expired(tick)) {
+        const usize id = t->id;
+        if (id >= kTimers || !m.pending[id] || t->node.is_linked()) {
+            return false;
+        }
+        if (wheel.now() != m.due[id] || wheel.now() < last || &timers[id] != t) {
+            return false;
+        }
+        last = wheel.now();
+        m.pending[id] = false;
+        --m.size;
+    }
+    if (wheel.now() != (tick > start ? tick : start)) {
+        return false;
+    }
+    // Nothing left that was due by now.
+    return m.earliest() > wheel.now() || m.earliest() == Wheel::kNever;
+}
+
+bool matches(const Wheel& wheel, const Model& m, Timeout* timers) {
+    if (wheel.size() != m.size || wheel.empty() != (m.size == 0)) {
+        return false;
+    }
+    for (usize i = 0; i < kTimers; ++i) {
+        if (timers[i].node.is_linked() != m.pending[i]) {
+            return false;
+        }
+    }
+    const u64 next = wheel.next_expiry();
+    if (m.size == 0) {
+        return next == Wheel::kNever;
+    }
+    return next >= wheel.now() && next <= m.earliest();
+}
+
+void randomOps(u64 seed) {
+    hosttest::Rng rng(seed);
+    static Timeout timers[kTimers];
+    for (usize i = 0; i < kTimers; ++i) {
+        timers[i].id = i;
+    }
+    Wheel wheel;
+    Model m;
+    // Start away from zero so the first cascades are not all aligned.
+    wheel.forward(rng.below(1ULL << 30));
+
+    for (usize step = 0; step < 20'000; ++step) {
+        const usize id = rng.below(kTimers);
+        bool ok = true;
+        switch (rng.below(6)) {
+        case 0:
+        case 1:
+        case 2:
+            if (!m.pending[id]) {
+                // Now and then a deadline that has already passed.
+                const u64 now = wheel.now();
+                u64 tick;
+                if (rng.below(16) == 0) {
+                    tick = now - rng.below(now < 100 ? now + 1 : 100);
+                } else {
+                    tick = now + randomDelta(rng);
+                }
+                wheel.insert(timers[id], tick);
+                m.pending[id] = true;
+                m.due[id]     = tick < now ? now : tick;
+                if (m.due[id] - now > Wheel::kMaxDelta) {
+                    m.due[id] = now + Wheel::kMaxDelta;
+                }
+                ++m.size;
+                ok &= timers[id].node.expires == m.due[id] || tick < now;
+            }
+            break;
+        case 3:
+            if (m.pending[id]) {
+                wheel.erase(timers[id]);
+                m.pending[id] = false;
+                --m.size;
+            }
+            break;
+        case 4:
+            // Small steps, so single ticks and bucket edges get exercised.
+            ok &= advance(wheel, m, timers, wheel.now() + rng.below(80));
+            break;
+        case 5:
+            if (rng.below(4) == 0) {
+                // Straight to the next event, or a little short of it.
+                const u64 next = wheel.next_expiry();
+                if (next != Wheel::kNever) {
+                    ok &= advance(wheel, m, timers, next - (next > wheel.now() ? rng.below(2) : 0));
+                }
+            } else {
+                ok &= advance(wheel, m, timers, wheel.now() + randomDelta(rng));
+            }
+            break;
+        }
+        ok &= matches(wheel, m, timers);
+        if (!ok) {
+            CHECK(ok);
+            fprintf(stderr, "    seed %llu, step %zu\n", static_cast<unsigned long long>(seed), step);
+            break;
+        }
+    }
+
+    CHECK(advance(wheel, m, timers, Wheel::kNever - 1));
+    CHECK(wheel.empty());
+    // After a failure, unlink what is left so the next seed starts clean.
+    for (usize i = 0; i < kTimers; ++i) {
+        if (timers[i].node.is_linked()) {
+            wheel.erase(timers[i]);
+        }
+    }
+}
+
+} // namespace
+
+HOST_TEST(timer_wheel_random_ops) {
+    for (u64 seed = 1; seed <= 8; ++seed) {
+        randomOps(seed);
+    }
+}
+
+HOST_TEST(timer_wheel_clamps_and_forwards) {
+    Timeout far {};
+    Timeout soon {};
+    Wheel wheel;
+
+    wheel.forward(1000);
+    CHECK_EQ(wheel.now(), 1000u);
+    wheel.insert(far, 1000 + Wheel::kMaxDelta + 12345);
+    CHECK_EQ(far.node.expires, 1000 + Wheel::kMaxDelta);
+    CHECK(wheel.next_expiry() <= far.node.expires);
+
+    // Not idle: forward() leaves the clock alone.
+    wheel.forward(5000);
+    CHECK_EQ(wheel.now(), 1000u);
+
+    wheel.insert(soon, 1001);
+    CHECK(wheel.pop_expired(1000) == nullptr);
+    CHECK(wheel.pop_expired(1001) == &soon);
+    CHECK(wheel.pop_expired(1000 + Wheel::kMaxDelta - 1) == nullptr);
+    CHECK(wheel.pop_expired(1000 + Wheel::kMaxDelta) == &far);
+    CHECK_EQ(wheel.now(), 1000 + Wheel::kMaxDelta);
+    CHECK(wheel.pop_expired(1000 + Wheel::kMaxDelta) == nullptr);
+    CHECK(wheel.empty());
+    CHECK_EQ(wheel.next_expiry(), Wheel::kNever);
+}
@@ -0,0 +1,497 @@
+#include <stdlib.h>
+#include <ktl/interval_tree>
+#include <ktl/radix_tree>
+#include <ktl/rbtree>
+
+#include "test.hh"
+
+// The ordered index structures under random operation sequences, against
+// brute-force models over plain arrays: the red-black tree with its
+// invariants checked after every step, the interval tree's overlap and
+// gap searches, and the radix tree across height changes.
+
+namespace {
+
+struct MallocAllocator {
+    static inline i64 s_live = 0;
+
+    void* allocate(usize bytes, usize align) noexcept {
+        void* p = aligned_alloc(align, (bytes + align - 1) & ~(align - 1));
+        if (p) {
+            ++s_live;
+        }
+        return p;
+    }
+
+    void deallocate(void* ptr, usize, usize) noexcept {
+        if (ptr) {
+            --s_live;
+            free(ptr);
+        }
+    }
+};
+
+constexpr usize kNodes = 256;
+
+struct Item {
+    u64          key;
+    u32          id;
+    ktl::rb_node link;
+};
+
+struct ItemKey {
+    static u64 key(const Item& i) { return i.key; }
+};
+
+using Tree = ktl::intrusive_rbtree<Item, &Item::link, ItemKey>;
+
+// Black height of the subtree at n, or -1 if it breaks an invariant:
+// red nodes with red children, unequal black heights, wrong parent
+// pointers or keys out of order.
+int checkSubtree(const Item* n, const Item* parent) {
+    if (!n) {
+        return 1;
+    }
+    const Item* l = Tree::left_of(*n);
+    const Item* r = Tree::right_of(*n);
+    if (Tree::parent_of(*n) != parent) {
+        return -1;
+    }
+    if (n->link.is_red() && ((l && l->link.is_red()) || (r && r->link.is_red()))) {
+        return -1;
+    }
+    if ((l && n->key < l->key) || (r && r->key < n->key)) {
+        return -1;
+    }
+    const int lh = checkSubtree(l, n);
+    const int rh = checkSubtree(r, n);
+    if (lh < 0 || rh < 0 || lh != rh) {
+        return -1;
+    }
+    return lh + (n->link.is_black() ? 1 : 0);
+}
+
+bool wellFormed(const Tree& tree) {
+    const Item* root = tree.root();
+    if (!root) {
+        return tree.size() == 0;
+    }
+    return root->link.is_black() && checkSubtree(root, nullptr) > 0;
+}
+
+// The ids in tree order; equal keys in insertion order.
+struct Order {
+    u32   ids[kNodes];
+    usize size = 0;
+
+    void insert(usize at, u32 id) {
+        for (usize i = size; i > at; --i) {
+            ids[i] = ids[i - 1];
+        }
+        ids[at] = id;
+        ++size;
+    }
+
+    void erase(u32 id) {
+        usize at = 0;
+        while (ids[at] != id) {
+            ++at;
+        }
+        for (; at + 1 < size; ++at) {
+            ids[at] = ids[at + 1];
+        }
+        --size;
+    }
+};
+
+} // namespace
+
+HOST_TEST(rbtree_random_ops) {
+    static Item items[kNodes];
+    for (u64 seed = 1; seed <= 16; ++seed) {
+        hosttest::Rng rng(seed);
+        Tree tree;
+        Order order;
+        for (u32 i = 0; i < kNodes; ++i) {
+            items[i] = {};
+            items[i].id = i;
+        }
+        // Few distinct keys, so there are plenty of equals.
+        const u64 key_space = seed % 2 ? 64 : 100'000;
+
+        for (usize step = 0; step < 4000; ++step) {
+            Item& it = items[rng.below(kNodes)];
+            bool ok = true;
+            if (!it.link.is_linked()) {
+                it.key = rng.below(key_space);
+                usize at = 0;
+                while (at < order.size && items[order.ids[at]].key <= it.key) {
+                    ++at;
+                }
+                if (rng.below(2)) {
+                    tree.insert(it);
+                    order.insert(at, it.id);
+                } else {
+                    Item* existing = tree.insert_unique(it);
+                    const bool dup = at > 0 && items[order.ids[at - 1]].key == it.key;
+                    ok &= (existing != nullptr) == dup;
+                    if (existing) {
+                        ok &= existing->key == it.key && !it.link.is_linked();
+                    } else {
+                        order.insert(at, it.id);
+                    }
+                }
+            } else {
+                tree.erase(it);
+                order.erase(it.id);
+                ok &= !it.link.is_linked();
+            }
+
+            ok &= tree.size() == order.size && wellFormed(tree);
+            usize i = 0;
+            for (Item& e : tree) {
+                ok &= i < order.size && e.id == order.ids[i];
+                ++i;
+            }
+            ok &= i == order.size;
+            if (order.size) {
+                ok &= tree.first()->id == order.ids[0] && tree.last()->id == order.ids[order.size - 1];
+                ok &= Tree::prev(*tree.first()) == nullptr && Tree::next(*tree.last()) == nullptr;
+            }
+
+            // Queries at a random key against a scan of the ordered ids.
+            const u64 q = rng.below(key_space + 1);
+            const Item* lower = nullptr;
+            const Item* upper = nullptr;
+            const Item* floor = nullptr;
+            for (usize j = 0; j < order.size; ++j) {
+                const Item* e = &items[order.ids[j]];
+                if (!lower && e->key >= q) lower = e;
+                if (!upper && e->key > q)  upper = e;
+                if (e->key <= q)           floor = e;
+            }
+            ok &= tree.lower_bound(q) == lower;
+            ok &= tree.upper_bound(q) == upper;
+            ok &= tree.floor(q) == floor;
+            const Item* found = tree.find(q);
+            ok &= (found != nullptr) == (lower && lower->key == q);
+            ok &= !found || found->key == q;
+
+            if (!ok) {
+                CHECK(ok);
+                fprintf(stderr, "    seed %llu, step %zu\n", static_cast<unsigned long long>(seed), step);
+                break;
+            }
+        }
+        tree.clear();
+    }
+}
+
+namespace {
+
+struct Range {
+    u64                 start;
+    u64                 end;
+    u32                 id;
+    bool                linked;
+    ktl::interval_node  node;
+};
+
+using Ranges = ktl::interval_tree<Range, &Range::node>;
+
+constexpr usize kRanges = 128;
+
+} // namespace
+
+HOST_TEST(interval_tree_random_overlaps) {
+    static Range ranges[kRanges];
+    for (u64 seed = 1; seed <= 16; ++seed) {
+        hosttest::Rng rng(seed);
+        Ranges tree;
+        for (u32 i = 0; i < kRanges; ++i) {
+            ranges[i] = {};
+            ranges[i].id = i;
+        }
+
+        for (usize step = 0; step < 3000; ++step) {
+            Range& r = ranges[rng.below(kRanges)];
+            if (!r.linked) {
+                r.start = rng.below(10'000);
+                r.end   = r.start + 1 + rng.below(rng.below(4) ? 100 : 3000);
+                tree.insert(r, r.start, r.end);
+                r.linked = true;
+            } else {
+                tree.erase(r);
+                r.linked = false;
+            }
+
+            // Every overlap of a random query, in start order, against a
+            // scan. Ranges with equal starts may come in any order, so
+            // compare the set and check the ordering separately.
+            const u64 qs = rng.below(11'000);
+            const u64 qe = qs + 1 + rng.below(rng.below(2) ? 50 : 2000);
+            bool expected[kRanges] = {};
+            usize expected_count = 0;
+            for (const Range& c : ranges) {
+                if (c.linked && c.start < qe && qs < c.end) {
+                    expected[c.id] = true;
+                    ++expected_count;
+                }
+            }
+
+            bool ok = true;
+            usize seen = 0;
+            u64 last_start = 0;
+            for (Range* o = tree.first_overlap(qs, qe); o; o = tree.next_overlap(*o, qs, qe)) {
+                ok &= expected[o->id] && o->start >= last_start && seen < kRanges;
+                expected[o->id] = false;
+                last_start = o->start;
+                if (++seen > kRanges) {
+                    break;
+                }
+            }
+            ok &= seen == expected_count;
+
+            // The range an address falls in: the overlap with the lowest start.
+            const u64 addr = rng.below(11'000);
+            const Range* containing = tree.find_containing(addr);
+            const Range* lowest = nullptr;
+            for (const Range& c : ranges) {
+                if (c.linked && c.start <= addr && addr < c.end && (!lowest || c.start < lowest->start)) {
+                    lowest = &c;
+                }
+            }
+            ok &= (containing == nullptr) == (lowest == nullptr);
+            ok &= !containing || (containing->start == lowest->start &&
+                                  containing->start <= addr && addr < containing->end);
+
+            if (!ok) {
+                CHECK(ok);
+                fprintf(stderr, "    seed %llu, step %zu\n", static_cast<unsigned long long>(seed), step);
+                break;
+            }
+        }
+    }
+}
+
+namespace {
+
+// Brute-force find_gap over disjoint ranges: try every aligned address
+// that starts at lo or right after some range.
+ktl::optional<u64> bruteGap(const Range* ranges, usize n, u64 size, u64 align, u64 lo, u64 hi) {
+    bool have = false;
+    u64 best = 0;
+    auto tryFrom = [&](u64 from) {
+        const u64 a = (from + align - 1) & ~(align - 1);
+        if (a < from || a < lo || a >= hi || hi - a < size) {
+            return;
+        }
+        for (usize i = 0; i < n; ++i) {
+            if (ranges[i].linked && ranges[i].start < a + size && a < ranges[i].end) {
+                return;
+            }
+        }
+        if (!have || a < best) {
+            have = true;
+            best = a;
+        }
+    };
+    tryFrom(lo);
+    for (usize i = 0; i < n; ++i) {
+        if (ranges[i].linked && ranges[i].end > lo) {
+            tryFrom(ranges[i].end);
+        }
+    }
+    if (!have) {
+        return ktl::nullopt;
+    }
+    return best;
+}
+
+} // namespace
+
+HOST_TEST(interval_tree_random_gaps) {
+    static Range ranges[kRanges];
+    for (u64 seed = 1; seed <= 16; ++seed) {
+        hosttest::Rng rng(seed);
+        Ranges tree;
+        for (u32 i = 0; i < kRanges; ++i) {
+            ranges[i] = {};
+            ranges[i].id = i;
+        }
+
+        for (usize step = 0; step < 2000; ++step) {
+            // Keep the ranges disjoint: slot i owns [i * 1024, (i + 1) * 1024).
+            Range& r = ranges[rng.below(kRanges)];
+            if (!r.linked) {
+                const u64 base = static_cast<u64>(r.id) * 1024;
+                r.start = base + rng.below(512);
+                r.end   = r.start + 1 + rng.below(512);
+                tree.insert(r, r.start, r.end);
+                r.linked = true;
+            } else {
+                tree.erase(r);
+                r.linked = false;
+            }
+
+            const u64 size  = 1 + rng.below(rng.below(4) ? 600 : 3000);
+            const u64 align = 1ULL << rng.below(11);
+            const u64 lo    = rng.below(kRanges * 1024);
+            const u64 hi    = lo + rng.below(kRanges * 1024);
+            const ktl::optional<u64> got  = tree.find_gap(size, align, lo, hi);
+            const ktl::optional<u64> want = bruteGap(ranges, kRanges, size, align, lo, hi);
+
+            bool ok = got.has_value() == want.has_value();
+            ok &= !got.has_value() || *got == *want;
+            if (!ok) {
+                CHECK(ok);
+                fprintf(stderr, "    seed %llu, step %zu: size %llu align %llu in [%llu, %llu)\n",
+                        static_cast<unsigned long long>(seed), step,
+                        static_cast<unsigned long long>(size), static_cast<unsigned long long>(align),
+                        static_cast<unsigned long long>(lo), static_cast<unsigned long long>(hi));
+                break;
+            }
+        }
+    }
+}
+
+namespace {
+
+constexpr usize kEntries = 512;
+
+struct Entry {
+    u64 index;
+};
+
+// Small and huge indices mixed, so the tree grows and shrinks in height.
+u64 randomIndex(hosttest::Rng& rng) {
+    switch (rng.below(4)) {
+    case 0:  return rng.below(64);
+    case 1:  return rng.below(1 << 20);
+    case 2:  return rng.next();
+    default: return ~0ULL - rng.below(4);
+    }
+}
+
+} // namespace
+
+HOST_TEST(radix_tree_random_ops) {
+    static Entry entries[kEntries];
+    for (u64 seed = 1; seed <= 8; ++seed) {
+        hosttest::Rng rng(seed);
+        {
+            ktl::radix_tree<Entry, MallocAllocator> tree;
+            // The model: entries[i] is stored under entries[i].index while
+            // stored[i] is set. Indices are distinct.
+            bool stored[kEntries] = {};
+            usize count = 0;
+
+            for (usize step = 0; step < 3000; ++step) {
+                const usize i = rng.below(kEntries);
+                bool ok = true;
+                if (!stored[i]) {
+                    u64 index;
+                    bool unique;
+                    do {
+                        index  = randomIndex(rng);
+                        unique = true;
+                        for (usize j = 0; j < kEntries; ++j) {
+                            unique &= !(stored[j] && entries[j].index == index);
+                        }
+                    } while (!unique);
+                    entries[i].index = index;
+                    ok &= tree.find(index) == nullptr;
+                    ok &= tree.store(index, &entries[i]);
+                    stored[i] = true;
+                    ++count;
+                } else if (rng.below(4) == 0) {
+                    // Replacing keeps the count.
+                    ok &= tree.store(entries[i].index, &entries[i]);
+                } else {
+                    ok &= tree.erase(entries[i].index) == &entries[i];
+                    ok &= tree.erase(entries[i].index) == nullptr;
+                    stored[i] = false;
+                    --count;
+                }
+                if (rng.below(16) == 0) {
+                    ktl::synchronize_rcu();
+                }
+
+                ok &= tree.size() == count && tree.empty() == (count == 0);
+
+                // find() of every stored entry and of a random index.
+                for (usize j = 0; j < kEntries; ++j) {
+                    if (stored[j]) {
+                        ok &= tree.find(entries[j].index) == &entries[j];
+                    }
+                }
+                const u64 probe = randomIndex(rng);
+                const Entry* want = nullptr;
+                const Entry* next = nullptr;
+                for (usize j = 0; j < kEntries; ++j) {
+                    if (!stored[j]) {
+                        continue;
+                    }
+                    if (entries[j].index == probe) {
+                        want = &entries[j];
+                    }
+                    if (entries[j].index >= probe && (!next || entries[j].index < next->index)) {
+                        next = &entries[j];
+                    }
+                }
+                ok &= tree.find(probe) == want;
+
+                u64 at = probe;
+                const Entry* got = tree.find_next(at);
+                ok &= got == next;
+                ok &= !got || at == got->index;
+
+                if (!ok) {
+                    CHECK(ok);
+                    fprintf(stderr, "    seed %llu, step %zu\n", static_cast<unsigned long long>(seed), step);
+                    break;
+                }
+            }
+
+            // A full walk with find_next visits every entry in index order.
+            usize walked = 0;
+            u64 prev = 0;
+            u64 at = 0;
+            while (const Entry* e = tree.find_next(at)) {
+                CHECK(walked == 0 || at > prev);
+                CHECK_EQ(e->index, at);
+                prev = at;
+                ++walked;
+                if (at == ~0ULL) {
+                    break;
+                }
+                ++at;
+            }
+            CHECK_EQ(walked, count);
+            ktl::synchronize_rcu();
+        }
+        CHECK_EQ(MallocAllocator::s_live, 0);
+    }
+}
+
+HOST_TEST(radix_tree_frees_nodes_after_grace_period) {
+    Entry e { 0 };
+    ktl::radix_tree<Entry, MallocAllocator> tree;
+    ktl::synchronize_rcu();
+    const i64 before = MallocAllocator::s_live;
+
+    CHECK(tree.store(1ULL << 40, &e));
+    const i64 grown = MallocAllocator::s_live;
+    CHECK(grown > before);
+
+    // Erasing the only entry empties every node on its path, but readers
+    // may still be walking them: they stay allocated until a grace period.
+    CHECK_EQ(tree.erase(1ULL << 40), &e);
+    CHECK(tree.empty());
+    CHECK_EQ(MallocAllocator::s_live, grown);
+    CHECK(ktl::rcu_pending());
+
+    ktl::synchronize_rcu();
+    CHECK_EQ(MallocAllocator::s_live, before);
+    CHECK(!ktl::rcu_pending());
+}
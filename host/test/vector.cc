@@ -0,0 +1,478 @@
+#include <stdlib.h>
+#include <ktl/list>
+#include <ktl/vector>
+
+#include "test.hh"
+
+// ktl::vector, small_vector and the intrusive lists under random operation
+// sequences, each checked after every step against a plain array that
+// applies the same operations.
+
+namespace {
+
+// malloc-backed, counting live blocks so a leak or double free shows up.
+struct CountingAllocator {
+    static inline i64 s_live = 0;
+
+    void* allocate(usize bytes, usize align) noexcept {
+        void* p = aligned_alloc(align, (bytes + align - 1) & ~(align - 1));
+        if (p) {
+            ++s_live;
+        }
+        return p;
+    }
+
+    void deallocate(void* ptr, usize, usize) noexcept {
+        if (ptr) {
+            --s_live;
+            free(ptr);
+        }
+    }
+};
+
+// Counts constructions against destructions.
+struct Tracked {
+    static inline i64 s_live = 0;
+
+    u64 value;
+
+    Tracked() : value(0) { ++s_live; }
+    explicit Tracked(u64 v) : value(v) { ++s_live; }
+    Tracked(const Tracked& other) : value(other.value) { ++s_live; }
+    Tracked(Tracked&& other) noexcept : value(other.value) { other.value = ~0ULL; ++s_live; }
+    Tracked& operator=(const Tracked& other) = default;
+    Tracked& operator=(Tracked&& other) noexcept {
+        value = other.value;
+        other.value = ~0ULL;
+        return *this;
+    }
+    ~Tracked() { --s_live; }
+};
+
+constexpr usize kModelCapacity = 512;
+
+struct Model {
+    u64   values[kModelCapacity];
+    usize size = 0;
+
+    void insert(usize at, u64 v) {
+        for (usize i = size; i > at; --i) {
+            values[i] = values[i - 1];
+        }
+        values[at] = v;
+        ++size;
+    }
+
+    void erase(usize at) {
+        for (usize i = at; i + 1 < size; ++i) {
+            values[i] = values[i + 1];
+        }
+        --size;
+    }
+};
+
+u64 valueOf(u64 v)            { return v; }
+u64 valueOf(const Tracked& t) { return t.value; }
+
+template<typename Vector>
+bool matches(const Vector& v, const Model& m) {
+    if (v.size() != m.size || v.capacity() < v.size()) {
+        return false;
+    }
+    for (usize i = 0; i < m.size; ++i) {
+        if (valueOf(v[i]) != m.values[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Runs `steps` random operations on v, mirrored on a model, and checks
+// them against each other after each one.
+template<typename Vector>
+void randomOps(Vector& v, u64 seed, usize steps) {
+    hosttest::Rng rng(seed);
+    Model m;
+    for (usize step = 0; step < steps; ++step) {
+        const u64 value = rng.next();
+        switch (rng.below(10)) {
+        case 0:
+        case 1:
+        case 2:
+            if (m.size < kModelCapacity) {
+                v.push_back(typename Vector::value_type(value));
+                m.values[m.size++] = value;
+            }
+            break;
+        case 3:
+            if (m.size) {
+                v.pop_back();
+                --m.size;
+            }
+            break;
+        case 4:
+            if (m.size < kModelCapacity) {
+                const usize at = rng.below(m.size + 1);
+                v.insert(v.begin() + at, typename Vector::value_type(value));
+                m.insert(at, value);
+            }
+            break;
+        case 5:
+            if (m.size) {
+                const usize at = rng.below(m.size);
+                v.erase(v.begin() + at);
+                m.erase(at);
+            }
+            break;
+        case 6:
+            if (m.size) {
+                const usize at = rng.below(m.size);
+                v.erase_unordered(v.begin() + at);
+                m.values[at] = m.values[m.size - 1];
+                --m.size;
+            }
+            break;
+        case 7: {
+            const usize n = rng.below(kModelCapacity / 2);
+            v.resize(n, typename Vector::value_type(value));
+            for (usize i = m.size; i < n; ++i) {
+                m.values[i] = value;
+            }
+            m.size = n;
+            break;
+        }
+        case 8:
+            v.shrink_to_fit();
+            break;
+        case 9:
+            if (rng.below(8) == 0) {
+                v.clear();
+                m.size = 0;
+            }
+            break;
+        }
+        if (!matches(v, m)) {
+            CHECK(matches(v, m));
+            fprintf(stderr, "    seed %llu, step %zu\n", static_cast<unsigned long long>(seed), step);
+            return;
+        }
+    }
+}
+
+} // namespace
+
+HOST_TEST(vector_random_ops) {
+    for (u64 seed = 1; seed <= 16; ++seed) {
+        ktl::vector<u64, CountingAllocator> v;
+        randomOps(v, seed, 2000);
+    }
+    CHECK_EQ(CountingAllocator::s_live, 0);
+}
+
+HOST_TEST(vector_random_ops_nontrivial) {
+    for (u64 seed = 1; seed <= 16; ++seed) {
+        ktl::vector<Tracked, CountingAllocator> v;
+        randomOps(v, seed, 2000);
+    }
+    CHECK_EQ(Tracked::s_live, 0);
+    CHECK_EQ(CountingAllocator::s_live, 0);
+}
+
+HOST_TEST(vector_copy_and_move) {
+    ktl::vector<Tracked, CountingAllocator> a;
+    for (u64 i = 0; i < 100; ++i) {
+        a.emplace_back(i);
+    }
+
+    ktl::vector<Tracked, CountingAllocator> b(a);
+    CHECK_EQ(b.size(), 100u);
+    CHECK(b.data() != a.data());
+    CHECK_EQ(b[99].value, 99u);
+
+    const Tracked* storage = a.data();
+    ktl::vector<Tracked, CountingAllocator> c(ktl::move(a));
+    CHECK_EQ(c.data(), storage);
+    CHECK(a.empty());
+
+    // emplace_back from an element of the vector itself, across a growth.
+    c.shrink_to_fit();
+    CHECK_EQ(c.capacity(), c.size());
+    c.push_back(c[0]);
+    CHECK_EQ(c.back().value, 0u);
+
+    b = c;
+    CHECK_EQ(b.size(), 101u);
+    c = ktl::move(b);
+    CHECK_EQ(c.size(), 101u);
+    CHECK(b.empty());
+}
+
+HOST_TEST(vector_try_push_back_on_exhausted_arena) {
+    alignas(16) u8 buffer[256];
+    ktl::arena arena(buffer, sizeof(buffer));
+    ktl::vector<u64, ktl::arena_allocator> v { ktl::arena_allocator(arena) };
+
+    usize pushed = 0;
+    while (v.try_push_back(pushed)) {
+        ++pushed;
+    }
+    CHECK(pushed > 0);
+    CHECK(pushed <= sizeof(buffer) / sizeof(u64));
+    CHECK_EQ(v.size(), pushed);
+    for (usize i = 0; i < pushed; ++i) {
+        CHECK_EQ(v[i], i);
+    }
+    CHECK(!v.try_reserve(sizeof(buffer)));
+    CHECK_EQ(v.size(), pushed);
+}
+
+HOST_TEST(small_vector_random_ops) {
+    for (u64 seed = 1; seed <= 16; ++seed) {
+        ktl::small_vector<Tracked, 8, CountingAllocator> v;
+        randomOps(v, seed, 2000);
+    }
+    CHECK_EQ(Tracked::s_live, 0);
+    CHECK_EQ(CountingAllocator::s_live, 0);
+}
+
+HOST_TEST(small_vector_inline_and_spill) {
+    ktl::small_vector<Tracked, 4, CountingAllocator> v;
+    for (u64 i = 0; i < 4; ++i) {
+        v.emplace_back(i);
+    }
+    CHECK(v.is_inline());
+    CHECK_EQ(CountingAllocator::s_live, 0);
+
+    v.emplace_back(4u);
+    CHECK(!v.is_inline());
+    CHECK_EQ(CountingAllocator::s_live, 1);
+
+    v.pop_back();
+    v.shrink_to_fit();
+    CHECK(v.is_inline());
+    CHECK_EQ(CountingAllocator::s_live, 0);
+
+    // Moving inline elements moves them one by one; the source is left empty.
+    ktl::small_vector<Tracked, 4, CountingAllocator> moved(ktl::move(v));
+    CHECK(moved.is_inline());
+    CHECK_EQ(moved.size(), 4u);
+    CHECK(v.empty());
+    for (u64 i = 0; i < 4; ++i) {
+        CHECK_EQ(moved[i].value, i);
+    }
+
+    ktl::small_vector<Tracked, 4, CountingAllocator> copy(moved);
+    CHECK(copy.is_inline());
+    u64 sum = 0;
+    for (const Tracked& t : copy) {
+        sum += t.value;
+    }
+    CHECK_EQ(sum, 0u + 1 + 2 + 3);
+}
+
+HOST_TEST(small_vector_fixed_capacity) {
+    ktl::small_vector<u64, 16> v;
+    for (u64 i = 0; i < 16; ++i) {
+        CHECK(v.try_push_back(i));
+    }
+    CHECK(!v.try_push_back(16u));
+    CHECK(!v.try_reserve(17));
+    CHECK_EQ(v.size(), 16u);
+    CHECK(v.is_inline());
+}
+
+namespace {
+
+struct Node {
+    u64              id;
+    ktl::list_node   link;
+    ktl::hlist_node  hlink;
+};
+
+using List  = ktl::intrusive_list<Node, &Node::link>;
+using HList = ktl::intrusive_hlist<Node, &Node::hlink>;
+
+constexpr usize kNodes = 64;
+
+bool listMatches(List& list, const Model& m) {
+    if (list.size() != m.size || list.empty() != (m.size == 0)) {
+        return false;
+    }
+    usize i = 0;
+    for (Node& n : list) {
+        if (i == m.size || n.id != m.values[i++]) {
+            return false;
+        }
+    }
+    if (i != m.size) {
+        return false;
+    }
+    // And backwards, through the prev links.
+    auto it = list.end();
+    for (usize j = m.size; j-- > 0;) {
+        --it;
+        if (it->id != m.values[j]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+usize indexOf(const Model& m, u64 id) {
+    for (usize i = 0; i < m.size; ++i) {
+        if (m.values[i] == id) {
+            return i;
+        }
+    }
+    return m.size;
+}
+
+} // namespace
+
+HOST_TEST(intrusive_list_random_ops) {
+    Node nodes[kNodes];
+    for (u64 seed = 1; seed <= 16; ++seed) {
+        hosttest::Rng rng(seed);
+        for (usize i = 0; i < kNodes; ++i) {
+            nodes[i].id   = i;
+            nodes[i].link = {};
+        }
+        List  list;
+        List  other;
+        Model m;
+        Model other_m;
+
+        for (usize step = 0; step < 4000; ++step) {
+            Node& n = nodes[rng.below(kNodes)];
+            switch (rng.below(8)) {
+            case 0:
+                if (!n.link.is_linked()) {
+                    list.push_back(n);
+                    m.values[m.size++] = n.id;
+                }
+                break;
+            case 1:
+                if (!n.link.is_linked()) {
+                    list.push_front(n);
+                    m.insert(0, n.id);
+                }
+                break;
+            case 2: {
+                Node* popped = list.pop_front();
+                CHECK_EQ(popped == nullptr, m.size == 0);
+                if (popped) {
+                    CHECK_EQ(popped->id, m.values[0]);
+                    CHECK(!popped->link.is_linked());
+                    m.erase(0);
+                }
+                break;
+            }
+            case 3: {
+                Node* popped = list.pop_back();
+                CHECK_EQ(popped == nullptr, m.size == 0);
+                if (popped) {
+                    CHECK_EQ(popped->id, m.values[m.size - 1]);
+                    --m.size;
+                }
+                break;
+            }
+            case 4: {
+                const usize at = indexOf(m, n.id);
+                if (at != m.size) {
+                    list.remove(n);
+                    m.erase(at);
+                }
+                break;
+            }
+            case 5:
+            case 6:
+                if (m.size && !n.link.is_linked()) {
+                    const usize at = rng.below(m.size);
+                    Node& pos = nodes[m.values[at]];
+                    if (rng.below(2)) {
+                        list.insert_before(pos, n);
+                        m.insert(at, n.id);
+                    } else {
+                        list.insert_after(pos, n);
+                        m.insert(at + 1, n.id);
+                    }
+                }
+                break;
+            case 7:
+                // Park a node on a second list now and then, and splice
+                // the whole of it back.
+                if (!n.link.is_linked() && rng.below(2)) {
+                    other.push_back(n);
+                    other_m.values[other_m.size++] = n.id;
+                } else if (rng.below(4) == 0) {
+                    list.splice_back(other);
+                    for (usize i = 0; i < other_m.size; ++i) {
+                        m.values[m.size++] = other_m.values[i];
+                    }
+                    other_m.size = 0;
+                    CHECK(other.empty());
+                }
+                break;
+            }
+            if (!listMatches(list, m) || !listMatches(other, other_m)) {
+                CHECK(listMatches(list, m));
+                CHECK(listMatches(other, other_m));
+                fprintf(stderr, "    seed %llu, step %zu\n", static_cast<unsigned long long>(seed), step);
+                break;
+            }
+        }
+        list.clear();
+        other.clear();
+        for (const Node& n : nodes) {
+            CHECK(!n.link.is_linked());
+        }
+    }
+}
+
+HOST_TEST(intrusive_hlist_random_ops) {
+    Node nodes[kNodes];
+    hosttest::Rng rng(7);
+    for (usize i = 0; i < kNodes; ++i) {
+        nodes[i].id = i;
+    }
+
+    // Several buckets; a node removes itself without naming its bucket.
+    constexpr usize kBuckets = 4;
+    HList buckets[kBuckets];
+    Model models[kBuckets];
+
+    for (usize step = 0; step < 4000; ++step) {
+        Node& n = nodes[rng.below(kNodes)];
+        if (!n.hlink.is_linked()) {
+            const usize b = rng.below(kBuckets);
+            buckets[b].push_front(n);
+            models[b].insert(0, n.id);
+        } else {
+            for (usize b = 0; b < kBuckets; ++b) {
+                const usize at = indexOf(models[b], n.id);
+                if (at != models[b].size) {
+                    models[b].erase(at);
+                }
+            }
+            HList::remove(n);
+            CHECK(!n.hlink.is_linked());
+        }
+
+        for (usize b = 0; b < kBuckets; ++b) {
+            usize i = 0;
+            bool ok = true;
+            for (Node& e : buckets[b]) {
+                ok &= i < models[b].size && e.id == models[b].values[i];
+                ++i;
+            }
+            ok &= i == models[b].size;
+            ok &= buckets[b].empty() == (models[b].size == 0);
+            ok &= buckets[b].empty() || buckets[b].front()->id == models[b].values[0];
+            if (!ok) {
+                CHECK(ok);
+                fprintf(stderr, "    bucket %zu, step %zu\n", b, step);
+                return;
+            }
+        }
+    }
+}
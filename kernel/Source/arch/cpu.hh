@@ -0,0 +1,16 @@
+#ifndef CPU_HH
+#define CPU_HH
+
+#include <arch/percpu.hh>
+
+class Cpu {
+public:
+    static constexpr u32 kBootCpu = 0;
+
+    // Index of the executing CPU, below kMaxCpus; one gs-relative load.
+    static u32 currentId() {
+        return this_cpu_read(PerCpu::s_cpu_number);
+    }
+};
+
+#endif // CPU_HH
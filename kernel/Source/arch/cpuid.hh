@@ -0,0 +1,60 @@
+#ifndef CPUID_HH
+#define CPUID_HH
+
+class Cpuid {
+public:
+    struct Leaf {
+        u32 eax;
+        u32 ebx;
+        u32 ecx;
+        u32 edx;
+    };
+
+    static Leaf query(u32 leaf, u32 subleaf = 0) {
+        Leaf r;
+        __asm__ volatile ("cpuid"
+                          : "=a"(r.eax), "=b"(r.ebx), "=c"(r.ecx), "=d"(r.edx)
+                          : "a"(leaf), "c"(subleaf));
+        return r;
+    }
+
+    static u32 maxLeaf() {
+        return query(0).eax;
+    }
+
+    static u32 maxExtendedLeaf() {
+        return query(0x8000'0000).eax;
+    }
+
+    static bool hasSse2()     { return bit(1, 0, &Leaf::edx, 26); }
+    static bool hasMonitor()  { return bit(1, 0, &Leaf::ecx, 3); }
+    static bool hasPopcnt()   { return bit(1, 0, &Leaf::ecx, 23); }
+    static bool hasXsave()    { return bit(1, 0, &Leaf::ecx, 26); }
+    static bool hasAvx()      { return bit(1, 0, &Leaf::ecx, 28); }
+    static bool hasAvx2()     { return bit(7, 0, &Leaf::ebx, 5); }
+    static bool hasErms()     { return bit(7, 0, &Leaf::ebx, 9); }
+    static bool hasFsrm()     { return bit(7, 0, &Leaf::edx, 4); }
+    static bool hasXsaveopt() { return bit(0xD, 1, &Leaf::eax, 0); }
+    static bool hasXsavec()   { return bit(0xD, 1, &Leaf::eax, 1); }
+    static bool hasLzcnt()    { return bit(0x8000'0001, 0, &Leaf::ecx, 5); }
+
+    // The TSC ticks at a constant rate through P- and C-state changes.
+    static bool hasInvariantTsc() { return bit(0x8000'0007, 0, &Leaf::edx, 8); }
+
+    // The LAPIC timer can fire at an absolute TSC value.
+    static bool hasTscDeadline() { return bit(1, 0, &Leaf::ecx, 24); }
+
+    // mwait with ECX bit 0 set wakes on interrupts even with IF clear.
+    static bool hasMwaitIrqBreak() { return bit(5, 0, &Leaf::ecx, 1); }
+
+private:
+    static bool bit(u32 leaf, u32 subleaf, u32 Leaf::* reg, u32 n) {
+        const u32 max = (leaf & 0x8000'0000) ? maxExtendedLeaf() : maxLeaf();
+        if (leaf > max) {
+            return false;
+        }
+        return (query(leaf, subleaf).*reg >> n) & 1;
+    }
+};
+
+#endif // CPUID_HH
@@ -0,0 +1,12 @@
+#include <arch/fpu.hh>
+
+PER_CPU u32  Fpu::s_depth       = 0;
+PER_CPU u64  Fpu::s_saved_flags = 0;
+PER_CPU bool Fpu::s_saved_ts    = false;
+PER_CPU bool Fpu::s_ts          = false;
+
+PER_CPU FpuState* Fpu::s_owner          = nullptr;
+PER_CPU FpuState* Fpu::s_active         = nullptr;
+PER_CPU u64       Fpu::s_lazy_restores = 0;
+
+PER_CPU_ALIGNED u8 Fpu::s_kernel_area[Fpu::kAreaMax] = {};
@@ -0,0 +1,375 @@
+#ifndef FPU_HH
+#define FPU_HH
+
+#include <arch/io.hh>
+#include <arch/cpuid.hh>
+#include <arch/idt.hh>
+#include <arch/percpu.hh>
+#include <core/format.hh>
+
+// The kernel is built with -mno-sse -mno-80387, so compiled code never
+// touches the x87/SSE/AVX register file on its own. Code that wants vector
+// registers (see arch/simd.hh) must run between kernel_fpu_begin() and
+// kernel_fpu_end(), which preserve whatever extended state was live.
+//
+// Threads (core/sched.hh) may also keep state in the vector registers
+// across preemption; each owns an FpuState the scheduler hands to
+// switchState(). Under the lazy policy a switch only sets CR0.TS, and the
+// first vector instruction the next thread runs traps with #NM, which
+// loads its state. A thread that never uses the registers never pays for
+// them, and one that comes back to a CPU whose registers still hold its
+// state (nobody else trapped there meanwhile) gets them back without a
+// restore. The eager policy saves and restores on every switch.
+struct FpuState {
+    static constexpr u32 kNoCpu = ~0u;
+
+    // areaSize() bytes, 64-byte aligned; owned by the thread.
+    u8* area = nullptr;
+    // CPU whose registers last held this state.
+    u32 cpu = kNoCpu;
+    // area holds saved state; until then the thread starts from the state
+    // the boot CPU had after fninit.
+    bool saved = false;
+};
+
+class Fpu {
+public:
+    enum class SaveMode : u8 {
+        Fxsave,
+        Xsave,
+        Xsaveopt,
+        Xsavec,
+    };
+
+    enum class Policy : u8 {
+        Eager,
+        Lazy,
+    };
+
+    static constexpr u64 XCR0_X87 = 1ULL << 0;
+    static constexpr u64 XCR0_SSE = 1ULL << 1;
+    static constexpr u64 XCR0_AVX = 1ULL << 2;
+
+    static constexpr usize kAreaMax = 4096;
+
+    static constexpr u8  kDeviceNotAvailable = 7;
+    static constexpr u32 kDefaultMxcsr       = 0x1F80;
+
+    static void init() {
+        enableControlBits();
+
+        if (Cpuid::hasXsave()) {
+            u64 xcr0 = XCR0_X87 | XCR0_SSE;
+            if (Cpuid::hasAvx()) {
+                xcr0 |= XCR0_AVX;
+            }
+            xsetbv(0, xcr0);
+            s_xcr0 = xcr0;
+
+            // Leaf 0xD reports area sizes for the features currently
+            // enabled in XCR0, so query it after xsetbv: EBX of subleaf 0
+            // for the standard layout, of subleaf 1 for the compacted one.
+            // xsaveopt skips components unchanged since the last xrstor,
+            // which is most of them when a thread is switched out without
+            // having touched its registers, so it wins over xsavec's
+            // smaller area when both exist.
+            if (Cpuid::hasXsaveopt()) {
+                s_mode      = SaveMode::Xsaveopt;
+                s_area_size = Cpuid::query(0xD, 0).ebx;
+            } else if (Cpuid::hasXsavec()) {
+                s_mode      = SaveMode::Xsavec;
+                s_area_size = Cpuid::query(0xD, 1).ebx;
+            } else {
+                s_mode      = SaveMode::Xsave;
+                s_area_size = Cpuid::query(0xD, 0).ebx;
+            }
+        } else {
+            s_area_size = 512;
+            s_mode = SaveMode::Fxsave;
+        }
+
+        if (s_area_size > kAreaMax) {
+            InterruptDescriptorTable::kpanic(
+                nullptr,
+                "Fpu: extended state area of {} bytes exceeds {} byte buffer",
+                s_area_size, kAreaMax
+            );
+        }
+
+        resetRegisters();
+        save(s_init_area);
+
+        if constexpr (kDebugMode) {
+            Fmt::printf("FPU: mode={} xcr0={:#x} area={} bytes\n",
+                        modeName(), s_xcr0, s_area_size);
+        }
+    }
+
+    // Control registers and XCR0 are per CPU: application processors get
+    // the configuration the boot CPU chose in init(), without re-probing.
+    static void initAp() {
+        enableControlBits();
+        if (s_mode != SaveMode::Fxsave) {
+            xsetbv(0, s_xcr0);
+        }
+        resetRegisters();
+    }
+
+    // After the IDT is up: installs the #NM handler the lazy policy needs.
+    static void initThreads() {
+        InterruptDescriptorTable::registerHandler(kDeviceNotAvailable, deviceNotAvailable);
+    }
+
+    // Makes state the running thread's on the calling CPU, whose registers
+    // hold its live state: the idle thread taking over a CPU's boot context.
+    static void attach(FpuState* state, u32 cpu) {
+        state->cpu = cpu;
+        this_cpu_write(s_owner, state);
+        this_cpu_write(s_active, state);
+    }
+
+    // For a thread slot being reused.
+    static void reset(FpuState* state) {
+        state->cpu   = FpuState::kNoCpu;
+        state->saved = false;
+    }
+
+    // Called by the scheduler with interrupts disabled, on the CPU that is
+    // switching from prev to next.
+    static void switchState(FpuState* prev, FpuState* next, u32 cpu) {
+        // With TS clear the registers are prev's: it trapped, was switched
+        // in eagerly, or found them still valid.
+        if (!this_cpu_read(s_ts)) {
+            save(prev->area);
+            prev->saved = true;
+            prev->cpu   = cpu;
+            this_cpu_write(s_owner, prev);
+        }
+
+        this_cpu_write(s_active, next);
+        if (s_policy == Policy::Eager) {
+            setTs(false);
+            load(next, cpu);
+        } else if (this_cpu_read(s_owner) == next && next->cpu == cpu) {
+            setTs(false);
+        } else {
+            setTs(true);
+        }
+    }
+
+    // Takes effect at each CPU's next switch.
+    static void setPolicy(Policy policy) { s_policy = policy; }
+    static Policy policy()               { return s_policy; }
+
+    // #NM traps taken, i.e. lazy restores, over all CPUs.
+    static u64 lazyRestores() {
+        u64 total = 0;
+        for_each_online_cpu(cpu) {
+            total += __atomic_load_n(per_cpu_ptr(s_lazy_restores, cpu), __ATOMIC_RELAXED);
+        }
+        return total;
+    }
+
+    static void save(void* area) {
+        switch (s_mode) {
+        case SaveMode::Xsavec:
+            __asm__ volatile ("xsavec64 (%0)"
+                              : : "r"(area), "a"(u32(s_xcr0)), "d"(u32(s_xcr0 >> 32))
+                              : "memory");
+            break;
+        case SaveMode::Xsaveopt:
+            __asm__ volatile ("xsaveopt64 (%0)"
+                              : : "r"(area), "a"(u32(s_xcr0)), "d"(u32(s_xcr0 >> 32))
+                              : "memory");
+            break;
+        case SaveMode::Xsave:
+            __asm__ volatile ("xsave64 (%0)"
+                              : : "r"(area), "a"(u32(s_xcr0)), "d"(u32(s_xcr0 >> 32))
+                              : "memory");
+            break;
+        case SaveMode::Fxsave:
+            __asm__ volatile ("fxsave64 (%0)" : : "r"(area) : "memory");
+            break;
+        }
+    }
+
+    // xrstor reads the layout, standard or compacted, from the area's
+    // header.
+    static void restore(const void* area) {
+        if (s_mode == SaveMode::Fxsave) {
+            __asm__ volatile ("fxrstor64 (%0)" : : "r"(area) : "memory");
+        } else {
+            __asm__ volatile ("xrstor64 (%0)"
+                              : : "r"(area), "a"(u32(s_xcr0)), "d"(u32(s_xcr0 >> 32))
+                              : "memory");
+        }
+    }
+
+    // Interrupts stay off for the whole section so an interrupt handler can
+    // never observe half-clobbered vector registers. Sections nest; only the
+    // outermost one saves and restores. If TS is set, the registers' last
+    // owner has already saved them: the section skips the save and restore
+    // and leaves the registers to whoever traps next.
+    static void kernelBegin() {
+        const u64 flags = io::irqSave();
+        const u32 depth = this_cpu_read(s_depth);
+        this_cpu_write(s_depth, depth + 1);
+        if (depth == 0) {
+            this_cpu_write(s_saved_flags, flags);
+            const bool ts = this_cpu_read(s_ts);
+            this_cpu_write(s_saved_ts, ts);
+            if (ts) {
+                setTs(false);
+                this_cpu_write(s_owner, static_cast<FpuState*>(nullptr));
+            } else {
+                save(this_cpu(s_kernel_area));
+            }
+        }
+    }
+
+    static void kernelEnd() {
+        const u32 depth = this_cpu_read(s_depth) - 1;
+        this_cpu_write(s_depth, depth);
+        if (depth == 0) {
+            if (this_cpu_read(s_saved_ts)) {
+                setTs(true);
+            } else {
+                restore(this_cpu(s_kernel_area));
+            }
+            io::irqRestore(this_cpu_read(s_saved_flags));
+        }
+    }
+
+    static SaveMode mode()    { return s_mode; }
+    static usize areaSize()   { return s_area_size; }
+    static u64 xcr0()         { return s_xcr0; }
+
+    // Distance between per-thread areas carved from one buffer.
+    static usize areaStride() { return (s_area_size + 63) & ~usize(63); }
+
+    static const char* modeName() {
+        switch (s_mode) {
+        case SaveMode::Xsavec:   return "xsavec";
+        case SaveMode::Xsaveopt: return "xsaveopt";
+        case SaveMode::Xsave:    return "xsave";
+        case SaveMode::Fxsave:   return "fxsave";
+        }
+        return "?";
+    }
+
+private:
+    static constexpr u64 CR0_MP = 1ULL << 1;
+    static constexpr u64 CR0_EM = 1ULL << 2;
+    static constexpr u64 CR0_TS = 1ULL << 3;
+    static constexpr u64 CR0_NE = 1ULL << 5;
+
+    static constexpr u64 CR4_OSFXSR     = 1ULL << 9;
+    static constexpr u64 CR4_OSXMMEXCPT = 1ULL << 10;
+    static constexpr u64 CR4_OSXSAVE    = 1ULL << 18;
+
+    static void enableControlBits() {
+        u64 cr0 = io::cr::read<0>();
+        cr0 &= ~(CR0_EM | CR0_TS);
+        cr0 |= CR0_MP | CR0_NE;
+        io::cr::write<0>(cr0);
+
+        u64 cr4 = io::cr::read<4>();
+        cr4 |= CR4_OSFXSR | CR4_OSXMMEXCPT;
+        if (Cpuid::hasXsave()) {
+            cr4 |= CR4_OSXSAVE;
+        }
+        io::cr::write<4>(cr4);
+    }
+
+    // fninit leaves MXCSR alone, and the firmware's value is not ours to
+    // inherit.
+    static void resetRegisters() {
+        const u32 mxcsr = kDefaultMxcsr;
+        __asm__ volatile ("fninit \n\t"
+                          "ldmxcsr %0"
+                          : : "m"(mxcsr));
+    }
+
+    static void xsetbv(u32 reg, u64 value) {
+        __asm__ volatile ("xsetbv"
+                          : : "c"(reg), "a"(u32(value)), "d"(u32(value >> 32))
+                          : "memory");
+    }
+
+    // Writing CR0 serializes, so it is only touched when TS changes; clts
+    // is the cheap way back.
+    static void setTs(bool ts) {
+        if (this_cpu_read(s_ts) == ts) {
+            return;
+        }
+        if (ts) {
+            io::cr::write<0>(io::cr::read<0>() | CR0_TS);
+        } else {
+            __asm__ volatile ("clts" ::: "memory");
+        }
+        this_cpu_write(s_ts, ts);
+    }
+
+    static void load(FpuState* state, u32 cpu) {
+        restore(state->saved ? state->area : s_init_area);
+        state->cpu = cpu;
+        this_cpu_write(s_owner, state);
+    }
+
+    // #NM comes in through a trap gate with interrupts as the faulting code
+    // left them. A tick between clearing TS and the restore could switch
+    // threads and save this CPU's half-loaded registers over the previous
+    // owner's area, so the whole handler runs with interrupts off.
+    static void deviceNotAvailable(registers_ctx* ctx) {
+        const u64 flags = io::irqSave();
+        FpuState* const state = this_cpu_read(s_active);
+        if (state == nullptr || !this_cpu_read(s_ts)) {
+            InterruptDescriptorTable::kpanic(ctx, "Fpu: #NM outside a lazily switched thread");
+        }
+        setTs(false);
+        load(state, this_cpu_read(PerCpu::s_cpu_number));
+        this_cpu_inc(s_lazy_restores);
+        io::irqRestore(flags);
+    }
+
+    static inline SaveMode s_mode        = SaveMode::Fxsave;
+    static inline Policy   s_policy      = Policy::Lazy;
+    static inline usize    s_area_size   = 512;
+    static inline u64      s_xcr0        = 0;
+    // Per CPU, defined in arch/fpu.cc. Kernel sections are per CPU: one
+    // CPU's nesting depth and saved registers have nothing to do with
+    // another's.
+    PER_CPU static u32  s_depth;
+    PER_CPU static u64  s_saved_flags;
+    PER_CPU static bool s_saved_ts;
+
+    // Mirrors CR0.TS, which is slow to read.
+    PER_CPU static bool s_ts;
+    // The state the registers hold (if TS is clear, or once it is cleared),
+    // and the running thread's.
+    PER_CPU static FpuState* s_owner;
+    PER_CPU static FpuState* s_active;
+    PER_CPU static u64       s_lazy_restores;
+
+    PER_CPU_ALIGNED static u8 s_kernel_area[kAreaMax];
+    alignas(64) static inline u8 s_init_area[kAreaMax] = {};
+};
+
+inline void kernel_fpu_begin() {
+    Fpu::kernelBegin();
+}
+
+inline void kernel_fpu_end() {
+    Fpu::kernelEnd();
+}
+
+class KernelFpuGuard {
+public:
+    KernelFpuGuard() noexcept { kernel_fpu_begin(); }
+    ~KernelFpuGuard() noexcept { kernel_fpu_end(); }
+
+    KernelFpuGuard(const KernelFpuGuard&) = delete;
+    KernelFpuGuard& operator=(const KernelFpuGuard&) = delete;
+};
+
+#endif // FPU_HH
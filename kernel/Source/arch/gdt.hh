@@ -3,8 +3,13 @@
 
 #include <core/format.hh>
 #include <arch/serial.hh>
+#include <arch/cpu.hh>
 #include <ktl/string_view>
 
+// One GDT and TSS per CPU. The tables are identical apart from the TSS
+// descriptor, which points at that CPU's TSS. Each TSS has its own IST
+// stacks, so an NMI or double fault on one CPU never lands on a stack
+// another CPU is using.
 class GlobalDescriptorTable {
 public:
     enum Segment : u16 {
@@ -15,11 +20,44 @@ public:
         TSS         = 0x28,
     };
 
-    static void load() {
+    // IST slots (1-based, as the IDT gate encodes them).
+    enum Ist : u8 {
+        IST_NMI           = 1,
+        IST_DOUBLE_FAULT  = 2,
+        IST_MACHINE_CHECK = 3,
+    };
+
+    static constexpr usize kIstCount     = 3;
+    static constexpr usize kIstStackSize = 4096;
+
+    // Builds the tables for cpu and loads them on the calling CPU.
+    static void load(u32 cpu = Cpu::kBootCpu) {
+        // fs and gs are left alone: reloading gs would clear the base that
+        // PerCpu::load() set.
+        //
+        // Everything here depends on addresses, which would make it a
+        // dynamic initializer that nothing runs; fill it in at load time.
+        CpuTables& self = cpu_tables[cpu];
+        __builtin_memcpy(self.gdt.entries, kEntries, sizeof(kEntries));
+        setTssDescriptor(self.gdt, reinterpret_cast<u64>(&self.tss), sizeof(TSS64) - 1);
+
+        self.tss = {};
+        self.tss.io_map_base = sizeof(TSS64);
+        for (usize i = 0; i < kIstCount; ++i) {
+            self.tss.ists[i] = reinterpret_cast<u64>(ist_stacks[cpu][i] + kIstStackSize);
+        }
+
+        const GDTPointer gdt_ptr = {
+            .size = static_cast<u16>(sizeof(GDTFullTable) - 1),
+            .base = reinterpret_cast<u64>(&self.gdt),
+        };
+
         if constexpr (kDebugMode) {
-            Fmt::printf("Loading GDT @ {:#016x}, size={} bytes\n",
-                        gdt_ptr.base,
-                        static_cast<u32>(gdt_ptr.size));
+            if (cpu == Cpu::kBootCpu) {
+                Fmt::printf("Loading GDT @ {:#016x}, size={} bytes\n",
+                            gdt_ptr.base,
+                            static_cast<u32>(gdt_ptr.size));
+            }
         }
 
         __asm__ volatile (
@@ -27,8 +65,7 @@ public:
             "mov $0x10, %%ax \n\t"
             "mov %%ax, %%ds \n\t"
             "mov %%ax, %%es \n\t"
-            "mov %%ax, %%fs \n\t"
-            "mov %%ax, %%gs \n\t"
+            "mov %%ax, %%ss \n\t"
 
             "pushq $0x08 \n\t"
             "lea 1f(%%rip), %%rax \n\t"
@@ -44,14 +81,15 @@ public:
         );
     }
 
-    void set_rsp0(const u64 rsp0) {
+    // Both act on the calling CPU's TSS.
+    static void set_rsp0(const u64 rsp0) {
         if constexpr (kDebugMode) {
             FmtBase<SerialCOM2>::printf("GDT: setting TSS.rsp0 = {:#016x}\n", rsp0);
         }
-        tss_instance.rsp0 = rsp0;
+        cpu_tables[Cpu::currentId()].tss.rsp0 = rsp0;
     }
 
-    void set_ists(const u64 ists[7]) {
+    static void set_ists(const u64 ists[7]) {
         if constexpr (kDebugMode) {
             FmtBase<SerialCOM2>::print("GDT: setting TSS.ists = {");
             for (int i = 0; i < 7; ++i) {
@@ -63,7 +101,7 @@ public:
             FmtBase<SerialCOM2>::print("}\n");
         }
 
-        __builtin_memcpy(tss_instance.ists, ists, sizeof(u64) * 7);
+        __builtin_memcpy(cpu_tables[Cpu::currentId()].tss.ists, ists, sizeof(u64) * 7);
     }
 
 private:
@@ -80,7 +118,7 @@ private:
     struct [[gnu::packed]] GDTEntry64 {
         GDTEntry base;
         u32 base_upper;
-        u32 reserved = 0;
+        u32 reserved;
     };
 
     struct [[gnu::packed]] GDTPointer {
@@ -106,6 +144,11 @@ private:
     };
 #pragma pack(pop)
 
+    struct CpuTables {
+        GDTFullTable gdt;
+        TSS64 tss;
+    };
+
     static constexpr u8 ACCESS_PRESENT     = 0b10010000;
     static constexpr u8 ACCESS_PRIV_KERNEL = 0b00000000;
     static constexpr u8 ACCESS_PRIV_USER   = 0b01100000;
@@ -117,49 +160,34 @@ private:
     static constexpr u8 GRAN_32BIT = 0b01000000;
     static constexpr u8 GRAN_LONG  = 0b00100000;
 
-    inline static TSS64 tss_instance = {
-        .reserved0 = 0,
-        .rsp0 = 0,
-        .rsp1 = 0,
-        .rsp2 = 0,
-        .reserved1 = 0,
-        .ists = {0},
-        .reserved2 = 0,
-        .reserved3 = 0,
-        .io_map_base = sizeof(TSS64)
-    };
+    static constexpr GDTEntry kEntries[5] = {
+        { 0, 0, 0, 0, 0, 0 },
 
-    inline static GDTFullTable gdt_table = {
-        .entries = {
-            { 0, 0, 0, 0, 0, 0 },
-
-            { 0xFFFF, 0x0000, 0x00, 0x9A, 0xA0, 0x00 },
-
-            { 0xFFFF, 0x0000, 0x00, 0x92, 0xC0, 0x00 },
-
-            { 0xFFFF, 0x0000, 0x00, 0xFA, 0xA0, 0x00 },
-
-            { 0xFFFF, 0x0000, 0x00, 0xF2, 0xC0, 0x00 },
-        },
-        .tss_entry = {
-            .base = {
-                .limit_low = static_cast<u16>(sizeof(TSS64) - 1),
-                .base_low = static_cast<u16>((u64)&tss_instance & 0xFFFF),
-                .base_mid = static_cast<u8>(((u64)&tss_instance >> 16) & 0xFF),
-                .access = 0x89,
-                .granularity = static_cast<u8>((((u64)&tss_instance >> 16) & 0xF00) >> 8),
-                .base_high = static_cast<u8>(((u64)&tss_instance >> 24) & 0xFF)
-            },
-            .base_upper = static_cast<u32>(((u64)&tss_instance) >> 32),
-            .reserved = 0
-        }
-    };
+        { 0xFFFF, 0x0000, 0x00, 0x9A, 0xA0, 0x00 },
+
+        { 0xFFFF, 0x0000, 0x00, 0x92, 0xC0, 0x00 },
+
+        { 0xFFFF, 0x0000, 0x00, 0xFA, 0xA0, 0x00 },
 
-    inline static GDTPointer gdt_ptr = {
-        .size = static_cast<u16>(sizeof(gdt_table) - 1),
-        .base = reinterpret_cast<u64>(&gdt_table)
+        { 0xFFFF, 0x0000, 0x00, 0xF2, 0xC0, 0x00 },
     };
 
+    inline static CpuTables cpu_tables[kMaxCpus] = {};
+
+    alignas(16) inline static u8 ist_stacks[kMaxCpus][kIstCount][kIstStackSize] = {};
+
+    static void setTssDescriptor(GDTFullTable& gdt, u64 base, u32 limit) {
+        auto& e = gdt.tss_entry;
+        e.base.limit_low   = static_cast<u16>(limit & 0xFFFF);
+        e.base.base_low    = static_cast<u16>(base & 0xFFFF);
+        e.base.base_mid    = static_cast<u8>((base >> 16) & 0xFF);
+        e.base.access      = 0x89;
+        e.base.granularity = static_cast<u8>((limit >> 16) & 0x0F);
+        e.base.base_high   = static_cast<u8>((base >> 24) & 0xFF);
+        e.base_upper       = static_cast<u32>(base >> 32);
+        e.reserved         = 0;
+    }
+
 };
 
 #endif //GDT_HH
@@ -0,0 +1,15 @@
+// Entry point from common_stub in idt.S. Kept out of line so the stub has
+// a symbol to call, and so that interrupt exit can reach the scheduler.
+
+#include <arch/idt.hh>
+#include <core/sched.hh>
+
+extern "C" void interrupt_dispatch(registers_ctx* ctx) {
+    InterruptDescriptorTable::dispatch(ctx);
+
+    // Out of the handler and its read-side section. Code interrupted with
+    // interrupts disabled is never preempted: it may be the scheduler.
+    if (ctx->rflags & io::kFlagsIF) {
+        Scheduler::interruptExit();
+    }
+}
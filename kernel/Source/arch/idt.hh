@@ -4,26 +4,47 @@
 #include <core/format.hh>
 #include <arch/serial.hh>
 #include <arch/io.hh>
+#include <arch/qemu.hh>
+#include <arch/gdt.hh>
+#include <arch/smp.hh>
+#include <core/wait.hh>
+#include <ktl/clock>
+#include <ktl/function>
 #include <ktl/string_view>
+#include <ktl/rcu>
 
+// Stack layout built by common_stub in idt.S, lowest address first.
 struct [[gnu::packed]] registers_ctx {
-    u64 es, ds;
     u64 cr4, cr3, cr2, cr0;
-    u64 r15, r14, r13, r12, r11, r10, r9, r8;
-    u64 rax, rbx, rcx, rdx, rsi, rdi;
+    u64 es, ds;
     u64 rbp;
+    u64 rdi, rsi, rdx, rcx, rbx, rax;
+    u64 r8, r9, r10, r11, r12, r13, r14, r15;
     u64 interrupt_vector, error_code;
     u64 rip, cs, rflags, rsp, ss;
 };
 
+// Handlers may carry state (a device pointer, a counter) inline; anything
+// larger than kHandlerStateSize should be a pointer to the real object.
+inline constexpr usize kHandlerStateSize = 3 * sizeof(void*);
+
+using InterruptHandler = ktl::inplace_function<void(registers_ctx*), kHandlerStateSize>;
+
+struct InterruptHandlerTable {
+    InterruptHandler handlers[256];
+};
+
 extern "C" {
-    extern uintptr_t isr_stub_table[];  
-    extern void (*real_handler_table[])(registers_ctx*);
+    extern uintptr_t isr_stub_table[];
+    // Read on every interrupt; published with RCU.
+    extern InterruptHandlerTable* current_handler_table;
+    // Called by common_stub in idt.S.
+    void interrupt_dispatch(registers_ctx* ctx);
 }
 
 class InterruptDescriptorTable {
 public:
-    using Handler = void(*)(registers_ctx*);
+    using Handler = InterruptHandler;
 
     static constexpr u8 INTERRUPT_GATE = 0b1000'1110;
     static constexpr u8 TRAP_GATE      = 0b1000'1111;
@@ -41,6 +62,10 @@ public:
             (kIdtUseTrapGateForExceptions ? TRAP_GATE
                                           : INTERRUPT_GATE);
 
+        new (&handlerTables()[0]) InterruptHandlerTable();
+        new (&handlerTables()[1]) InterruptHandlerTable();
+        InterruptHandlerTable& table = handlerTables()[0];
+
         for (usize vec = 0; vec < 32; ++vec) {
             setGate(vec, isr_stub_table[vec], exceptionGate);
             if constexpr (kDebugMode) {
@@ -48,14 +73,15 @@ public:
                 FmtBase<SerialCOM2>::printf("{:#02x} -> default handler (exception)\n",
                                    static_cast<u32>(vec));
             }
-
-            if constexpr (!kIdtPanicOnException) {
-                real_handler_table[vec] = haltCatchFire;
-            } else {
-                real_handler_table[vec] = defaultInterruptHandler;
-            }
+            table.handlers[vec] = defaultHandler(vec);
         }
 
+        // These can arrive on top of a broken kernel stack, or in the middle
+        // of an interrupt entry; give them known-good per-CPU stacks.
+        idt_table[2].ist  = GlobalDescriptorTable::IST_NMI;
+        idt_table[8].ist  = GlobalDescriptorTable::IST_DOUBLE_FAULT;
+        idt_table[18].ist = GlobalDescriptorTable::IST_MACHINE_CHECK;
+
         for (usize vec = 32; vec < 256; ++vec) {
             setGate(vec, isr_stub_table[vec], INTERRUPT_GATE);
             if constexpr (kDebugMode) {
@@ -63,9 +89,10 @@ public:
                 FmtBase<SerialCOM2>::printf("{:#02x} -> default handler (interrupt)\n",
                                    static_cast<u32>(vec));
             }
-            real_handler_table[vec] = defaultInterruptHandler;
+            table.handlers[vec] = defaultHandler(vec);
         }
 
+        ktl::rcu_assign_pointer(current_handler_table, &table);
         load();
     }
 
@@ -86,10 +113,15 @@ public:
         #undef ANSI_BOLD
         #undef ANSI_RESET
 
+        // Seconds since boot, to line the panic up with earlier log output.
+        const u64 now_us = ktl::clock::now() / 1000;
+
+        Out::printf("[{}.{:06}] ", now_us / 1'000'000, now_us % 1'000'000);
         Out::printf(fmt.data(), ktl::forward<decltype(args)>(args)...);
         Out::print("\nSystem halted.\n");
 
         Log::print("======== KERNEL PANIC ========\n");
+        Log::printf("[{}.{:06}] ", now_us / 1'000'000, now_us % 1'000'000);
         Log::printf(fmt.data(), ktl::forward<decltype(args)>(args)...);
         Log::print("\n\n");
 
@@ -118,23 +150,60 @@ public:
         haltCatchFire(ctx);
     }
 
+    // Installs h for a vector that still has the default handler.
     static bool registerHandler(u16 vector, Handler h) {
-        if (real_handler_table[vector] == defaultInterruptHandler ||
-            real_handler_table[vector] == haltCatchFire)
-        {
-            real_handler_table[vector] = h;
+        const bool ok = updateHandlers([&](InterruptHandlerTable& t) {
+            if (!h || custom_handlers[vector]) {
+                return false;
+            }
+            t.handlers[vector] = ktl::move(h);
+            custom_handlers[vector] = true;
+            return true;
+        });
+
+        if (ok) {
             if constexpr (kDebugMode) {
                 FmtBase<SerialCOM2>::print("IDT: custom handler registered for vector ");
                 FmtBase<SerialCOM2>::printf("{:#02x}\n", vector);
             }
-            return true;
         }
-        return false;
+        return ok;
+    }
+
+    // Installs h unconditionally; nullptr restores the default handler.
+    static void replaceHandler(u16 vector, Handler h) {
+        updateHandlers([&](InterruptHandlerTable& t) {
+            custom_handlers[vector] = static_cast<bool>(h);
+            t.handlers[vector] = h ? ktl::move(h) : defaultHandler(vector);
+            return true;
+        });
+    }
+
+    // The table is shared; application processors only need to point
+    // their IDTR at it.
+    static void load() {
+        __asm__ volatile("lidt %0" : : "m"(idt_ptr) : "memory");
+    }
+
+    // Every slot of a published table holds a handler, so dispatch is a
+    // single indirect call. The handler runs out of the published table, so
+    // the call is an RCU read-side section: no quiescent state and no
+    // preemption until it returns; interrupt_dispatch() does both after.
+    // A CPU woken from its idle wait counts for RCU again meanwhile.
+    static void dispatch(registers_ctx* ctx) {
+        const bool was_idle = ktl::rcu_irq_enter();
+        ktl::rcu_read_lock();
+        ktl::rcu_dereference(current_handler_table)->handlers[ctx->interrupt_vector](ctx);
+        ktl::rcu_read_unlock();
+        ktl::rcu_irq_exit(was_idle);
     }
 
 private:
     [[noreturn]] static void defaultInterruptHandler(registers_ctx* ctx) {
         const auto vector = ctx->interrupt_vector;
+        if (vector == 2 && Smp::halting()) {
+            haltThisCpu();
+        }
         if (vector < 32) {
             kpanic(ctx, "Unhandled CPU Exception {:#02x}: {}", 
                 vector, exception_names[vector].data());
@@ -143,15 +212,56 @@ private:
         }
     }
 
+    static Handler defaultHandler(usize vector) {
+        if constexpr (!kIdtPanicOnException) {
+            if (vector < 32) {
+                return haltCatchFire;
+            }
+        }
+        return defaultInterruptHandler;
+    }
+
     [[noreturn]] static void haltCatchFire(registers_ctx*) {
-        // TODO halt other cores
+        if constexpr (kRunBenchmarks) {
+            Qemu::exit(Qemu::Failure);
+        }
+
+        Smp::haltOthers();
+        haltThisCpu();
+    }
+
+    [[noreturn]] static void haltThisCpu() {
         io::cli();
         for (;;) io::hlt();
         __builtin_unreachable();
     }
 
-    static inline void load() {
-        __asm__ volatile("lidt %0" : : "m"(idt_ptr) : "memory");
+    // Copy-update-publish. The table not currently published is the spare:
+    // it is rewritten from the live one, edited, and swapped in. Copying
+    // destroys the spare's old handlers, which no reader can still be
+    // running since the previous update waited for a grace period. Holding
+    // the lock across synchronize_rcu() keeps the next update from touching
+    // the old table while an interrupt on another CPU may still be using it.
+    //
+    // The lock is a semaphore, not a spinlock: an updater waiting for it
+    // sleeps with preemption enabled, so its CPU keeps passing quiescent
+    // states and the holder's grace period can end.
+    template<typename Fn>
+    static bool updateHandlers(Fn&& fn) {
+        update_lock.down();
+
+        InterruptHandlerTable* live  = current_handler_table;
+        InterruptHandlerTable* spare = live == &handlerTables()[0] ? &handlerTables()[1]
+                                                                   : &handlerTables()[0];
+        *spare = *live;
+        const bool changed = fn(*spare);
+        if (changed) {
+            ktl::rcu_assign_pointer(current_handler_table, spare);
+            ktl::synchronize_rcu();
+        }
+
+        update_lock.up();
+        return changed;
     }
 
     static inline void setGate(usize vec, uintptr_t base, u8 flags) {
@@ -183,6 +293,19 @@ private:
     static inline Entry  idt_table[256] = {};
     static inline Ptr    idt_ptr        = {};
 
+    // Raw storage for the live and spare tables, constructed by init() and
+    // never destroyed: as a static InterruptHandlerTable[2] it would need
+    // a destructor registration, and the kernel has no .init_array.
+    alignas(InterruptHandlerTable)
+    static inline u8 handler_storage[2 * sizeof(InterruptHandlerTable)] = {};
+
+    static InterruptHandlerTable* handlerTables() {
+        return reinterpret_cast<InterruptHandlerTable*>(handler_storage);
+    }
+
+    static inline bool           custom_handlers[256] = {};
+    static inline Semaphore             update_lock { 1 };
+
     static inline ktl::string_view exception_names[32] = {
         "Divide-by-zero Error",        // 0
         "Debug",                       // 1
@@ -49,6 +49,72 @@ public:
         __asm__ volatile ("hlt");
     }
 
+    // Spin-wait hint: lets the sibling hyperthread run and avoids the memory
+    // order mis-speculation flush when the awaited line finally changes.
+    static void pause() {
+        __asm__ volatile ("pause" ::: "memory");
+    }
+
+    [[nodiscard]] static u64 irqSave() {
+        u64 flags;
+        __asm__ volatile ("pushfq \n\t"
+                          "popq %0 \n\t"
+                          "cli"
+                          : "=r"(flags)
+                          :
+                          : "memory");
+        return flags;
+    }
+
+    static void irqRestore(u64 flags) {
+        if (flags & kFlagsIF) {
+            __asm__ volatile ("sti" ::: "memory");
+        }
+    }
+
+    [[nodiscard]] static bool irqEnabled() {
+        u64 flags;
+        __asm__ volatile ("pushfq \n\t"
+                          "popq %0"
+                          : "=r"(flags));
+        return flags & kFlagsIF;
+    }
+
+    static constexpr u64 kFlagsIF = 1ULL << 9;
+
+    class cr {
+    public:
+        template <int N>
+        static u64 read() {
+            u64 value;
+            if constexpr (N == 0) {
+                __asm__ volatile ("mov %%cr0, %0" : "=r"(value));
+            } else if constexpr (N == 2) {
+                __asm__ volatile ("mov %%cr2, %0" : "=r"(value));
+            } else if constexpr (N == 3) {
+                __asm__ volatile ("mov %%cr3, %0" : "=r"(value));
+            } else if constexpr (N == 4) {
+                __asm__ volatile ("mov %%cr4, %0" : "=r"(value));
+            } else {
+                static_assert(N == 0, "Invalid control register");
+            }
+            return value;
+        }
+
+        template <int N>
+        static void write(u64 value) {
+            if constexpr (N == 0) {
+                __asm__ volatile ("mov %0, %%cr0" : : "r"(value) : "memory");
+            } else if constexpr (N == 3) {
+                __asm__ volatile ("mov %0, %%cr3" : : "r"(value) : "memory");
+            } else if constexpr (N == 4) {
+                __asm__ volatile ("mov %0, %%cr4" : : "r"(value) : "memory");
+            } else {
+                static_assert(N == 0, "Invalid control register");
+            }
+        }
+    };
+
     class msr {
     public:
         static void write(u32 msr, u64 value) {
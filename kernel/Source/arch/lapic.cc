@@ -0,0 +1,92 @@
+#include <arch/lapic.hh>
+#include <arch/cpuid.hh>
+#include <arch/idt.hh>
+#include <arch/pit.hh>
+#include <arch/tsc.hh>
+#include <core/format.hh>
+#include <ktl/clock>
+
+void Lapic::init() {
+    s_x2apic = io::msr::read(kMsrApicBase) & kApicBaseX2apic;
+    if (!s_x2apic) {
+        Fmt::printf("LAPIC: not in x2APIC mode, no timer or IPIs\n");
+        return;
+    }
+
+    // A spurious interrupt needs no EOI and no action.
+    InterruptDescriptorTable::registerHandler(kSpuriousVector, [](registers_ctx*) {});
+    initCpu();
+
+    io::msr::write(kMsrDivide, kTimerDivide);
+    io::msr::write(kMsrLvtTimer, kLvtMasked | kTimerVector);
+    io::msr::write(kMsrInitCount, 0xFFFF'FFFF);
+    Pit::waitMicros(kCalibrationUs);
+    const u64 elapsed = 0xFFFF'FFFF - io::msr::read(kMsrCurrentCount);
+    io::msr::write(kMsrInitCount, 0);
+
+    s_ticks_per_ms = elapsed * 1000 / kCalibrationUs;
+    s_tsc_deadline = Cpuid::hasTscDeadline();
+
+    if constexpr (kDebugMode) {
+        Fmt::printf("LAPIC: x2APIC id {}, timer {} ticks/ms{}\n", id(), s_ticks_per_ms,
+                    s_tsc_deadline ? ", TSC deadline" : "");
+    }
+}
+
+void Lapic::initCpu() {
+    if (!s_x2apic) {
+        return;
+    }
+    io::msr::write(kMsrTpr, 0);
+    io::msr::write(kMsrSvr, kSvrEnable | kSpuriousVector);
+    io::msr::write(kMsrLvtTimer, kLvtMasked | kTimerVector);
+}
+
+void Lapic::armDeadline(u8 vector, u64 tsc) {
+    if (!s_x2apic) {
+        return;
+    }
+    if (s_tsc_deadline) {
+        io::msr::write(kMsrLvtTimer, kLvtDeadline | vector);
+        // x2APIC MSR writes are not serializing: without the fence the
+        // deadline may reach the timer before the mode switch and be lost.
+        __asm__ volatile ("mfence" ::: "memory");
+        io::msr::write(kMsrTscDeadline, tsc);
+        return;
+    }
+
+    // Past 2^40 ns (~18 minutes) the count is out of range anyway; the
+    // cap keeps the multiply from overflowing.
+    const u64 now   = Tsc::read();
+    const u64 ns    = tsc > now ? ktl::clock::cycles_to_ns(tsc - now) : 0;
+    u64       count = ns < (1ULL << 40) ? ns * s_ticks_per_ms / 1'000'000 : 0xFFFF'FFFF;
+    count = count == 0 ? 1 : count > 0xFFFF'FFFF ? 0xFFFF'FFFF : count;
+    io::msr::write(kMsrDivide, kTimerDivide);
+    io::msr::write(kMsrLvtTimer, vector);
+    io::msr::write(kMsrInitCount, count);
+}
+
+void Lapic::stopTimer() {
+    if (!s_x2apic) {
+        return;
+    }
+    if (s_tsc_deadline) {
+        io::msr::write(kMsrTscDeadline, 0);
+    }
+    io::msr::write(kMsrLvtTimer, kLvtMasked | kTimerVector);
+    io::msr::write(kMsrInitCount, 0);
+}
+
+void Lapic::sendIpi(u32 apic_id, u8 vector) {
+    if (!s_x2apic) {
+        return;
+    }
+    io::msr::write(kMsrIcr, (static_cast<u64>(apic_id) << 32) | kIcrAssert | vector);
+}
+
+void Lapic::sendNmiAllButSelf() {
+    if (!s_x2apic) {
+        return;
+    }
+    io::msr::write(kMsrIcr, kIcrNmi | kIcrAssert | kIcrAllExcludingSelf);
+}
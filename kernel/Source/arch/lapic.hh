@@ -0,0 +1,72 @@
+#ifndef LAPIC_HH
+#define LAPIC_HH
+
+#include <arch/io.hh>
+
+// Local APIC in x2APIC mode, where every register is an MSR. The xAPIC
+// register page is not mapped (Limine's HHDM leaves MMIO out and there is
+// no VMM yet), so without x2APIC there is no timer and no IPIs; callers
+// check available() and fall back to running without them.
+class Lapic {
+public:
+    static constexpr u8 kTimerVector      = 0x30;
+    static constexpr u8 kRescheduleVector = 0xF0;
+    static constexpr u8 kSpuriousVector   = 0xFF;
+
+    // Boot CPU, after the IDT is up: detects x2APIC, enables the boot
+    // CPU's APIC and calibrates the timer against the PIT.
+    static void init();
+
+    // Every other CPU, before it enables interrupts.
+    static void initCpu();
+
+    static bool available() { return s_x2apic; }
+
+    static u32 id() { return static_cast<u32>(io::msr::read(kMsrId)); }
+
+    static void eoi() { io::msr::write(kMsrEoi, 0); }
+
+    // Fires vector once on the calling CPU when the TSC reaches tsc, at
+    // once if it already has. Uses TSC-deadline mode where the CPU has it;
+    // otherwise counts down from now, and a deadline beyond the counter's
+    // range fires early. Re-arming replaces the previous deadline.
+    static void armDeadline(u8 vector, u64 tsc);
+
+    static void stopTimer();
+
+    static void sendIpi(u32 apic_id, u8 vector);
+    static void sendNmiAllButSelf();
+
+private:
+    static constexpr u32 kMsrApicBase     = 0x1B;
+    static constexpr u32 kMsrId           = 0x802;
+    static constexpr u32 kMsrTpr          = 0x808;
+    static constexpr u32 kMsrEoi          = 0x80B;
+    static constexpr u32 kMsrSvr          = 0x80F;
+    static constexpr u32 kMsrIcr          = 0x830;
+    static constexpr u32 kMsrLvtTimer     = 0x832;
+    static constexpr u32 kMsrInitCount    = 0x838;
+    static constexpr u32 kMsrCurrentCount = 0x839;
+    static constexpr u32 kMsrDivide       = 0x83E;
+    static constexpr u32 kMsrTscDeadline  = 0x6E0;
+
+    static constexpr u64 kApicBaseX2apic = 1 << 10;
+    static constexpr u64 kSvrEnable      = 1 << 8;
+
+    static constexpr u32 kLvtMasked   = 1 << 16;
+    static constexpr u32 kLvtDeadline = 1 << 18;
+
+    // Divide configuration 0b0011: timer counts at bus clock / 16.
+    static constexpr u32 kTimerDivide   = 0b0011;
+    static constexpr u32 kCalibrationUs = 10'000;
+
+    static constexpr u64 kIcrNmi              = 0b100 << 8;
+    static constexpr u64 kIcrAssert           = 1 << 14;
+    static constexpr u64 kIcrAllExcludingSelf = 0b11 << 18;
+
+    static inline bool s_x2apic       = false;
+    static inline bool s_tsc_deadline = false;
+    static inline u64  s_ticks_per_ms = 0;
+};
+
+#endif // LAPIC_HH
@@ -0,0 +1,34 @@
+#include <arch/percpu.hh>
+#include <arch/cpu.hh>
+#include <arch/idt.hh>
+#include <arch/io.hh>
+#include <core/format.hh>
+
+PER_CPU u32  PerCpu::s_cpu_number = 0;
+PER_CPU uptr PerCpu::s_offset     = 0;
+
+void PerCpu::init() {
+    if (static_cast<usize>(__percpu_areas_end - __percpu_areas) < kMaxCpus * size()) {
+        InterruptDescriptorTable::kpanic(
+            nullptr, "PerCpu: linker script reserves fewer than {} areas", kMaxCpus);
+    }
+
+    // Copy before anything has run on the template, so every CPU starts
+    // from the variables' initial values.
+    for (u32 cpu = 0; cpu < kMaxCpus; ++cpu) {
+        __builtin_memcpy(__percpu_areas + cpu * size(), __percpu_start, size());
+        per_cpu(s_cpu_number, cpu) = cpu;
+        per_cpu(s_offset, cpu)     = offset(cpu);
+    }
+
+    load(Cpu::kBootCpu);
+
+    if constexpr (kDebugMode) {
+        Fmt::printf("PerCpu: {} bytes per CPU, areas @ {:#016x}\n",
+                    size(), reinterpret_cast<u64>(__percpu_areas));
+    }
+}
+
+void PerCpu::load(u32 cpu) {
+    io::msr::write(kGsBaseMsr, offset(cpu));
+}
@@ -0,0 +1,158 @@
+#ifndef PERCPU_HH
+#define PERCPU_HH
+
+#include <arch/smp.hh>
+
+// Per-CPU variables.
+//
+// A variable declared PER_CPU lands in the .percpu section, which is only
+// a template: PerCpu::init() copies it into one area per CPU (reserved in
+// .bss by the linker script) and each CPU points its GS base at
+// `area - __percpu_start`. A gs-prefixed access to the template's address
+// then hits the calling CPU's copy, so
+//
+//     PER_CPU u64 s_irqs;
+//     this_cpu_inc(s_irqs);       // addq $1, %gs:s_irqs(%rip)
+//
+// is one instruction: no lock prefix, no shared cache line, and atomic
+// against interrupts on the same CPU. Never touch a PER_CPU variable
+// directly; that reads or writes the template.
+//
+// Areas are 64-byte aligned and padded to a multiple of 64 bytes, so
+// different CPUs' data never share a cache line. Variables that are hot
+// on their own CPU and read remotely should be PER_CPU_ALIGNED, which
+// also keeps them off the lines of neighbouring variables.
+//
+// Class statics must be defined out of line in a .cc: an inline variable
+// is emitted as a COMDAT, and GCC refuses to mix those with ordinary
+// variables in one section.
+//
+// A single this_cpu_*() operation can't be split by preemption, but the
+// scheduler may move a thread between two of them. A pointer from
+// this_cpu(), or a read-modify-write spread over several operations, is
+// only safe with preemption disabled (core/preempt.hh).
+
+#define PER_CPU         [[gnu::section(".percpu")]]
+#define PER_CPU_ALIGNED [[gnu::section(".percpu.cacheline"), gnu::aligned(64)]]
+
+extern "C" {
+    extern u8 __percpu_start[];
+    extern u8 __percpu_end[];
+    extern u8 __percpu_areas[];
+    extern u8 __percpu_areas_end[];
+}
+
+class PerCpu {
+public:
+    static constexpr u32 kGsBaseMsr = 0xC000'0101;
+
+    // On the boot CPU, before anything touches per-CPU data: fills every
+    // CPU's area from the template and loads the boot CPU's GS base.
+    static void init();
+
+    // Points the calling CPU's GS base at cpu's area. Loading a segment
+    // register clears the base again, so nothing may reload gs afterwards.
+    static void load(u32 cpu);
+
+    // Size of one CPU's area.
+    static usize size() {
+        return static_cast<usize>(__percpu_end - __percpu_start);
+    }
+
+    // What to add to a PER_CPU variable's address to reach cpu's copy.
+    static uptr offset(u32 cpu) {
+        return reinterpret_cast<uptr>(__percpu_areas) + cpu * size()
+             - reinterpret_cast<uptr>(__percpu_start);
+    }
+
+    // Both live in every area, set up by init().
+    static u32  s_cpu_number;
+    static uptr s_offset;
+};
+
+// gs-relative operations on the calling CPU's copy of var. The asm
+// operand is the template variable itself; the gs base redirects it.
+template<typename T>
+inline T this_cpu_read(const T& var) {
+    static_assert(sizeof(T) <= 8, "this_cpu_read: use this_cpu() for larger objects");
+    T value;
+    __asm__ volatile ("mov%z1 %%gs:%1, %0" : "=r"(value) : "m"(var));
+    return value;
+}
+
+template<typename T>
+inline void this_cpu_write(T& var, T value) {
+    static_assert(sizeof(T) <= 8, "this_cpu_write: use this_cpu() for larger objects");
+    __asm__ volatile ("mov%z0 %1, %%gs:%0" : "=m"(var) : "re"(value));
+}
+
+template<typename T>
+inline void this_cpu_add(T& var, T value) {
+    static_assert(sizeof(T) <= 8, "this_cpu_add: integral per-CPU variables only");
+    __asm__ volatile ("add%z0 %1, %%gs:%0" : "+m"(var) : "re"(value) : "cc");
+}
+
+template<typename T>
+inline void this_cpu_sub(T& var, T value) {
+    static_assert(sizeof(T) <= 8, "this_cpu_sub: integral per-CPU variables only");
+    __asm__ volatile ("sub%z0 %1, %%gs:%0" : "+m"(var) : "re"(value) : "cc");
+}
+
+template<typename T>
+inline void this_cpu_inc(T& var) {
+    this_cpu_add(var, T(1));
+}
+
+template<typename T>
+inline void this_cpu_dec(T& var) {
+    this_cpu_sub(var, T(1));
+}
+
+// cpu's copy of var, from any CPU.
+template<typename T>
+inline T* per_cpu_ptr(T& var, u32 cpu) {
+    return reinterpret_cast<T*>(reinterpret_cast<uptr>(&var) + PerCpu::offset(cpu));
+}
+
+template<typename T>
+inline T& per_cpu(T& var, u32 cpu) {
+    return *per_cpu_ptr(var, cpu);
+}
+
+// The calling CPU's copy of var, for objects this_cpu_read() can't move
+// in one instruction.
+template<typename T>
+inline T& this_cpu(T& var) {
+    return *reinterpret_cast<T*>(reinterpret_cast<uptr>(&var) + this_cpu_read(PerCpu::s_offset));
+}
+
+// A statistic split across CPUs. add() is a single gs-relative add on the
+// calling CPU's copy; sum() adds up every online CPU's copy, so a reader
+// may see an increment on one CPU before an earlier one on another.
+// Declare it PER_CPU:
+//
+//     PER_CPU PerCpuCounter s_page_faults;
+class PerCpuCounter {
+public:
+    constexpr PerCpuCounter() = default;
+
+    void add(u64 n) { this_cpu_add(m_value, n); }
+    void inc()      { this_cpu_inc(m_value); }
+
+    u64 read(u32 cpu) const {
+        return __atomic_load_n(per_cpu_ptr(m_value, cpu), __ATOMIC_RELAXED);
+    }
+
+    u64 sum() const {
+        u64 total = 0;
+        for_each_online_cpu(cpu) {
+            total += read(cpu);
+        }
+        return total;
+    }
+
+private:
+    u64 m_value = 0;
+};
+
+#endif // PERCPU_HH
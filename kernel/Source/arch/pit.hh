@@ -0,0 +1,47 @@
+#ifndef PIT_HH
+#define PIT_HH
+
+#include <arch/io.hh>
+
+// The legacy 8254 timer, only as a reference clock for calibrating the
+// others. Channel 2 is used because its output can be polled through port
+// 0x61 and raises no interrupt.
+class Pit {
+public:
+    static constexpr u32 kFrequency = 1'193'182;
+
+    // Busy-waits for us microseconds, at most 54925 (one 16-bit count).
+    static void waitMicros(u32 us) {
+        const u64 count = static_cast<u64>(kFrequency) * us / 1'000'000;
+        const u16 reload = count > 0xFFFF ? 0xFFFF : static_cast<u16>(count);
+
+        // Gate low and speaker off while programming; mode 0 counts down
+        // once the gate goes high and raises OUT2 when it reaches zero.
+        const u8 control = io::in<u8>(kPortControl) & ~(kGate2 | kSpeaker);
+        io::out<u8>(kPortControl, control);
+        io::out<u8>(kPortCommand, kChannel2 | kLoHi | kMode0);
+        io::out<u8>(kPortChannel2, static_cast<u8>(reload & 0xFF));
+        io::out<u8>(kPortChannel2, static_cast<u8>(reload >> 8));
+        io::out<u8>(kPortControl, control | kGate2);
+
+        while (!(io::in<u8>(kPortControl) & kOut2)) {
+            io::pause();
+        }
+        io::out<u8>(kPortControl, control);
+    }
+
+private:
+    static constexpr u16 kPortChannel2 = 0x42;
+    static constexpr u16 kPortCommand  = 0x43;
+    static constexpr u16 kPortControl  = 0x61;
+
+    static constexpr u8 kChannel2 = 0b10 << 6;
+    static constexpr u8 kLoHi     = 0b11 << 4;
+    static constexpr u8 kMode0    = 0b000 << 1;
+
+    static constexpr u8 kGate2   = 1 << 0;
+    static constexpr u8 kSpeaker = 1 << 1;
+    static constexpr u8 kOut2    = 1 << 5;
+};
+
+#endif // PIT_HH
@@ -0,0 +1,24 @@
+#ifndef QEMU_HH
+#define QEMU_HH
+
+#include <arch/io.hh>
+
+// isa-debug-exit, as configured by the `bench` target in the top-level
+// GNUmakefile. QEMU terminates with status (code << 1) | 1.
+class Qemu {
+public:
+    static constexpr u16 kDebugExitPort = 0xF4;
+
+    enum ExitCode : u32 {
+        Success = 0,
+        Failure = 1,
+    };
+
+    [[noreturn]] static void exit(ExitCode code) {
+        io::out<u32>(kDebugExitPort, code);
+        io::cli();
+        for (;;) io::hlt();
+    }
+};
+
+#endif // QEMU_HH
@@ -0,0 +1,107 @@
+#ifndef RTC_HH
+#define RTC_HH
+
+#include <arch/io.hh>
+
+// The CMOS real-time clock, read once at boot to seed the wall clock. It
+// counts whole seconds, in BCD or binary and in 12- or 24-hour format as
+// status register B says, and has no notion of time zone; firmware on PCs
+// keeps it in UTC.
+class Rtc {
+public:
+    // Seconds since the Unix epoch, or 0 if the clock reads as nonsense.
+    static u64 unixSeconds() {
+        // The registers change underneath a read during an update: read
+        // until two complete passes agree.
+        Reading a = read();
+        for (;;) {
+            const Reading b = read();
+            if (b == a) {
+                break;
+            }
+            a = b;
+        }
+
+        const u8 status_b = cmos(kStatusB);
+        if (!(status_b & kBinary)) {
+            a.second  = fromBcd(a.second);
+            a.minute  = fromBcd(a.minute);
+            a.hour    = fromBcd(a.hour & 0x7F) | (a.hour & 0x80);
+            a.day     = fromBcd(a.day);
+            a.month   = fromBcd(a.month);
+            a.year    = fromBcd(a.year);
+            a.century = fromBcd(a.century);
+        }
+        if (!(status_b & k24Hour) && (a.hour & 0x80)) {
+            a.hour = ((a.hour & 0x7F) + 12) % 24;
+        }
+
+        // The century register is not standard (ACPI's FADT names it);
+        // 0x32 is where PC firmware and QEMU keep it.
+        const u32 century = (a.century >= 19 && a.century <= 30) ? a.century : 20;
+        const u32 year = century * 100 + a.year;
+
+        if (a.month < 1 || a.month > 12 || a.day < 1 || a.day > 31
+            || a.hour > 23 || a.minute > 59 || a.second > 59 || year < 1970) {
+            return 0;
+        }
+        return static_cast<u64>(daysFromCivil(year, a.month, a.day)) * 86400
+             + a.hour * 3600 + a.minute * 60 + a.second;
+    }
+
+private:
+    static constexpr u16 kPortIndex = 0x70;
+    static constexpr u16 kPortData  = 0x71;
+
+    static constexpr u8 kSeconds = 0x00;
+    static constexpr u8 kMinutes = 0x02;
+    static constexpr u8 kHours   = 0x04;
+    static constexpr u8 kDay     = 0x07;
+    static constexpr u8 kMonth   = 0x08;
+    static constexpr u8 kYear    = 0x09;
+    static constexpr u8 kStatusA = 0x0A;
+    static constexpr u8 kStatusB = 0x0B;
+    static constexpr u8 kCentury = 0x32;
+
+    static constexpr u8 kUpdating = 1 << 7;   // status A
+    static constexpr u8 k24Hour   = 1 << 1;   // status B
+    static constexpr u8 kBinary   = 1 << 2;   // status B
+
+    struct Reading {
+        u8 second, minute, hour, day, month, year, century;
+
+        bool operator==(const Reading&) const = default;
+    };
+
+    static u8 cmos(u8 reg) {
+        io::out<u8>(kPortIndex, reg);
+        return io::in<u8>(kPortData);
+    }
+
+    static Reading read() {
+        while (cmos(kStatusA) & kUpdating) {
+            io::pause();
+        }
+        return {
+            cmos(kSeconds), cmos(kMinutes), cmos(kHours),
+            cmos(kDay), cmos(kMonth), cmos(kYear), cmos(kCentury),
+        };
+    }
+
+    static constexpr u8 fromBcd(u8 v) {
+        return (v & 0x0F) + (v >> 4) * 10;
+    }
+
+    // Days since 1970-01-01 of a proleptic Gregorian date (year >= 1970),
+    // counting in 400-year eras that start on March 1st.
+    static constexpr u64 daysFromCivil(u32 y, u32 m, u32 d) {
+        y -= m <= 2;
+        const u32 era = y / 400;
+        const u32 yoe = y - era * 400;
+        const u32 doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+        const u32 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return static_cast<u64>(era) * 146097 + doe - 719468;
+    }
+};
+
+#endif // RTC_HH
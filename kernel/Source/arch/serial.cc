@@ -0,0 +1,27 @@
+#include <arch/serial.hh>
+#include <core/sched.hh>
+#include <core/wait.hh>
+#include <ktl/clock>
+
+namespace {
+
+constexpr u64 kRxPollNs = 1'000'000;
+
+// Sleeping needs a thread that may block and a running clock: before
+// ktl::clock::start() every reading is 0, and a timed sleep never ends.
+bool canSleep() {
+    return Scheduler::canBlock() && ktl::clock::frequency() != 0;
+}
+
+} // namespace
+
+char serial_get_sleeping(u16 port_base) {
+    while (!(io::in<u8>(port_base + Serial<>::LSR) & 0x01)) {
+        if (canSleep()) {
+            sleep_for(kRxPollNs);
+        } else {
+            io::pause();
+        }
+    }
+    return static_cast<char>(io::in<u8>(port_base + Serial<>::DATA));
+}
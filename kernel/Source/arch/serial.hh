@@ -4,6 +4,10 @@
 #include <arch/io.hh>
 #include <ktl/string_view>
 
+// Serial::get() for the UART at port_base; in arch/serial.cc, so that this
+// header, which every printing file includes, stays free of the scheduler.
+char serial_get_sleeping(u16 port_base);
+
 template<
     u16     PORT_BASE = 0x3F8,
     u32     BAUD      = 115200,
@@ -51,9 +55,13 @@ public:
         io::out<u8>(PORT_BASE + DATA, static_cast<u8>(c));
     }
 
+    // Waits for a byte. A thread that can block sleeps between looks at
+    // the line status: the receive interrupt has no route to a CPU without
+    // an I/O APIC driver. At 115200 baud the 16-byte FIFO takes about
+    // 1.4 ms to fill, so a wheel tick's sleep loses nothing. Where sleeping
+    // is not possible, e.g. before the scheduler is up, it polls.
     static char get() {
-        while (!rx_ready()) { /* TODO spin */ }
-        return static_cast<char>(io::in<u8>(PORT_BASE + DATA));
+        return serial_get_sleeping(PORT_BASE);
     }
 
     static void flush() {
@@ -0,0 +1,15 @@
+// Scalar fallback, built with the normal kernel flags. SimdVector<8> is a
+// single u64 lane, which the compiler keeps in general purpose registers.
+
+#include <arch/simd_vector.hh>
+#include <util/string.h>
+
+using Scalar = SimdVector<8>;
+
+const SimdKernels kSimdScalarKernels = {
+    .name      = "scalar",
+    .memcpy    = ::memcpy,
+    .memset    = ::memset,
+    .checksum  = Scalar::checksum,
+    .pageEqual = Scalar::pageEqual,
+};
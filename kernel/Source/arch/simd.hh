@@ -0,0 +1,100 @@
+#ifndef SIMD_HH
+#define SIMD_HH
+
+#include <arch/cpuid.hh>
+#include <arch/fpu.hh>
+#include <arch/simd_kernels.hh>
+#include <core/format.hh>
+#include <util/string.h>
+
+// Bulk operations that may use vector registers. init() picks the widest
+// kernel set the CPU supports; every call below its size threshold (or with
+// no vector set available) goes to the scalar code instead, since
+// kernel_fpu_begin()/kernel_fpu_end() cost ~220 cycles of XSAVEOPT/XRSTOR.
+//
+// Thresholds come from a host measurement of FPU section + kernel vs. the
+// scalar path, in cycles per call:
+//
+//   size     memcpy rep-movsb  avx2+fpu    checksum scalar  sse2+fpu  avx2+fpu
+//   1 KiB          54            226             241           459       316
+//   2 KiB          79            324             507           652       380
+//   16 KiB        401            785            3676          3109      1301
+//   1 MiB       65122          61223          217011        179056     58855
+//
+// rep movsb/stosb is never beaten by enough to pay for the section, so the
+// vector copy and fill are only used on CPUs without ERMS, where the word
+// loop in util/string.c tops out around 10 bytes/cycle.
+class Simd {
+public:
+    static void init() {
+        if (Cpuid::hasAvx2() && (Fpu::xcr0() & Fpu::XCR0_AVX)) {
+            s_kernels      = &kSimdAvx2Kernels;
+            s_checksum_min = 2 * 1024;
+            s_page_vector  = true;
+        } else if (Cpuid::hasSse2()) {
+            s_kernels      = &kSimdSse2Kernels;
+            s_checksum_min = 16 * 1024;
+            s_page_vector  = false;
+        } else {
+            s_kernels      = &kSimdScalarKernels;
+            s_checksum_min = kNever;
+            s_page_vector  = false;
+        }
+
+        s_copy_min = (s_kernels != &kSimdScalarKernels && !Cpuid::hasErms())
+                   ? 16 * 1024
+                   : kNever;
+
+        if constexpr (kDebugMode) {
+            Fmt::printf("SIMD: using {} kernels (copy>={}, checksum>={}, page compare {})\n",
+                        s_kernels->name, s_copy_min, s_checksum_min,
+                        s_page_vector ? "vector" : "scalar");
+        }
+    }
+
+    static void* memcpy(void* dest, const void* src, usize n) {
+        if (n < s_copy_min) {
+            return ::memcpy(dest, src, n);
+        }
+        KernelFpuGuard fpu;
+        return s_kernels->memcpy(dest, src, n);
+    }
+
+    static void* memset(void* dest, int c, usize n) {
+        if (n < s_copy_min) {
+            return ::memset(dest, c, n);
+        }
+        KernelFpuGuard fpu;
+        return s_kernels->memset(dest, c, n);
+    }
+
+    static u16 checksum(const void* data, usize n) {
+        if (n < s_checksum_min) {
+            return kSimdScalarKernels.checksum(data, n);
+        }
+        KernelFpuGuard fpu;
+        return s_kernels->checksum(data, n);
+    }
+
+    static bool pageEqual(const void* a, const void* b) {
+        if (!s_page_vector) {
+            return kSimdScalarKernels.pageEqual(a, b);
+        }
+        KernelFpuGuard fpu;
+        return s_kernels->pageEqual(a, b);
+    }
+
+    static const SimdKernels& kernels() {
+        return *s_kernels;
+    }
+
+private:
+    static constexpr usize kNever = static_cast<usize>(-1);
+
+    static inline const SimdKernels* s_kernels      = &kSimdScalarKernels;
+    static inline usize              s_copy_min     = kNever;
+    static inline usize              s_checksum_min = kNever;
+    static inline bool               s_page_vector  = false;
+};
+
+#endif // SIMD_HH
@@ -0,0 +1,14 @@
+// Built with -mavx -mavx2; see the per-file flags in kernel/GNUmakefile.
+// Only reachable through Simd, which brackets every call with an FPU section.
+
+#include <arch/simd_vector.hh>
+
+using Avx2 = SimdVector<32>;
+
+const SimdKernels kSimdAvx2Kernels = {
+    .name      = "avx2",
+    .memcpy    = Avx2::memcpy,
+    .memset    = Avx2::memset,
+    .checksum  = Avx2::checksum,
+    .pageEqual = Avx2::pageEqual,
+};
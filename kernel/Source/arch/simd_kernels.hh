@@ -0,0 +1,21 @@
+#ifndef SIMD_KERNELS_HH
+#define SIMD_KERNELS_HH
+
+// Shared by the per-ISA translation units (simd_sse2.cc, simd_avx2.cc),
+// which are compiled with vector code generation enabled. Keep this header
+// free of inline function bodies: anything inline emitted from those TUs
+// could be picked by the linker for callers outside an FPU section.
+
+struct SimdKernels {
+    const char* name;
+    void* (*memcpy)(void* dest, const void* src, usize n);
+    void* (*memset)(void* dest, int c, usize n);
+    u16   (*checksum)(const void* data, usize n);
+    bool  (*pageEqual)(const void* a, const void* b);
+};
+
+extern const SimdKernels kSimdScalarKernels;
+extern const SimdKernels kSimdSse2Kernels;
+extern const SimdKernels kSimdAvx2Kernels;
+
+#endif // SIMD_KERNELS_HH
@@ -0,0 +1,14 @@
+// Built with -msse -msse2; see the per-file flags in kernel/GNUmakefile.
+// Only reachable through Simd, which brackets every call with an FPU section.
+
+#include <arch/simd_vector.hh>
+
+using Sse2 = SimdVector<16>;
+
+const SimdKernels kSimdSse2Kernels = {
+    .name      = "sse2",
+    .memcpy    = Sse2::memcpy,
+    .memset    = Sse2::memset,
+    .checksum  = Sse2::checksum,
+    .pageEqual = Sse2::pageEqual,
+};
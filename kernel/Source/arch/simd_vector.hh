@@ -0,0 +1,172 @@
+#ifndef SIMD_VECTOR_HH
+#define SIMD_VECTOR_HH
+
+#include <arch/simd_kernels.hh>
+
+// Width-generic bodies of the vector kernels, written with GCC vector
+// extensions so that no intrinsic headers are needed. Only the per-ISA
+// translation units (and simd.cc, for the 8-byte general purpose register
+// variant) include this file; everything lives in an anonymous namespace so
+// each of them gets private copies built for its own ISA.
+
+namespace {
+
+// GCC drops vector attributes on dependent types, so spell each width out.
+template<usize Width> struct SimdLanes;
+template<> struct SimdLanes<8>  { typedef u64 type __attribute__((vector_size(8),  aligned(1), may_alias)); };
+template<> struct SimdLanes<16> { typedef u64 type __attribute__((vector_size(16), aligned(1), may_alias)); };
+template<> struct SimdLanes<32> { typedef u64 type __attribute__((vector_size(32), aligned(1), may_alias)); };
+
+template<usize Width>
+struct SimdVector {
+    using Lanes = typename SimdLanes<Width>::type;
+
+    static constexpr usize kWidth = Width;
+    static constexpr usize kLanes = Width / sizeof(u64);
+
+    static Lanes load(const u8* p) {
+        return *reinterpret_cast<const Lanes*>(p);
+    }
+
+    static void store(u8* p, Lanes v) {
+        *reinterpret_cast<Lanes*>(p) = v;
+    }
+
+    static u64 reduceOr(Lanes v) {
+        u64 r = 0;
+        for (usize i = 0; i < kLanes; ++i) {
+            r |= v[i];
+        }
+        return r;
+    }
+
+    static void* memcpy(void* dest, const void* src, usize n) {
+        auto* d = static_cast<u8*>(dest);
+        auto* s = static_cast<const u8*>(src);
+
+        if (n < Width) {
+            while (n--) {
+                *d++ = *s++;
+            }
+            return dest;
+        }
+
+        const Lanes tail = load(s + n - Width);
+        u8* const tail_dest = d + n - Width;
+
+        while (n >= 4 * Width) {
+            const Lanes a = load(s);
+            const Lanes b = load(s + Width);
+            const Lanes c = load(s + 2 * Width);
+            const Lanes e = load(s + 3 * Width);
+            store(d, a);
+            store(d + Width, b);
+            store(d + 2 * Width, c);
+            store(d + 3 * Width, e);
+            d += 4 * Width;
+            s += 4 * Width;
+            n -= 4 * Width;
+        }
+        while (n >= Width) {
+            store(d, load(s));
+            d += Width;
+            s += Width;
+            n -= Width;
+        }
+
+        store(tail_dest, tail);
+        return dest;
+    }
+
+    static void* memset(void* dest, int c, usize n) {
+        auto* d = static_cast<u8*>(dest);
+        const u8 b = static_cast<u8>(c);
+
+        if (n < Width) {
+            while (n--) {
+                *d++ = b;
+            }
+            return dest;
+        }
+
+        const Lanes v = Lanes{} + 0x0101'0101'0101'0101ULL * b;
+        u8* const tail_dest = d + n - Width;
+
+        while (n >= 4 * Width) {
+            store(d, v);
+            store(d + Width, v);
+            store(d + 2 * Width, v);
+            store(d + 3 * Width, v);
+            d += 4 * Width;
+            n -= 4 * Width;
+        }
+        while (n >= Width) {
+            store(d, v);
+            d += Width;
+            n -= Width;
+        }
+
+        store(tail_dest, v);
+        return dest;
+    }
+
+    // RFC 1071 ones' complement sum. 32-bit halves of every lane are added
+    // into 64-bit accumulators; the carries are folded back at the end.
+    static u16 checksum(const void* data, usize n) {
+        auto* p = static_cast<const u8*>(data);
+
+        Lanes acc = {};
+        while (n >= Width) {
+            const Lanes x = load(p);
+            acc += (x & 0xFFFF'FFFFULL) + (x >> 32);
+            p += Width;
+            n -= Width;
+        }
+
+        u64 sum = 0;
+        for (usize i = 0; i < kLanes; ++i) {
+            sum += (acc[i] & 0xFFFF'FFFFULL) + (acc[i] >> 32);
+        }
+
+        while (n >= 4) {
+            sum += *reinterpret_cast<const u32 __attribute__((aligned(1), may_alias))*>(p);
+            p += 4;
+            n -= 4;
+        }
+        if (n >= 2) {
+            sum += *reinterpret_cast<const u16 __attribute__((aligned(1), may_alias))*>(p);
+            p += 2;
+            n -= 2;
+        }
+        if (n) {
+            sum += *p;
+        }
+
+        sum = (sum & 0xFFFF'FFFFULL) + (sum >> 32);
+        sum = (sum & 0xFFFF'FFFFULL) + (sum >> 32);
+        sum = (sum & 0xFFFF) + (sum >> 16);
+        sum = (sum & 0xFFFF) + (sum >> 16);
+        sum = (sum & 0xFFFF) + (sum >> 16);
+        return static_cast<u16>(~sum);
+    }
+
+    static bool pageEqual(const void* a, const void* b) {
+        auto* pa = static_cast<const u8*>(a);
+        auto* pb = static_cast<const u8*>(b);
+
+        for (usize off = 0; off < 4096; off += 4 * Width) {
+            const Lanes diff = (load(pa + off) ^ load(pb + off))
+                             | (load(pa + off + Width) ^ load(pb + off + Width))
+                             | (load(pa + off + 2 * Width) ^ load(pb + off + 2 * Width))
+                             | (load(pa + off + 3 * Width) ^ load(pb + off + 3 * Width));
+            if (reduceOr(diff)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+#endif // SIMD_VECTOR_HH
@@ -0,0 +1,219 @@
+#include <limine.h>
+
+#include <arch/smp.hh>
+#include <arch/cpu.hh>
+#include <arch/fpu.hh>
+#include <arch/gdt.hh>
+#include <arch/idt.hh>
+#include <arch/io.hh>
+#include <arch/lapic.hh>
+#include <arch/percpu.hh>
+#include <arch/tsc.hh>
+#include <core/format.hh>
+#include <core/sched.hh>
+#include <ktl/atomic>
+#include <ktl/bitset>
+#include <ktl/clock>
+#include <ktl/rcu>
+
+namespace {
+
+using ktl::memory_order_acquire;
+using ktl::memory_order_acq_rel;
+using ktl::memory_order_relaxed;
+using ktl::memory_order_release;
+
+[[gnu::used, gnu::section(".limine_requests")]] volatile limine_mp_request s_mp_request = {
+    .id       = LIMINE_MP_REQUEST,
+    .revision = 0,
+    .response = nullptr,
+    .flags    = LIMINE_MP_X2APIC,
+};
+
+constexpr usize kApStackSize = 16 * 1024;
+
+// How long Smp::init waits for the APs to report in.
+constexpr u64 kApTimeoutNs = 3'000'000'000ULL;
+
+// The boot CPU runs on the stack Limine gave it; APs get these.
+alignas(16) u8 s_ap_stacks[kMaxCpus - 1][kApStackSize];
+
+// An AP's arrival races with Smp::init giving up on it: whichever moves
+// the state out of kStarting first decides whether the CPU is counted.
+enum ApState : u32 {
+    kStarting,
+    kArrived,
+    kAbandoned,
+};
+
+struct ApBoot {
+    u64              start_tsc = 0;
+    u64              ready_tsc = 0;
+    u32              lapic_id  = 0;
+    ktl::atomic<u32> state { kStarting };
+};
+
+constinit ApBoot s_ap_boot[kMaxCpus];
+
+ktl::atomic<u32>  s_arrived { 0 };
+ktl::atomic<bool> s_released { false };
+ktl::atomic<u32>  s_online { 1 };
+ktl::atomic<bool> s_halting { false };
+bool              s_x2apic = false;
+u32               s_lapic_ids[kMaxCpus];
+
+// The boot CPU alone until Smp::init fills in the APs, before it releases
+// them; read-only after.
+constinit ktl::bitset<kMaxCpus> s_online_mask = [] {
+    ktl::bitset<kMaxCpus> mask;
+    mask.set(Cpu::kBootCpu);
+    return mask;
+}();
+
+[[noreturn]] void apMain(u32 cpu) {
+    PerCpu::load(cpu);
+    Fpu::initAp();
+    GlobalDescriptorTable::load(cpu);
+    InterruptDescriptorTable::load();
+    ktl::rcu_cpu_online(cpu);
+    Lapic::initCpu();
+    Scheduler::initCpu(cpu);
+
+    s_ap_boot[cpu].ready_tsc = Tsc::read();
+    u32 expected = kStarting;
+    if (!s_ap_boot[cpu].state.compare_exchange_strong(expected, kArrived,
+                                                      memory_order_acq_rel,
+                                                      memory_order_acquire)) {
+        // Too late: Smp::init has left this index out of the online mask.
+        // Grace periods would otherwise wait for it forever.
+        ktl::rcu_cpu_offline(cpu);
+        io::cli();
+        for (;;) io::hlt();
+    }
+    s_arrived.fetch_add(1, memory_order_release);
+    while (!s_released.load(memory_order_acquire)) {
+        io::pause();
+    }
+
+    Scheduler::idleLoop();
+}
+
+// Limine's goto_address target, still on the bootloader's AP stack: switch
+// to the CPU's own stack before running any kernel code.
+[[noreturn]] void apEntry(limine_mp_info* info) {
+    const u32 cpu = static_cast<u32>(info->extra_argument);
+    u8* const top = s_ap_stacks[cpu - 1] + kApStackSize;
+    __asm__ volatile ("movq %[top], %%rsp \n\t"
+                      "xorl %%ebp, %%ebp  \n\t"
+                      "call %P[main]      \n\t"
+                      "ud2"
+                      :
+                      : [top] "r"(top), [main] "i"(&apMain), "D"(cpu)
+                      : "memory");
+    __builtin_unreachable();
+}
+
+} // namespace
+
+void Smp::init() {
+    limine_mp_response* const mp = s_mp_request.response;
+    s_lapic_ids[Cpu::kBootCpu] = Lapic::available() ? Lapic::id() : 0;
+    if (mp == nullptr) {
+        Fmt::printf("SMP: no MP response, running on the boot CPU only\n");
+        return;
+    }
+
+    s_x2apic = mp->flags & LIMINE_MP_X2APIC;
+
+    u32 started = 0;
+    for (u64 i = 0; i < mp->cpu_count; ++i) {
+        limine_mp_info* const info = mp->cpus[i];
+        if (info->lapic_id == mp->bsp_lapic_id) {
+            continue;
+        }
+        if (started + 1 >= kMaxCpus) {
+            Fmt::printf("SMP: {} CPUs reported, only {} supported\n",
+                        mp->cpu_count, kMaxCpus);
+            break;
+        }
+
+        const u32 cpu = ++started;
+        s_lapic_ids[cpu]         = info->lapic_id;
+        s_ap_boot[cpu].lapic_id  = info->lapic_id;
+        s_ap_boot[cpu].start_tsc = Tsc::read();
+        info->extra_argument     = cpu;
+        __atomic_store_n(&info->goto_address, &apEntry, __ATOMIC_RELEASE);
+    }
+
+    const u64 begin   = Tsc::read();
+    const u64 timeout = ktl::clock::ns_to_cycles(kApTimeoutNs);
+    while (s_arrived.load(memory_order_acquire) != started) {
+        if (Tsc::read() - begin > timeout) {
+            break;
+        }
+        io::pause();
+    }
+
+    // Indices were handed out before the APs started, so one that timed out
+    // leaves a hole: the online CPUs are a mask, not a count.
+    u64 slowest = 0;
+    for (u32 cpu = 1; cpu <= started; ++cpu) {
+        ApBoot& ap = s_ap_boot[cpu];
+        u32 expected = kStarting;
+        if (ap.state.compare_exchange_strong(expected, kAbandoned,
+                                             memory_order_acq_rel,
+                                             memory_order_acquire)) {
+            Fmt::printf("SMP: CPU {} (LAPIC {}) did not come up\n", cpu, ap.lapic_id);
+            continue;
+        }
+        s_online_mask.set(cpu);
+        const u64 us = ktl::clock::cycles_to_ns(ap.ready_tsc - ap.start_tsc) / 1000;
+        slowest = us > slowest ? us : slowest;
+        if constexpr (kDebugMode) {
+            Fmt::printf("SMP: CPU {} (LAPIC {}) up in {} us\n", cpu, ap.lapic_id, us);
+        }
+    }
+
+    const u32 online = static_cast<u32>(s_online_mask.count());
+    s_online.store(online, memory_order_relaxed);
+    s_released.store(true, memory_order_release);
+
+    Fmt::printf("SMP: {} of {} CPUs online ({}), slowest AP {} us\n",
+                online, mp->cpu_count, s_x2apic ? "x2APIC" : "xAPIC", slowest);
+}
+
+u32 Smp::cpuCount() {
+    return s_online.load(memory_order_relaxed);
+}
+
+bool Smp::online(u32 cpu) {
+    return cpu < kMaxCpus && s_online_mask.test(cpu);
+}
+
+u32 Smp::nextOnline(u32 from) {
+    if (from >= kMaxCpus) {
+        return kMaxCpus;
+    }
+    const usize cpu = s_online_mask.find_next_set(from);
+    return cpu == s_online_mask.npos ? kMaxCpus : static_cast<u32>(cpu);
+}
+
+u32 Smp::nextOnlineAfter(u32 cpu) {
+    const u32 next = nextOnline(cpu + 1);
+    return next < kMaxCpus ? next : nextOnline(0);
+}
+
+u32 Smp::lapicId(u32 cpu) {
+    return s_lapic_ids[cpu];
+}
+
+void Smp::haltOthers() {
+    if (s_halting.exchange(true, memory_order_acq_rel) || !Lapic::available()) {
+        return;
+    }
+    Lapic::sendNmiAllButSelf();
+}
+
+bool Smp::halting() {
+    return s_halting.load(memory_order_acquire);
+}
@@ -0,0 +1,47 @@
+#ifndef SMP_HH
+#define SMP_HH
+
+// Application processor bring-up. Limine parks every AP in a spin loop;
+// init() hands each one a CPU index and a kernel stack, and waits until
+// all of them have loaded their own GDT/TSS and the IDT and reached the
+// init barrier. After that each AP runs its scheduler idle loop.
+//
+// The boot CPU is Cpu::kBootCpu, the APs follow in the order Limine lists
+// them. CPUs past kMaxCpus are left parked. An AP that misses the init
+// timeout keeps its index but never goes online, so the online indices
+// may have holes: walk them with for_each_online_cpu, not up to
+// cpuCount().
+class Smp {
+public:
+    static void init();
+
+    // CPUs that reached the init barrier, the boot CPU included.
+    static u32 cpuCount();
+
+    static bool online(u32 cpu);
+
+    // The first online CPU index >= from, or kMaxCpus if there is none.
+    static u32 nextOnline(u32 from);
+
+    // The online CPU after cpu, wrapping around to the lowest; cpu itself
+    // if no other is online. For visiting the others starting next door.
+    static u32 nextOnlineAfter(u32 cpu);
+
+    // Local APIC ID of a CPU index, for addressing IPIs.
+    static u32 lapicId(u32 cpu);
+
+    // Stops every other CPU with an NMI. Only the first caller sends it, so
+    // CPUs that panic at the same time do not keep interrupting each other.
+    // Without x2APIC there is no way to send the IPI yet (the xAPIC page is
+    // not mapped), and the other CPUs are left running.
+    static void haltOthers();
+
+    // True once haltOthers() has been called; the NMI handler uses it to
+    // tell a halt request from a real NMI.
+    static bool halting();
+};
+
+#define for_each_online_cpu(_cpu_)                                            \
+    for (u32 _cpu_ = Smp::nextOnline(0); _cpu_ < kMaxCpus; _cpu_ = Smp::nextOnline(_cpu_ + 1))
+
+#endif // SMP_HH
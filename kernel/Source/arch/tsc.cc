@@ -0,0 +1,55 @@
+#include <arch/tsc.hh>
+#include <arch/cpuid.hh>
+#include <arch/io.hh>
+#include <arch/pit.hh>
+
+namespace {
+
+constexpr u32 kPitWindowUs = 20'000;
+constexpr u32 kPitRuns     = 3;
+
+// Leaf 0x15: TSC = crystal * EBX / EAX, crystal in Hz in ECX. Parts that
+// leave ECX zero give the base frequency in MHz in leaf 0x16 instead.
+u64 fromCpuid() {
+    if (Cpuid::maxLeaf() < 0x15) {
+        return 0;
+    }
+    const Cpuid::Leaf ratio = Cpuid::query(0x15);
+    if (ratio.eax == 0 || ratio.ebx == 0) {
+        return 0;
+    }
+    if (ratio.ecx != 0) {
+        return static_cast<u64>(ratio.ecx) * ratio.ebx / ratio.eax;
+    }
+    if (Cpuid::maxLeaf() >= 0x16) {
+        return static_cast<u64>(Cpuid::query(0x16).eax & 0xFFFF) * 1'000'000;
+    }
+    return 0;
+}
+
+// The shortest of a few runs: anything that delays a run (an SMI, a host
+// preempting the vCPU) only ever makes it look longer.
+u64 fromPit() {
+    u64 best = ~0ULL;
+    const u64 flags = io::irqSave();
+    for (u32 i = 0; i < kPitRuns; ++i) {
+        const u64 start = Tsc::readOrdered();
+        Pit::waitMicros(kPitWindowUs);
+        const u64 cycles = Tsc::readOrdered() - start;
+        best = cycles < best ? cycles : best;
+    }
+    io::irqRestore(flags);
+    return best * 1'000'000 / kPitWindowUs;
+}
+
+} // namespace
+
+void Tsc::calibrate() {
+    if (const u64 hz = fromCpuid()) {
+        s_frequency = hz;
+        s_source    = "cpuid";
+    } else {
+        s_frequency = fromPit();
+        s_source    = "pit";
+    }
+}
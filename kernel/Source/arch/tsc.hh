@@ -0,0 +1,40 @@
+#ifndef TSC_HH
+#define TSC_HH
+
+class Tsc {
+public:
+    // Works out the TSC frequency: from CPUID leaf 0x15 (and 0x16 when
+    // the crystal is not enumerated) if the CPU reports it, else by timing
+    // the PIT. The HPET would be a better reference than the PIT, but it
+    // sits in MMIO nothing maps yet.
+    static void calibrate();
+
+    static u64         frequency()       { return s_frequency; }
+    static const char* frequencySource() { return s_source; }
+
+    static u64 read() {
+        u32 low, high;
+        __asm__ volatile ("rdtsc" : "=a"(low), "=d"(high));
+        return (static_cast<u64>(high) << 32) | low;
+    }
+
+    // lfence on both sides keeps earlier work from drifting past the read
+    // and later work from starting before it, which is what a measurement
+    // window needs.
+    static u64 readOrdered() {
+        u32 low, high;
+        __asm__ volatile ("lfence \n\t"
+                          "rdtsc  \n\t"
+                          "lfence"
+                          : "=a"(low), "=d"(high)
+                          :
+                          : "memory");
+        return (static_cast<u64>(high) << 32) | low;
+    }
+
+private:
+    static inline u64         s_frequency = 0;
+    static inline const char* s_source    = "none";
+};
+
+#endif // TSC_HH
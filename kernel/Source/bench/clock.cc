@@ -0,0 +1,39 @@
+#include <ktl/bench>
+#include <ktl/clock>
+#include <arch/tsc.hh>
+
+// Reading the clock: a bare rdtsc for reference, then now() (seqlock read,
+// rdtsc, multiply and shift) and the ns <-> cycles conversions the timer
+// code uses.
+
+KTL_BENCH(clock_rdtsc) {
+    u64 sum = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        sum += Tsc::read();
+    }
+    ktl::bench::doNotOptimize(sum);
+}
+
+KTL_BENCH(clock_now) {
+    u64 sum = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        sum += ktl::clock::now();
+    }
+    ktl::bench::doNotOptimize(sum);
+}
+
+KTL_BENCH(clock_realtime) {
+    u64 sum = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        sum += ktl::clock::realtime();
+    }
+    ktl::bench::doNotOptimize(sum);
+}
+
+KTL_BENCH(clock_ns_to_cycles) {
+    u64 sum = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        sum += ktl::clock::ns_to_cycles(i);
+    }
+    ktl::bench::doNotOptimize(sum);
+}
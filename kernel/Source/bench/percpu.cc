@@ -0,0 +1,39 @@
+#include <ktl/bench>
+#include <ktl/atomic>
+#include <arch/cpu.hh>
+#include <arch/percpu.hh>
+
+// Bumping a statistic: a per-CPU counter (one gs-relative add) against a
+// shared atomic, which is a locked read-modify-write on a line every CPU
+// writes. Single-CPU numbers only show the lock prefix; the shared line's
+// migration cost comes on top once several CPUs count at once.
+
+namespace {
+
+PER_CPU PerCpuCounter s_counter;
+
+ktl::atomic<u64> s_shared { 0 };
+
+} // namespace
+
+KTL_BENCH(percpu_counter_inc) {
+    for (u64 i = 0; i < iters; ++i) {
+        s_counter.inc();
+    }
+    ktl::bench::doNotOptimize(s_counter.sum());
+}
+
+KTL_BENCH(percpu_atomic_inc) {
+    for (u64 i = 0; i < iters; ++i) {
+        s_shared.fetch_add(1, ktl::memory_order_relaxed);
+    }
+    ktl::bench::doNotOptimize(s_shared.load(ktl::memory_order_relaxed));
+}
+
+KTL_BENCH(percpu_current_id) {
+    u64 sum = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        sum += Cpu::currentId();
+    }
+    ktl::bench::doNotOptimize(sum);
+}
@@ -0,0 +1,184 @@
+#include <arch/cpu.hh>
+#include <arch/idt.hh>
+#include <arch/smp.hh>
+#include <core/sched.hh>
+#include <ktl/atomic>
+#include <ktl/bench>
+#include <ktl/rcu>
+#include <ktl/rcu_list>
+
+// Read-side cost of the RCU-published IDT handler table and of rcu_list,
+// plus the writer-side price of a grace period. The handler-swap bench
+// doubles as a stress test: a thread pinned to every other online CPU
+// raises the vector in a loop while the calling CPU replaces the table, and
+// every interrupt raised on any CPU must land in exactly one of the two
+// handlers. Run it with BENCH_SMP > 1; on one CPU only the swapper raises.
+//
+// With only the boot CPU online a grace period is the cost of one scan over
+// the per-CPU state; with more it waits for a tick on each busy CPU.
+
+namespace {
+
+constexpr u16 kTestVector = 0x40;
+
+u64 s_hits = 0;
+
+void handler(registers_ctx*) { ++s_hits; }
+
+// The swap bench's handlers run on every CPU at once.
+ktl::atomic<u64> s_hits_a { 0 };
+ktl::atomic<u64> s_hits_b { 0 };
+
+void handlerA(registers_ctx*) { s_hits_a.fetch_add(1, ktl::memory_order_relaxed); }
+void handlerB(registers_ctx*) { s_hits_b.fetch_add(1, ktl::memory_order_relaxed); }
+
+ktl::atomic<bool> s_raisers_stop { false };
+ktl::atomic<u32>  s_raisers_started { 0 };
+ktl::atomic<u32>  s_raisers_done { 0 };
+ktl::atomic<u64>  s_raised { 0 };
+
+inline void raise() {
+    __asm__ volatile("int %0" : : "i"(kTestVector) : "memory");
+}
+
+struct Entry {
+    u64                 key;
+    ktl::rcu_list_node  link;
+};
+
+} // namespace
+
+KTL_BENCH(rcu_idt_dispatch) {
+    InterruptDescriptorTable::replaceHandler(kTestVector, handler);
+    s_hits = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        raise();
+    }
+    if (s_hits != iters) {
+        InterruptDescriptorTable::kpanic(nullptr, "rcu_idt_dispatch: {} of {} interrupts handled",
+                                         s_hits, iters);
+    }
+    InterruptDescriptorTable::replaceHandler(kTestVector, nullptr);
+}
+
+// Same path with a handler that carries its own state instead of a global.
+KTL_BENCH(rcu_idt_dispatch_stateful) {
+    u64 hits = 0;
+    InterruptDescriptorTable::replaceHandler(kTestVector, [&hits](registers_ctx*) { ++hits; });
+    for (u64 i = 0; i < iters; ++i) {
+        raise();
+    }
+    InterruptDescriptorTable::replaceHandler(kTestVector, nullptr);
+    if (hits != iters) {
+        InterruptDescriptorTable::kpanic(nullptr, "rcu_idt_dispatch_stateful: {} of {} interrupts handled",
+                                         hits, iters);
+    }
+}
+
+KTL_BENCH(rcu_idt_handler_swap) {
+    constexpr u64 kRaisesPerSwap = 8;
+
+    s_hits_a.store(0, ktl::memory_order_relaxed);
+    s_hits_b.store(0, ktl::memory_order_relaxed);
+    s_raised.store(0, ktl::memory_order_relaxed);
+    s_raisers_stop.store(false, ktl::memory_order_relaxed);
+    s_raisers_started.store(0, ktl::memory_order_relaxed);
+    s_raisers_done.store(0, ktl::memory_order_relaxed);
+    InterruptDescriptorTable::replaceHandler(kTestVector, handlerA);
+
+    const u32 self = Cpu::currentId();
+    u32 raisers = 0;
+    for_each_online_cpu(cpu) {
+        if (cpu == self) {
+            continue;
+        }
+        const Thread* t = Scheduler::spawn("rcu-raiser", [] {
+            s_raisers_started.fetch_add(1, ktl::memory_order_release);
+            u64 raised = 0;
+            while (!s_raisers_stop.load(ktl::memory_order_relaxed)) {
+                raise();
+                ++raised;
+            }
+            s_raised.fetch_add(raised, ktl::memory_order_relaxed);
+            s_raisers_done.fetch_add(1, ktl::memory_order_release);
+        }, cpu);
+        if (t != nullptr) {
+            ++raisers;
+        }
+    }
+    while (s_raisers_started.load(ktl::memory_order_acquire) < raisers) {
+        Scheduler::yield();
+    }
+
+    for (u64 i = 0; i < iters; ++i) {
+        InterruptDescriptorTable::replaceHandler(kTestVector, (i & 1) ? handlerA : handlerB);
+        for (u64 j = 0; j < kRaisesPerSwap; ++j) {
+            raise();
+        }
+    }
+
+    s_raisers_stop.store(true, ktl::memory_order_relaxed);
+    while (s_raisers_done.load(ktl::memory_order_acquire) < raisers) {
+        Scheduler::yield();
+    }
+
+    const u64 hits_a   = s_hits_a.load(ktl::memory_order_relaxed);
+    const u64 hits_b   = s_hits_b.load(ktl::memory_order_relaxed);
+    const u64 expected = iters * kRaisesPerSwap + s_raised.load(ktl::memory_order_relaxed);
+    if (hits_a + hits_b != expected) {
+        InterruptDescriptorTable::kpanic(nullptr, "rcu_idt_handler_swap: {} + {} of {} interrupts handled",
+                                         hits_a, hits_b, expected);
+    }
+    InterruptDescriptorTable::replaceHandler(kTestVector, nullptr);
+}
+
+KTL_BENCH(rcu_synchronize) {
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::synchronize_rcu();
+    }
+}
+
+KTL_BENCH(rcu_call_batch) {
+    constexpr u64 kBatch = 16;
+
+    // Callbacks run on whichever CPU sees the grace period end.
+    static ktl::atomic<u64> s_freed;
+    ktl::rcu_head heads[kBatch];
+
+    s_freed.store(0, ktl::memory_order_relaxed);
+    for (u64 i = 0; i < iters; ++i) {
+        for (auto& head : heads) {
+            ktl::call_rcu(&head, [](ktl::rcu_head*) { s_freed.fetch_add(1, ktl::memory_order_release); });
+        }
+        // The heads are reused next round, so wait for the whole batch
+        // rather than a fixed number of quiescent states: with other CPUs
+        // online the grace period also waits for their ticks.
+        const u64 freed = (i + 1) * kBatch;
+        while (s_freed.load(ktl::memory_order_acquire) < freed) {
+            ktl::rcu_quiescent_state();
+        }
+    }
+    if (s_freed.load(ktl::memory_order_relaxed) != iters * kBatch) {
+        InterruptDescriptorTable::kpanic(nullptr, "rcu_call_batch: {} of {} callbacks ran",
+                                         s_freed.load(ktl::memory_order_relaxed), iters * kBatch);
+    }
+}
+
+KTL_BENCH(rcu_list_walk_64) {
+    Entry entries[64];
+    ktl::rcu_list<Entry, &Entry::link> list;
+    for (u64 i = 0; i < 64; ++i) {
+        entries[i].key = i;
+        list.push_back(entries[i]);
+    }
+
+    u64 sum = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::rcu_read_lock();
+        for (Entry& e : list) {
+            sum += e.key;
+        }
+        ktl::rcu_read_unlock();
+    }
+    ktl::bench::doNotOptimize(sum);
+}
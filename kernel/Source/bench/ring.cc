@@ -0,0 +1,42 @@
+#include <ktl/bench>
+#include <ktl/ring>
+
+// Per-operation cost of the ktl queues with the producer and consumer on
+// the same CPU. Cross-CPU throughput and latency are in host/bench/ring.cc
+// until the kernel brings up the APs.
+
+namespace {
+
+constexpr usize kCapacity = 256;
+constexpr usize kBatch    = 16;
+
+ktl::spsc_ring<u64, kCapacity> s_spsc;
+ktl::mpmc_queue<u64, kCapacity> s_mpmc;
+
+template<typename Queue>
+void pushPop(Queue& q, u64 iters) {
+    u64 value = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        q.try_push(i);
+        q.try_pop(value);
+    }
+    ktl::bench::doNotOptimize(value);
+}
+
+// iters counts elements, moved kBatch at a time.
+template<typename Queue>
+void pushPopBulk(Queue& q, u64 iters) {
+    u64 items[kBatch] = {};
+    for (u64 i = 0; i < iters; i += kBatch) {
+        q.push_bulk(items, kBatch);
+        q.pop_bulk(items, kBatch);
+    }
+    ktl::bench::doNotOptimize(items[0]);
+}
+
+} // namespace
+
+KTL_BENCH(ring_spsc_push_pop)      { pushPop(s_spsc, iters); }
+KTL_BENCH(ring_spsc_push_pop_b16)  { pushPopBulk(s_spsc, iters); }
+KTL_BENCH(ring_mpmc_push_pop)      { pushPop(s_mpmc, iters); }
+KTL_BENCH(ring_mpmc_push_pop_b16)  { pushPopBulk(s_mpmc, iters); }
@@ -0,0 +1,126 @@
+#include <ktl/bench>
+#include <ktl/atomic>
+#include <arch/cpu.hh>
+#include <arch/fpu.hh>
+#include <core/sched.hh>
+
+// Fork-join over kernel threads: iters short tasks (a few thousand cycles
+// of arithmetic each), at most kInFlight outstanding, joined by polling a
+// counter between yields. Tasks are spawned on the calling CPU, and idle
+// CPUs are kicked to steal them, so cycles/op should fall as CPUs are
+// added; compare runs of `make bench` with different BENCH_SMP values. The
+// pinned variant keeps every task on the calling CPU as the one-CPU
+// baseline at any CPU count.
+//
+// The yield benches show the cost of a trip through schedule(): with
+// nothing else runnable, and with one pinned partner thread, where each
+// yield is a switch there and back. The pingpong runs once per FPU policy,
+// with threads that never touch the vector registers and with threads
+// that write xmm0 after every switch: eager pays a save and restore per
+// switch either way, lazy nothing in the first case and an #NM trap plus
+// restore per switch in the second.
+
+namespace {
+
+constexpr u64 kInFlight = 64;
+constexpr u32 kTaskWork = 1000;
+
+ktl::atomic<u64>  s_done { 0 };
+ktl::atomic<bool> s_stop { false };
+ktl::atomic<bool> s_partner_done { false };
+bool              s_touch_fpu = false;
+
+void touchFpu() {
+    __asm__ volatile ("pxor %%xmm0, %%xmm0" ::: "memory");
+}
+
+void task() {
+    u64 x = 0x9e3779b97f4a7c15ULL;
+    for (u32 i = 0; i < kTaskWork; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+    ktl::bench::doNotOptimize(x);
+    s_done.fetch_add(1, ktl::memory_order_release);
+}
+
+void forkJoin(u64 iters, u32 cpu) {
+    s_done.store(0, ktl::memory_order_relaxed);
+    u64 spawned = 0;
+    while (spawned < iters) {
+        if (spawned - s_done.load(ktl::memory_order_acquire) >= kInFlight
+            || Scheduler::spawn("task", task, cpu) == nullptr) {
+            Scheduler::yield();
+            continue;
+        }
+        ++spawned;
+    }
+    while (s_done.load(ktl::memory_order_acquire) < iters) {
+        Scheduler::yield();
+    }
+}
+
+void partner() {
+    while (!s_stop.load(ktl::memory_order_relaxed)) {
+        Scheduler::yield();
+        if (s_touch_fpu) {
+            touchFpu();
+        }
+    }
+    s_partner_done.store(true, ktl::memory_order_release);
+}
+
+void pingPong(u64 iters, Fpu::Policy policy, bool touch_fpu) {
+    const Fpu::Policy saved = Fpu::policy();
+    Fpu::setPolicy(policy);
+    s_touch_fpu = touch_fpu;
+    s_stop.store(false, ktl::memory_order_relaxed);
+    s_partner_done.store(false, ktl::memory_order_relaxed);
+    Scheduler::spawn("partner", partner, Cpu::currentId());
+
+    for (u64 i = 0; i < iters; ++i) {
+        Scheduler::yield();
+        if (touch_fpu) {
+            touchFpu();
+        }
+    }
+
+    s_stop.store(true, ktl::memory_order_relaxed);
+    while (!s_partner_done.load(ktl::memory_order_acquire)) {
+        Scheduler::yield();
+    }
+    Fpu::setPolicy(saved);
+}
+
+} // namespace
+
+KTL_BENCH(sched_fork_join) {
+    forkJoin(iters, Scheduler::kAnyCpu);
+}
+
+KTL_BENCH(sched_fork_join_pinned) {
+    forkJoin(iters, Cpu::currentId());
+}
+
+KTL_BENCH(sched_yield_alone) {
+    for (u64 i = 0; i < iters; ++i) {
+        Scheduler::yield();
+    }
+}
+
+KTL_BENCH(sched_pingpong_eager) {
+    pingPong(iters, Fpu::Policy::Eager, false);
+}
+
+KTL_BENCH(sched_pingpong_lazy) {
+    pingPong(iters, Fpu::Policy::Lazy, false);
+}
+
+KTL_BENCH(sched_pingpong_fpu_eager) {
+    pingPong(iters, Fpu::Policy::Eager, true);
+}
+
+KTL_BENCH(sched_pingpong_fpu_lazy) {
+    pingPong(iters, Fpu::Policy::Lazy, true);
+}
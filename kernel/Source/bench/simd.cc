@@ -0,0 +1,85 @@
+#include <ktl/bench>
+#include <arch/fpu.hh>
+#include <arch/simd.hh>
+
+// The cost of an FPU section on its own, and the vector kernels against the
+// scalar ones at the sizes around the thresholds in arch/simd.hh. Re-run
+// these when changing those thresholds.
+
+namespace {
+
+alignas(4096) u8 s_src[64 * 1024];
+alignas(4096) u8 s_dst[64 * 1024];
+
+template<usize N>
+void checksumScalar(u64 iters) {
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::bench::doNotOptimize(kSimdScalarKernels.checksum(s_src, N));
+        ktl::bench::clobberMemory();
+    }
+}
+
+template<usize N>
+void checksumVector(u64 iters) {
+    const auto& k = Simd::kernels();
+    for (u64 i = 0; i < iters; ++i) {
+        KernelFpuGuard fpu;
+        ktl::bench::doNotOptimize(k.checksum(s_src, N));
+        ktl::bench::clobberMemory();
+    }
+}
+
+} // namespace
+
+KTL_BENCH(simd_fpu_section) {
+    for (u64 i = 0; i < iters; ++i) {
+        KernelFpuGuard fpu;
+        ktl::bench::clobberMemory();
+    }
+}
+
+KTL_BENCH(simd_checksum_1k_scalar)  { checksumScalar<1024>(iters); }
+KTL_BENCH(simd_checksum_1k_vector)  { checksumVector<1024>(iters); }
+KTL_BENCH(simd_checksum_2k_scalar)  { checksumScalar<2048>(iters); }
+KTL_BENCH(simd_checksum_2k_vector)  { checksumVector<2048>(iters); }
+KTL_BENCH(simd_checksum_16k_scalar) { checksumScalar<16 * 1024>(iters); }
+KTL_BENCH(simd_checksum_16k_vector) { checksumVector<16 * 1024>(iters); }
+
+KTL_BENCH(simd_memcpy_64k_scalar) {
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::bench::doNotOptimize(kSimdScalarKernels.memcpy(s_dst, s_src, sizeof(s_dst)));
+        ktl::bench::clobberMemory();
+    }
+}
+
+KTL_BENCH(simd_memcpy_64k_vector) {
+    const auto& k = Simd::kernels();
+    for (u64 i = 0; i < iters; ++i) {
+        KernelFpuGuard fpu;
+        ktl::bench::doNotOptimize(k.memcpy(s_dst, s_src, sizeof(s_dst)));
+        ktl::bench::clobberMemory();
+    }
+}
+
+KTL_BENCH(simd_page_equal_scalar) {
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::bench::doNotOptimize(kSimdScalarKernels.pageEqual(s_dst, s_src));
+        ktl::bench::clobberMemory();
+    }
+}
+
+KTL_BENCH(simd_page_equal_vector) {
+    const auto& k = Simd::kernels();
+    for (u64 i = 0; i < iters; ++i) {
+        KernelFpuGuard fpu;
+        ktl::bench::doNotOptimize(k.pageEqual(s_dst, s_src));
+        ktl::bench::clobberMemory();
+    }
+}
+
+KTL_BENCH(simd_dispatch_checksum_4k) {
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::bench::doNotOptimize(Simd::checksum(s_src, 4096));
+        ktl::bench::clobberMemory();
+    }
+}
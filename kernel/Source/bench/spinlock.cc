@@ -0,0 +1,209 @@
+#include <arch/cpu.hh>
+#include <arch/smp.hh>
+#include <core/sched.hh>
+#include <ktl/atomic>
+#include <ktl/bench>
+#include <ktl/seqlock>
+#include <ktl/spinlock>
+
+// Uncontended acquire/release cost of each lock flavour, then contended
+// throughput and fairness: one worker per online CPU against the ticket
+// lock, the MCS lock and the test-and-set lock SpinLock used to be.
+// Compare `make bench` runs with BENCH_SMP=1 up to 8. Reader scaling is
+// still only measured by host/bench/rwlock.cc.
+
+namespace {
+
+template<typename Lock>
+void lockUnlock(u64 iters) {
+    Lock lock;
+    u64 counter = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::AutoLock<Lock> guard(lock);
+        ++counter;
+        ktl::bench::clobberMemory();
+    }
+    ktl::bench::doNotOptimize(counter);
+}
+
+template<typename Lock>
+void lockUnlockIrqSave(u64 iters) {
+    Lock lock;
+    u64 counter = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::IrqAutoLock<Lock> guard(lock);
+        ++counter;
+        ktl::bench::clobberMemory();
+    }
+    ktl::bench::doNotOptimize(counter);
+}
+
+} // namespace
+
+KTL_BENCH(spinlock_ticket)         { lockUnlock<ktl::TicketLock>(iters); }
+KTL_BENCH(spinlock_ticket_irqsave) { lockUnlockIrqSave<ktl::TicketLock>(iters); }
+KTL_BENCH(spinlock_mcs)            { lockUnlock<ktl::McsLock>(iters); }
+KTL_BENCH(spinlock_mcs_irqsave)    { lockUnlockIrqSave<ktl::McsLock>(iters); }
+
+namespace {
+
+// The test-and-set lock ktl::SpinLock used to be, kept as the baseline.
+class TasLock {
+    alignas(1) volatile u8 _flag = 0;
+
+public:
+    void lock() noexcept {
+        ktl::hooks::preempt_disable();
+        u8 tmp = 1;
+        for (;;) {
+            asm volatile ("lock xchg %0, %1"
+                        : "+r"(tmp), "+m"(_flag)
+                        :
+                        : "memory");
+            if (tmp == 0)
+                return;
+            tmp = 1;
+        }
+    }
+
+    void unlock() noexcept {
+        asm volatile ("" ::: "memory");
+        _flag = 0;
+        asm volatile ("" ::: "memory");
+        ktl::hooks::preempt_enable();
+    }
+};
+
+// Every online CPU races to take the lock until `iters` critical sections
+// have run in total: the calling CPU directly, the others from a thread
+// pinned there. All start together once every worker is running.
+// cycles/op is per critical section; fairness_pct is the fewest
+// acquisitions any CPU got as a percentage of the most (100 = perfectly
+// even). With one CPU it is the uncontended cost plus the loop.
+template<typename Lock>
+struct Contention {
+    Lock             lock;
+    u64              done = 0;
+    u64              total = 0;
+    u64              acquired[kMaxCpus] = {};
+    ktl::atomic<u32> started { 0 };
+    ktl::atomic<u32> finished { 0 };
+    ktl::atomic<bool> go { false };
+
+    void work(u32 cpu) {
+        u64 mine = 0;
+        for (;;) {
+            ktl::AutoLock<Lock> guard(lock);
+            if (done == total) {
+                break;
+            }
+            done = done + 1;
+            ktl::bench::clobberMemory();
+            ++mine;
+        }
+        acquired[cpu] = mine;
+    }
+};
+
+template<typename Lock>
+void contended(u64 iters) {
+    Contention<Lock> c;
+    c.total = iters;
+
+    const u32 self = Cpu::currentId();
+    bool joined[kMaxCpus] = {};
+    joined[self] = true;
+    u32 workers = 0;
+    for_each_online_cpu(cpu) {
+        if (cpu == self) {
+            continue;
+        }
+        const Thread* t = Scheduler::spawn("lock-worker", [&c, cpu] {
+            c.started.fetch_add(1, ktl::memory_order_release);
+            while (!c.go.load(ktl::memory_order_acquire)) {
+                io::pause();
+            }
+            c.work(cpu);
+            c.finished.fetch_add(1, ktl::memory_order_release);
+        }, cpu);
+        if (t != nullptr) {
+            joined[cpu] = true;
+            ++workers;
+        }
+    }
+    while (c.started.load(ktl::memory_order_acquire) < workers) {
+        io::pause();
+    }
+
+    c.go.store(true, ktl::memory_order_release);
+    c.work(self);
+    while (c.finished.load(ktl::memory_order_acquire) < workers) {
+        io::pause();
+    }
+
+    u64 least = c.acquired[self];
+    u64 most  = c.acquired[self];
+    for_each_online_cpu(cpu) {
+        if (!joined[cpu]) {
+            continue;
+        }
+        if (c.acquired[cpu] < least) least = c.acquired[cpu];
+        if (c.acquired[cpu] > most)  most  = c.acquired[cpu];
+    }
+    ktl::bench::counter("fairness_pct", most ? least * 100 / most : 100);
+}
+
+} // namespace
+
+KTL_BENCH(spinlock_tas_contended)    { contended<TasLock>(iters); }
+KTL_BENCH(spinlock_ticket_contended) { contended<ktl::TicketLock>(iters); }
+KTL_BENCH(spinlock_mcs_contended)    { contended<ktl::McsLock>(iters); }
+
+namespace {
+
+struct Record {
+    u64 a, b, c, d;
+};
+
+} // namespace
+
+KTL_BENCH(spinlock_rw_read) {
+    ktl::rw_spinlock lock;
+    Record value {};
+    u64 sum = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::SharedAutoLock<ktl::rw_spinlock> guard(lock);
+        sum += value.a;
+        ktl::bench::clobberMemory();
+    }
+    ktl::bench::doNotOptimize(sum);
+}
+
+KTL_BENCH(spinlock_rw_write) {
+    ktl::rw_spinlock lock;
+    u64 value = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::AutoLock<ktl::rw_spinlock> guard(lock);
+        ++value;
+        ktl::bench::clobberMemory();
+    }
+    ktl::bench::doNotOptimize(value);
+}
+
+KTL_BENCH(spinlock_seqlock_read) {
+    ktl::seqlocked<Record> value;
+    u64 sum = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        sum += value.load().a;
+        ktl::bench::clobberMemory();
+    }
+    ktl::bench::doNotOptimize(sum);
+}
+
+KTL_BENCH(spinlock_seqlock_write) {
+    ktl::seqlocked<Record> value;
+    for (u64 i = 0; i < iters; ++i) {
+        value.store(Record { i, i, i, i });
+    }
+    ktl::bench::doNotOptimize(value);
+}
@@ -0,0 +1,100 @@
+#include <ktl/bench>
+#include <util/string.h>
+
+// util/string.c at the sizes the kernel actually uses: short copies for
+// descriptors and strings, pages, and large buffers.
+
+namespace {
+
+constexpr usize kBufferSize = 64 * 1024;
+
+alignas(4096) u8 s_src[kBufferSize + 64];
+alignas(4096) u8 s_dst[kBufferSize + 64];
+char s_text[4096 + 1];
+
+void copyLoop(u64 iters, void* dst, const void* src, usize n) {
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::bench::doNotOptimize(memcpy(dst, src, n));
+        ktl::bench::clobberMemory();
+    }
+}
+
+const char* text(usize len) {
+    memset(s_text, 'a', sizeof(s_text) - 1);
+    s_text[len] = '\0';
+    return s_text;
+}
+
+} // namespace
+
+KTL_BENCH(string_memcpy_64) {
+    copyLoop(iters, s_dst, s_src, 64);
+}
+
+KTL_BENCH(string_memcpy_64_unaligned) {
+    copyLoop(iters, s_dst + 3, s_src + 1, 64);
+}
+
+KTL_BENCH(string_memcpy_4k) {
+    copyLoop(iters, s_dst, s_src, 4096);
+}
+
+KTL_BENCH(string_memcpy_64k) {
+    copyLoop(iters, s_dst, s_src, kBufferSize);
+}
+
+KTL_BENCH(string_memmove_4k_overlap) {
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::bench::doNotOptimize(memmove(s_dst + 8, s_dst, 4096));
+        ktl::bench::clobberMemory();
+    }
+}
+
+KTL_BENCH(string_memset_4k) {
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::bench::doNotOptimize(memset(s_dst, static_cast<int>(i), 4096));
+        ktl::bench::clobberMemory();
+    }
+}
+
+KTL_BENCH(string_memcmp_4k) {
+    memset(s_src, 0x5A, 4096);
+    memset(s_dst, 0x5A, 4096);
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::bench::doNotOptimize(memcmp(s_dst, s_src, 4096));
+    }
+}
+
+KTL_BENCH(string_strlen_64) {
+    const char* s = text(64);
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::bench::doNotOptimize(strlen(s));
+        ktl::bench::clobberMemory();
+    }
+}
+
+KTL_BENCH(string_strlen_4k) {
+    const char* s = text(4096);
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::bench::doNotOptimize(strlen(s));
+        ktl::bench::clobberMemory();
+    }
+}
+
+KTL_BENCH(string_memchr_4k) {
+    const char* s = text(4096);
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::bench::doNotOptimize(memchr(s, 'b', 4096));
+        ktl::bench::clobberMemory();
+    }
+}
+
+KTL_BENCH(string_strcmp_4k) {
+    const char* s = text(4096);
+    memcpy(s_dst, s, 4096 + 1);
+    const char* t = reinterpret_cast<const char*>(s_dst);
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::bench::doNotOptimize(strcmp(s, t));
+        ktl::bench::clobberMemory();
+    }
+}
@@ -0,0 +1,81 @@
+#include <ktl/bench>
+#include <ktl/clock>
+#include <core/timer.hh>
+
+// Arming and cancelling through the per-CPU timer API, with kBackground
+// other timers pending on the CPU. Everything is due a minute or more out,
+// so nothing fires and no LAPIC write happens after the first arm; ns/op
+// is one arm plus one cancel, locking and interrupt masking included. The
+// data structures alone, at a million pending timers, are measured on the
+// host (host/bench/timer.cc).
+
+namespace {
+
+constexpr usize kBackground = 1024;
+constexpr u64   kFarNs      = 60'000'000'000ULL;
+
+Timer   s_wheel_background[kBackground];
+HrTimer s_hr_background[kBackground];
+
+void noop(void*) {}
+
+u64 xorshift(u64& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// Deadlines spread over the minute after kFarNs.
+template<typename T>
+void armBackground(T (&timers)[kBackground]) {
+    u64 seed = 0x9e3779b97f4a7c15ULL;
+    const u64 base = ktl::clock::now() + kFarNs;
+    for (T& t : timers) {
+        t.func = noop;
+        Timers::arm(t, base + xorshift(seed) % kFarNs);
+    }
+}
+
+template<typename T>
+void cancelBackground(T (&timers)[kBackground]) {
+    for (T& t : timers) {
+        Timers::cancel(t);
+    }
+}
+
+template<typename T>
+void armCancel(u64 iters, T (&background)[kBackground]) {
+    armBackground(background);
+    T t;
+    t.func = noop;
+    u64 seed = 0x2545f4914f6cdd1dULL;
+    const u64 base = ktl::clock::now() + kFarNs;
+    for (u64 i = 0; i < iters; ++i) {
+        Timers::arm(t, base + xorshift(seed) % kFarNs);
+        Timers::cancel(t);
+    }
+    cancelBackground(background);
+}
+
+} // namespace
+
+KTL_BENCH(timer_wheel_arm_cancel) {
+    armCancel(iters, s_wheel_background);
+}
+
+KTL_BENCH(timer_hr_arm_cancel) {
+    armCancel(iters, s_hr_background);
+}
+
+// Moving a pending timer to a new deadline, as a retransmit timer does on
+// every ack.
+KTL_BENCH(timer_wheel_rearm) {
+    armBackground(s_wheel_background);
+    u64 seed = 0x853c49e6748fea9bULL;
+    const u64 base = ktl::clock::now() + kFarNs;
+    for (u64 i = 0; i < iters; ++i) {
+        Timers::arm(s_wheel_background[i % kBackground], base + xorshift(seed) % kFarNs);
+    }
+    cancelBackground(s_wheel_background);
+}
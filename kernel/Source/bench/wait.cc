@@ -0,0 +1,103 @@
+#include <ktl/bench>
+#include <ktl/call_once>
+#include <core/futex.hh>
+#include <core/sched.hh>
+#include <core/wait.hh>
+
+// Blocking primitives with and without anybody to block. The uncontended
+// benches are the fast paths every caller pays: a semaphore down/up pair
+// with a unit free, a futex wake of a word nobody waits on, and call_once
+// after the first call. The ping-pong benches hand a token back and forth
+// with a second thread, so ns/op covers two wakeups and two sleeps: two
+// switches when both threads share a CPU, two cross-CPU unparks when the
+// partner was stolen by another.
+
+namespace {
+
+constinit Semaphore  s_ping;
+constinit Semaphore  s_pong;
+constinit Completion s_partner_done;
+u32  s_turn = 0;   // futex word: 0 the bench's turn, 1 the partner's
+bool s_stop = false;
+
+void futexPass(u32 from, u32 to) {
+    u32 turn;
+    while ((turn = __atomic_load_n(&s_turn, __ATOMIC_ACQUIRE)) != from) {
+        Futex::wait(&s_turn, turn);
+    }
+    __atomic_store_n(&s_turn, to, __ATOMIC_RELEASE);
+    Futex::wake(&s_turn);
+}
+
+} // namespace
+
+KTL_BENCH(wait_semaphore_uncontended) {
+    Semaphore sem(1);
+    for (u64 i = 0; i < iters; ++i) {
+        sem.down();
+        sem.up();
+    }
+}
+
+KTL_BENCH(wait_futex_wake_nobody) {
+    u32 word = 0;
+    u32 woken = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        woken += Futex::wake(&word);
+    }
+    ktl::bench::doNotOptimize(woken);
+}
+
+KTL_BENCH(wait_call_once_done) {
+    ktl::once_flag flag;
+    u64 calls = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        ktl::call_once(flag, [&calls] { ++calls; });
+    }
+    ktl::bench::doNotOptimize(calls);
+}
+
+KTL_BENCH(wait_semaphore_ping_pong) {
+    s_stop = false;
+    Thread* const partner = Scheduler::spawn("bench-pong", [] {
+        for (;;) {
+            s_ping.down();
+            if (__atomic_load_n(&s_stop, __ATOMIC_ACQUIRE)) {
+                s_partner_done.complete();
+                return;
+            }
+            s_pong.up();
+        }
+    });
+    if (partner == nullptr) {
+        return;
+    }
+    for (u64 i = 0; i < iters; ++i) {
+        s_ping.up();
+        s_pong.down();
+    }
+    // The partner has to be gone before the next run resets s_stop.
+    __atomic_store_n(&s_stop, true, __ATOMIC_RELEASE);
+    s_ping.up();
+    s_partner_done.wait();
+}
+
+KTL_BENCH(wait_futex_ping_pong) {
+    s_turn = 0;
+    Thread* const partner = Scheduler::spawn("bench-pong", [iters] {
+        for (u64 i = 0; i < iters; ++i) {
+            futexPass(1, 0);
+        }
+    });
+    if (partner == nullptr) {
+        return;
+    }
+    for (u64 i = 0; i < iters; ++i) {
+        futexPass(0, 1);
+    }
+    // Wait for the partner's last hand-back.
+    u32 turn;
+    while ((turn = __atomic_load_n(&s_turn, __ATOMIC_ACQUIRE)) != 0) {
+        Futex::wait(&s_turn, turn);
+    }
+}
@@ -0,0 +1,65 @@
+#include <ktl/bench>
+#include <core/workqueue.hh>
+#include <util/string.h>
+
+// The cost of handing work to the workers, and what splitting buys on a
+// memory-bound job. submit_wait is one item queued for any worker plus the
+// wait for it: a worker wakeup and two switches on an otherwise idle
+// machine. parallel_for_empty is the fork/join overhead of a job with one
+// chunk per 64 elements and nothing to do. The zero benches clear a 4 MiB
+// buffer per op, page-sized chunk by chunk, first on the calling thread and
+// then spread over every CPU.
+
+namespace {
+
+constexpr usize kBufferSize = 4 * 1024 * 1024;
+constexpr usize kPage       = 4096;
+
+alignas(kPage) u8 s_buffer[kBufferSize];
+
+u64 s_runs = 0;
+
+void countRun(void*) {
+    __atomic_add_fetch(&s_runs, 1, __ATOMIC_RELAXED);
+}
+
+} // namespace
+
+KTL_BENCH(workqueue_submit_wait) {
+    WorkGroup group;
+    Work      work;
+    work.func  = countRun;
+    work.group = &group;
+    for (u64 i = 0; i < iters; ++i) {
+        Workqueue::submit(work);
+        Workqueue::wait(group);
+    }
+}
+
+KTL_BENCH(workqueue_parallel_for_empty) {
+    u64 elements = 0;
+    for (u64 i = 0; i < iters; ++i) {
+        Workqueue::parallelFor(0, 64 * Smp::cpuCount(), 64, [&elements](u64 first, u64 last) {
+            __atomic_add_fetch(&elements, last - first, __ATOMIC_RELAXED);
+        });
+    }
+    ktl::bench::doNotOptimize(elements);
+}
+
+KTL_BENCH(workqueue_zero_4m_serial) {
+    for (u64 i = 0; i < iters; ++i) {
+        for (usize page = 0; page < kBufferSize; page += kPage) {
+            memset(s_buffer + page, 0, kPage);
+        }
+        ktl::bench::clobberMemory();
+    }
+}
+
+KTL_BENCH(workqueue_zero_4m_parallel) {
+    for (u64 i = 0; i < iters; ++i) {
+        Workqueue::parallelFor(0, kBufferSize / kPage, 16, [](u64 first, u64 last) {
+            memset(s_buffer + first * kPage, 0, (last - first) * kPage);
+        });
+        ktl::bench::clobberMemory();
+    }
+}
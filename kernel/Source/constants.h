@@ -18,6 +18,14 @@ static constexpr bool kIdtPanicOnException = true;
 static constexpr bool kPmmZeroOnAlloc = false;
 static constexpr bool kPmmZeroOnFree = false;
 static constexpr bool kPmmUseFifo = false;
+static constexpr bool kLockStats = false;
+static constexpr unsigned kMaxCpus = 64;
+
+#ifdef YERP_BENCH
+static constexpr bool kRunBenchmarks = true;
+#else
+static constexpr bool kRunBenchmarks = false;
+#endif
 
 #include <stdint.h>
 
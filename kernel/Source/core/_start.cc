@@ -8,6 +8,22 @@
 #include <core/pmm.hh>
 
 #include <arch/efi.hh>
+#include <arch/fpu.hh>
+#include <arch/simd.hh>
+#include <arch/qemu.hh>
+#include <arch/cpu.hh>
+#include <arch/percpu.hh>
+#include <arch/cpuid.hh>
+#include <arch/smp.hh>
+#include <arch/lapic.hh>
+#include <arch/pit.hh>
+#include <core/sched.hh>
+#include <core/time.hh>
+#include <core/timer.hh>
+#include <core/workqueue.hh>
+#include <ktl/bench>
+#include <ktl/bit>
+#include <ktl/rcu>
 
 [[gnu::used, gnu::section(".limine_requests")]] static volatile LIMINE_BASE_REVISION(3);
 
@@ -23,23 +39,68 @@ static volatile LIMINE_REQUESTS_END_MARKER;
     .response = nullptr
 };
 
-extern "C" void _start(void) {
-    SerialCOM1::init();
-    SerialCOM2::init();
-    FmtBase<SerialCOM2>::print("\n ----------- \n");
+// How often idle CPUs wake up while nothing is happening: the boot CPU
+// polls the PIT for a second while every other CPU sits in its idle loop.
+// Reported on COM2 ahead of the benchmarks, for bench-json.
+static void reportIdleWakeups() {
+    constexpr u32 kWindowUs = 1'000'000;
+    constexpr u32 kStepUs   = 50'000;
+
+    const Scheduler::IdleStats before = Scheduler::idleStats();
+    for (u32 us = 0; us < kWindowUs; us += kStepUs) {
+        Pit::waitMicros(kStepUs);
+    }
+    const Scheduler::IdleStats after = Scheduler::idleStats();
+
+    const u64 wakeups = after.entries - before.entries;
+    const u64 samples = after.wake_samples - before.wake_samples;
+    FmtBase<SerialCOM2>::printf("IDLE cpus={} window_us={} wakeups_per_sec={} wake_latency_avg={}\n",
+                                Smp::cpuCount(), kWindowUs,
+                                wakeups * 1'000'000 / kWindowUs,
+                                samples ? (after.wake_total - before.wake_total) / samples : 0);
+}
+
+// First kernel thread, started on the boot CPU once every CPU is up.
+static void kernelMain() {
+    if constexpr (kRunBenchmarks) {
+        reportIdleWakeups();
+        const bool ok = ktl::bench::runAll();
+        // How often the lazy FPU policy had to take #NM over the whole run.
+        FmtBase<SerialCOM2>::printf("FPU lazy_restores={}\n", Fpu::lazyRestores());
+        Qemu::exit(ok ? Qemu::Success : Qemu::Failure);
+    }
 
     if (request.response == nullptr) Fmt::printf("Memmap is still null...\n");
 
 //     if (LIMINE_BASE_REVISION_SUPPORTED == false) {
 //         Fmt::printf("Base features not supported by limine, please update your bootloader!\n");
-//         goto hcf;
+//         return;
 //     }
 
-//     GlobalDescriptorTable::load();
-//     InterruptDescriptorTable::init();
 //     PhysicalMemoryManager::init();
+}
+
+extern "C" void _start(void) {
+    SerialCOM1::init();
+    SerialCOM2::init();
+    FmtBase<SerialCOM2>::print("\n ----------- \n");
+
+    PerCpu::init();
+    Time::init();
+
+    Fpu::init();
+    Simd::init();
+    ktl::enable_bit_instructions(Cpuid::hasPopcnt(), Cpuid::hasLzcnt());
+
+    GlobalDescriptorTable::load();
+    InterruptDescriptorTable::init();
+    ktl::rcu_cpu_online(Cpu::kBootCpu);
+    Lapic::init();
+    Timers::init();
+    Scheduler::init();
+    Smp::init();
+    Workqueue::init();
 
-// hcf:
-    io::cli();
-    for(;;) io::hlt();
+    Scheduler::spawn("kmain", kernelMain, Cpu::kBootCpu);
+    Scheduler::idleLoop();
 }
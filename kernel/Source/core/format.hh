@@ -186,6 +186,9 @@ private:
         if constexpr (ktl::is_array<U>::value) {
             print(v);
 
+        } else if constexpr (ktl::is_same_v<ktl::remove_cv_t<U>, bool>) {
+            print(static_cast<bool>(v));
+
         } else if constexpr (ktl::is_integral_v<U>) {
             u64 val = static_cast<u64>(v);
             if (type == 'x' || type == 'X') {
@@ -0,0 +1,79 @@
+#include <core/futex.hh>
+#include <ktl/hash>
+
+namespace {
+
+using ktl::memory_order_relaxed;
+using ktl::memory_order_seq_cst;
+
+// Buckets are shared by every address that hashes to them; a wake() walks
+// past the waiters of other addresses, so this wants to stay well above the
+// number of words waited on at once.
+constexpr u32 kBuckets = 256;
+
+struct alignas(64) Bucket {
+    ktl::SpinLock    lock;
+    WaiterList       waiters;
+    ktl::atomic<u32> sleepers { 0 };
+};
+
+constinit Bucket s_buckets[kBuckets];
+
+Bucket& bucketOf(const u32* addr) {
+    return s_buckets[ktl::hash<const u32*> {}(addr) & (kBuckets - 1)];
+}
+
+} // namespace
+
+bool Futex::wait(const u32* addr, u32 expected, u64 deadline) {
+    Bucket& bucket = bucketOf(addr);
+    Waiter w;
+    w.key = addr;
+    w.prepare();
+    {
+        ktl::IrqAutoLock<ktl::SpinLock> guard(bucket.lock);
+        // Counted before the word is read, as WaitQueue does; see wake().
+        bucket.sleepers.fetch_add(1, memory_order_seq_cst);
+        if (__atomic_load_n(addr, __ATOMIC_SEQ_CST) != expected) {
+            bucket.sleepers.fetch_sub(1, memory_order_relaxed);
+            return true;
+        }
+        bucket.waiters.push_back(w);
+    }
+
+    if (w.sleep(deadline)) {
+        return true;
+    }
+    ktl::IrqAutoLock<ktl::SpinLock> guard(bucket.lock);
+    if (!w.link.is_linked()) {
+        return true;   // woken just as the deadline passed
+    }
+    bucket.waiters.remove(w);
+    bucket.sleepers.fetch_sub(1, memory_order_relaxed);
+    return false;
+}
+
+u32 Futex::wake(const u32* addr, u32 count) {
+    Bucket& bucket = bucketOf(addr);
+    // The caller changed the word before this; a waiter either sees the
+    // change or is already counted.
+    ktl::atomic_thread_fence(memory_order_seq_cst);
+    if (bucket.sleepers.load(memory_order_relaxed) == 0) {
+        return 0;
+    }
+
+    ktl::IrqAutoLock<ktl::SpinLock> guard(bucket.lock);
+    u32 woken = 0;
+    for (auto it = bucket.waiters.begin(); it != bucket.waiters.end() && woken < count; ) {
+        Waiter& w = *it;
+        ++it;
+        if (w.key != addr) {
+            continue;
+        }
+        bucket.waiters.remove(w);
+        bucket.sleepers.fetch_sub(1, memory_order_relaxed);
+        w.wake();
+        ++woken;
+    }
+    return woken;
+}
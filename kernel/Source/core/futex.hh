@@ -0,0 +1,36 @@
+#ifndef FUTEX_HH
+#define FUTEX_HH
+
+#include <core/wait.hh>
+
+// Waiting on a 32-bit word in memory, as Linux's futex(2) does. Any word
+// can be waited on without setting anything up: waiters sleep in a fixed
+// table of queues hashed by the word's address, and wake() only wakes
+// those waiting on the same address.
+//
+// The word itself is the caller's: the usual pattern is an atomic state
+// that is only waited on in the states that mean "not yet", e.g.
+//
+//     while ((s = load(&state)) == kBusy) {
+//         Futex::wait(&state, s);
+//     }
+//
+// with the other side storing the new state first and then calling
+// wake(&state). wait() rechecks the word under the bucket's lock, so a
+// wake() between the load and the sleep is never lost.
+
+class Futex {
+public:
+    static constexpr u32 kAll = ~0u;
+
+    // Sleeps while *addr == expected, until a wake() on addr or deadline.
+    // Returns false only on reaching deadline; true on a wakeup or if
+    // *addr had already changed. Callers recheck the word either way.
+    static bool wait(const u32* addr, u32 expected, u64 deadline = kWaitForever);
+
+    // Wakes up to count of the threads waiting on addr, oldest first, and
+    // returns how many it woke. Any context, interrupt handlers included.
+    static u32 wake(const u32* addr, u32 count = kAll);
+};
+
+#endif // FUTEX_HH
@@ -0,0 +1,37 @@
+#ifndef PREEMPT_HH
+#define PREEMPT_HH
+
+#include <arch/percpu.hh>
+
+// Preemption control. The scheduler tick only switches threads when the
+// interrupted CPU's preempt count is zero; spinlocks and RCU read-side
+// sections raise it for as long as they are held, so a thread is never
+// switched out holding a lock another thread on the same CPU would spin
+// on, or in the middle of an RCU read.
+//
+// The count is per CPU, not per thread: a thread may only switch out
+// voluntarily with it at zero, so it is always zero again when the thread
+// resumes. Leaving a section does not reschedule by itself; a pending
+// preemption waits for the next tick.
+
+class Preempt {
+public:
+    // PER_CPU, defined in core/sched.cc.
+    static u32 s_count;
+};
+
+inline void preempt_disable() {
+    this_cpu_inc(Preempt::s_count);
+    __asm__ volatile ("" ::: "memory");
+}
+
+inline void preempt_enable() {
+    __asm__ volatile ("" ::: "memory");
+    this_cpu_dec(Preempt::s_count);
+}
+
+inline bool preemptible() {
+    return this_cpu_read(Preempt::s_count) == 0;
+}
+
+#endif // PREEMPT_HH
@@ -0,0 +1,681 @@
+#include <core/sched.hh>
+#include <core/preempt.hh>
+#include <arch/cpu.hh>
+#include <arch/cpuid.hh>
+#include <arch/fpu.hh>
+#include <arch/idt.hh>
+#include <arch/io.hh>
+#include <arch/lapic.hh>
+#include <arch/smp.hh>
+#include <arch/tsc.hh>
+#include <core/format.hh>
+#include <core/timer.hh>
+#include <ktl/bitset>
+#include <ktl/clock>
+#include <ktl/rcu>
+#include <ktl/spinlock>
+
+extern "C" {
+    // arch/switch.S. Saves the callee-saved registers on prev's stack and
+    // its rsp in prev->rsp, then resumes next. Returns, on next's stack,
+    // the thread that switched to it.
+    Thread* context_switch(Thread* prev, Thread* next);
+
+    // Where a new thread's first context_switch returns to; calls
+    // thread_start with the previous thread.
+    void thread_trampoline();
+
+    [[noreturn]] void thread_start(Thread* prev);
+}
+
+PER_CPU u32     Preempt::s_count     = 0;
+PER_CPU Thread* Scheduler::s_current = nullptr;
+
+namespace {
+
+using ktl::memory_order_acquire;
+using ktl::memory_order_relaxed;
+using ktl::memory_order_release;
+using ktl::memory_order_seq_cst;
+
+// A thread that stopped running less than this long ago is treated as
+// cache hot.
+constexpr u64 kCacheHotNs = 500'000;
+
+// How far down a victim's queue a stealer looks for a cold thread.
+constexpr usize kStealScan = 8;
+
+using RunList = ktl::intrusive_list<Thread, &Thread::run_link>;
+
+struct alignas(64) RunQueue {
+    ktl::SpinLock lock;
+    RunList       queue;
+    // Mirrors queue.size() for readers that don't take the lock: the idle
+    // loop and stealers picking a victim.
+    ktl::atomic<u32> queued { 0 };
+    Thread* idle = nullptr;
+    // Only touched by the owning CPU, with interrupts off.
+    HrTimer tick;
+    u32     ticks        = 0;
+    bool    need_resched = false;
+    // Set by the tick, reported on interrupt exit.
+    bool    tick_quiescent = false;
+};
+
+constinit RunQueue s_run_queues[kMaxCpus];
+
+// CPUs waiting in the idle loop, with their tick stopped.
+ktl::bitset<kMaxCpus> s_idle_cpus;
+
+// What another CPU touches to wake an idle one. A CPU in mwait monitors
+// the wake line, so the store that sets it is the whole wakeup; without
+// mwait the waker sends a reschedule IPI instead.
+struct alignas(64) IdleState {
+    ktl::atomic<u32> wake { 0 };
+    ktl::atomic<u64> kick_tsc { 0 };   // when the last waker asked
+};
+
+constinit IdleState s_idle_states[kMaxCpus];
+bool                s_use_mwait = false;
+
+PER_CPU PerCpuCounter s_idle_entries;
+PER_CPU PerCpuCounter s_idle_cycles;
+PER_CPU PerCpuCounter s_wake_samples;
+PER_CPU PerCpuCounter s_wake_total;
+PER_CPU u64           s_wake_max = 0;
+
+alignas(Thread) u8 s_thread_storage[Scheduler::kMaxThreads * sizeof(Thread)];
+alignas(Thread) u8 s_idle_storage[kMaxCpus * sizeof(Thread)];
+alignas(16) u8 s_stacks[Scheduler::kMaxThreads][Scheduler::kStackSize];
+
+// Extended state for every thread slot and idle thread, Fpu::areaStride()
+// apart: sized for the largest area Fpu accepts, but only as much as the
+// enabled XCR0 features need is ever touched.
+constexpr usize kFpuSlots = Scheduler::kMaxThreads + kMaxCpus;
+alignas(64) u8 s_fpu_areas[kFpuSlots * Fpu::kAreaMax];
+
+ktl::SpinLock    s_free_lock;
+RunList          s_free;
+ktl::atomic<u32> s_next_id { 1 };
+
+PER_CPU PerCpuCounter s_switches;
+PER_CPU PerCpuCounter s_preemptions;
+PER_CPU PerCpuCounter s_steals;
+PER_CPU PerCpuCounter s_latency_samples;
+PER_CPU PerCpuCounter s_latency_total;
+PER_CPU u64           s_latency_max = 0;
+
+Thread* threadAt(usize i) {
+    return reinterpret_cast<Thread*>(s_thread_storage) + i;
+}
+
+Thread* idleAt(u32 cpu) {
+    return reinterpret_cast<Thread*>(s_idle_storage) + cpu;
+}
+
+u8* fpuArea(usize slot) {
+    return s_fpu_areas + slot * Fpu::areaStride();
+}
+
+u32 cpuOf(const RunQueue& rq) {
+    return static_cast<u32>(&rq - s_run_queues);
+}
+
+void enqueueLocked(RunQueue& rq, Thread& t) {
+    t.cpu         = cpuOf(rq);
+    t.ready_since = Tsc::read();
+    rq.queue.push_back(t);
+    rq.queued.fetch_add(1, memory_order_relaxed);
+}
+
+Thread* dequeueLocked(RunQueue& rq) {
+    Thread* const t = rq.queue.pop_front();
+    if (t != nullptr) {
+        rq.queued.fetch_sub(1, memory_order_relaxed);
+    }
+    return t;
+}
+
+void wakeIdle(u32 cpu) {
+    IdleState& idle = s_idle_states[cpu];
+    idle.kick_tsc.store(Tsc::read(), memory_order_relaxed);
+    if (s_use_mwait) {
+        idle.wake.store(1, memory_order_release);
+    } else {
+        Lapic::sendIpi(Smp::lapicId(cpu), Lapic::kRescheduleVector);
+    }
+}
+
+// Wakes one idle CPU to come and steal. Claiming the idle bit keeps a
+// burst of spawns from waking the same CPU over and over.
+void wakeAnyIdle() {
+    for (usize cpu = s_idle_cpus.find_first_set(); cpu != s_idle_cpus.npos;
+         cpu = s_idle_cpus.find_next_set(cpu + 1)) {
+        if (s_idle_cpus.atomic_test_and_reset(cpu)) {
+            wakeIdle(static_cast<u32>(cpu));
+            return;
+        }
+    }
+}
+
+// Gets an idle CPU to look at the queues: the target itself if the thread
+// is pinned elsewhere, otherwise any idle CPU while this one has something
+// waiting.
+void kick(u32 target, bool pinned) {
+    if (!Lapic::available() && !s_use_mwait) {
+        return;
+    }
+    const u32 self = Cpu::currentId();
+    if (target != self) {
+        if (s_idle_cpus.atomic_test_and_reset(target)) {
+            wakeIdle(target);
+        }
+        return;
+    }
+    if (!pinned && Scheduler::current() != s_run_queues[self].idle) {
+        wakeAnyIdle();
+    }
+}
+
+void enqueue(u32 cpu, Thread& t) {
+    RunQueue& rq = s_run_queues[cpu];
+    rq.lock.lock();
+    enqueueLocked(rq, t);
+    rq.lock.unlock();
+    kick(cpu, t.pinned);
+}
+
+void freeThread(Thread* t) {
+    t->entry.reset();
+    ktl::IrqAutoLock<ktl::SpinLock> guard(s_free_lock);
+    s_free.push_back(*t);
+}
+
+// Takes a thread from the CPU with the longest queue. Cold threads go
+// first; a cache-hot one only moves if the victim has others waiting
+// behind it, since otherwise it will run there soon enough.
+Thread* steal(u32 self) {
+    u32 victim = self;
+    u32 most   = 0;
+    for (u32 cpu = Smp::nextOnlineAfter(self); cpu != self; cpu = Smp::nextOnlineAfter(cpu)) {
+        const u32 n = s_run_queues[cpu].queued.load(memory_order_relaxed);
+        if (n > most) {
+            most   = n;
+            victim = cpu;
+        }
+    }
+    if (victim == self) {
+        return nullptr;
+    }
+
+    RunQueue& rq = s_run_queues[victim];
+    const u64 now = Tsc::read();
+    const u64 hot_cycles = ktl::clock::ns_to_cycles(kCacheHotNs);
+    Thread* pick  = nullptr;
+    bool    hot   = false;
+
+    rq.lock.lock();
+    usize scanned = 0;
+    for (Thread& t : rq.queue) {
+        if (scanned++ == kStealScan) {
+            break;
+        }
+        if (t.pinned || t.on_cpu.load(memory_order_relaxed)) {
+            continue;
+        }
+        const bool t_hot = now - t.last_run < hot_cycles;
+        if (pick == nullptr || (hot && !t_hot)) {
+            pick = &t;
+            hot  = t_hot;
+        }
+        if (!hot) {
+            break;
+        }
+    }
+    if (pick != nullptr && hot && rq.queue.size() < 2) {
+        pick = nullptr;
+    }
+    if (pick != nullptr) {
+        rq.queue.remove(*pick);
+        rq.queued.fetch_sub(1, memory_order_relaxed);
+    }
+    rq.lock.unlock();
+
+    if (pick != nullptr) {
+        s_steals.inc();
+    }
+    return pick;
+}
+
+// Runs on the new thread's stack right after the switch: prev's registers
+// are saved, so another CPU may now pick it up, and a dead prev's stack is
+// no longer in use.
+void finishSwitch(Thread* prev) {
+    prev->on_cpu.store(false, memory_order_release);
+    if (prev->state.load(memory_order_relaxed) == Thread::State::Dead) {
+        freeThread(prev);
+    }
+}
+
+void switchTo(u32 self, Thread* prev, Thread* next) {
+    // next may have been stolen from a CPU that has not finished switching
+    // away from it yet.
+    while (next->on_cpu.load(memory_order_acquire)) {
+        io::pause();
+    }
+
+    // Idle CPUs run without a tick; it comes back with the first thread.
+    RunQueue& rq = s_run_queues[self];
+    if (prev == rq.idle && !rq.tick.pending()) {
+        Timers::arm(rq.tick, ktl::clock::now() + Scheduler::kTickNs);
+    }
+
+    const u64 now = Tsc::read();
+    prev->runtime += now - prev->last_run;
+    prev->last_run = now;
+
+    if (next != rq.idle) {
+        const u64 latency = now - next->ready_since;
+        next->wait_time += latency;
+        s_latency_samples.inc();
+        s_latency_total.add(latency);
+        if (latency > this_cpu_read(s_latency_max)) {
+            this_cpu_write(s_latency_max, latency);
+        }
+    }
+    if (next->cpu != self) {
+        ++next->migrations;
+    }
+    next->cpu      = self;
+    next->state.store(Thread::State::Running, memory_order_relaxed);
+    next->last_run = now;
+    ++next->switches;
+    next->on_cpu.store(true, memory_order_relaxed);
+
+    Fpu::switchState(&prev->fpu, &next->fpu, self);
+    this_cpu_write(Scheduler::s_current, next);
+    s_switches.inc();
+
+    // A context switch is a quiescent state: prev can't be inside an RCU
+    // read-side section, as those disable preemption.
+    ktl::rcu_quiescent_state();
+
+    finishSwitch(context_switch(prev, next));
+}
+
+// Picks the next thread for this CPU and switches to it. The running
+// thread goes to the back of the queue unless it is the idle thread or
+// has exited.
+void schedule(bool preempted) {
+    const u64 flags = io::irqSave();
+    const u32 self  = Cpu::currentId();
+    RunQueue& rq    = s_run_queues[self];
+    Thread* const prev = Scheduler::current();
+
+    rq.lock.lock();
+    rq.ticks        = 0;
+    rq.need_resched = false;
+    if (prev->state.load(memory_order_relaxed) == Thread::State::Running && prev != rq.idle) {
+        prev->state.store(Thread::State::Runnable, memory_order_relaxed);
+        enqueueLocked(rq, *prev);
+    }
+    Thread* next = dequeueLocked(rq);
+    rq.lock.unlock();
+
+    if (next == nullptr) {
+        next = steal(self);
+    }
+    if (next == nullptr) {
+        next = rq.idle;
+    }
+
+    if (next == prev) {
+        prev->state.store(Thread::State::Running, memory_order_relaxed);
+    } else {
+        if (preempted) {
+            s_preemptions.inc();
+        }
+        switchTo(self, prev, next);
+    }
+    io::irqRestore(flags);
+}
+
+// Runs from the timer interrupt, inside dispatch()'s read-side section:
+// the quiescent state and the switch it asks for wait for
+// Scheduler::interruptExit().
+void onTick(void*) {
+    RunQueue& rq = s_run_queues[Cpu::currentId()];
+
+    // Keep to the tick grid unless the interrupt came so late that whole
+    // ticks were missed.
+    const u64 now  = ktl::clock::now();
+    u64       next = rq.tick.expires + Scheduler::kTickNs;
+    if (next <= now) {
+        next = now + Scheduler::kTickNs;
+    }
+    Timers::arm(rq.tick, next);
+
+    rq.tick_quiescent = true;
+    if (Scheduler::current() == rq.idle) {
+        return;
+    }
+    // At the end of a slice with threads waiting, also wake an idle CPU
+    // to steal one: nothing else would, since idle CPUs have no tick.
+    if (++rq.ticks >= Scheduler::kTimeSliceTicks && rq.queued.load(memory_order_relaxed) != 0) {
+        rq.need_resched = true;
+        wakeAnyIdle();
+    }
+}
+
+// Only sent to idle CPUs; the interrupt itself ends their hlt.
+void onReschedule(registers_ctx*) {
+    Lapic::eoi();
+}
+
+void monitor(const void* addr) {
+    __asm__ volatile ("monitor" : : "a"(addr), "c"(0), "d"(0) : "memory");
+}
+
+// C1 (hint 0): the deeper C-states need ACPI's latency tables to pick
+// safely. ECX bit 0 lets interrupts end the wait although IF is clear.
+void mwait() {
+    __asm__ volatile ("mwait" : : "a"(0), "c"(1) : "memory");
+}
+
+// Waits for work with interrupts disabled, the tick stopped unless RCU
+// callbacks are queued and the CPU out of RCU's way, and returns with
+// interrupts still disabled. The hlt wait briefly enables them; dispatch()
+// brings the CPU back into RCU for any handler that runs then.
+void idleWait(u32 self, RunQueue& rq) {
+    IdleState& idle = s_idle_states[self];
+
+    s_idle_cpus.atomic_set(self);
+    ktl::rcu_idle_enter();
+
+    // RCU callbacks only advance from quiescent states, so while any are
+    // queued the tick keeps running and wakes this loop to push them on.
+    if (ktl::rcu_pending()) {
+        if (!rq.tick.pending()) {
+            Timers::arm(rq.tick, ktl::clock::now() + Scheduler::kTickNs);
+        }
+    } else if (rq.tick.pending()) {
+        Timers::cancel(rq.tick);
+    }
+
+    // Look again now that the idle bit is visible: a thread queued before
+    // that got no kick.
+    const u64 enter = Tsc::read();
+    if (s_use_mwait) {
+        monitor(&idle.wake);
+        if (rq.queued.load(memory_order_acquire) == 0 && idle.wake.load(memory_order_acquire) == 0) {
+            mwait();
+        }
+        idle.wake.store(0, memory_order_relaxed);
+    } else if (Lapic::available()) {
+        // sti only takes effect after the next instruction, so no wakeup
+        // can slip in before the hlt.
+        if (rq.queued.load(memory_order_acquire) == 0) {
+            __asm__ volatile ("sti \n\t"
+                              "hlt \n\t"
+                              "cli"
+                              ::: "memory");
+        }
+    } else {
+        // No way to be woken: poll.
+        io::pause();
+    }
+    const u64 wake = Tsc::read();
+
+    ktl::rcu_idle_exit();
+    s_idle_cpus.atomic_reset(self);
+
+    s_idle_entries.inc();
+    s_idle_cycles.add(wake - enter);
+    const u64 kicked = idle.kick_tsc.exchange(0, memory_order_relaxed);
+    if (kicked != 0 && wake > kicked) {
+        const u64 latency = wake - kicked;
+        s_wake_samples.inc();
+        s_wake_total.add(latency);
+        if (latency > this_cpu_read(s_wake_max)) {
+            this_cpu_write(s_wake_max, latency);
+        }
+    }
+}
+
+} // namespace
+
+extern "C" [[noreturn]] void thread_start(Thread* prev) {
+    finishSwitch(prev);
+    io::sti();
+    Scheduler::current()->entry();
+    Scheduler::exit();
+}
+
+void Scheduler::init() {
+    for (usize i = 0; i < kMaxThreads; ++i) {
+        Thread* const t = new (threadAt(i)) Thread();
+        t->stack    = s_stacks[i];
+        t->fpu.area = fpuArea(i);
+        s_free.push_back(*t);
+    }
+
+    Fpu::initThreads();
+
+    s_use_mwait = Cpuid::hasMonitor() && Cpuid::hasMwaitIrqBreak();
+    if constexpr (kDebugMode) {
+        Fmt::printf("sched: idle CPUs wait in {}\n", s_use_mwait ? "mwait" : "hlt");
+    }
+
+    InterruptDescriptorTable::registerHandler(Lapic::kRescheduleVector, onReschedule);
+
+    initCpu(Cpu::kBootCpu);
+}
+
+void Scheduler::initCpu(u32 cpu) {
+    Thread* const idle = new (idleAt(cpu)) Thread();
+    idle->name     = "idle";
+    idle->state.store(Thread::State::Running, memory_order_relaxed);
+    idle->pinned   = true;
+    idle->cpu      = cpu;
+    idle->last_run = Tsc::read();
+    idle->fpu.area = fpuArea(kMaxThreads + cpu);
+    idle->on_cpu.store(true, memory_order_relaxed);
+    Fpu::attach(&idle->fpu, cpu);
+
+    RunQueue& rq = s_run_queues[cpu];
+    rq.idle      = idle;
+    rq.tick.func = onTick;
+    this_cpu_write(s_current, idle);
+}
+
+void Scheduler::idleLoop() {
+    // The idle thread is pinned, so this stays right.
+    const u32 self = Cpu::currentId();
+    RunQueue& rq   = s_run_queues[self];
+
+    io::sti();
+    for (;;) {
+        schedule(false);
+
+        io::cli();
+        if (rq.queued.load(memory_order_relaxed) == 0) {
+            idleWait(self, rq);
+        }
+        io::sti();
+    }
+}
+
+Thread* Scheduler::spawn(const char* name, ThreadEntry entry, u32 cpu) {
+    Thread* t;
+    {
+        ktl::IrqAutoLock<ktl::SpinLock> guard(s_free_lock);
+        t = s_free.pop_front();
+    }
+    if (t == nullptr) {
+        return nullptr;
+    }
+
+    t->name        = name;
+    t->entry       = ktl::move(entry);
+    t->state.store(Thread::State::Runnable, memory_order_relaxed);
+    t->wake_pending.store(false, memory_order_relaxed);
+    t->pinned      = cpu != kAnyCpu;
+    t->id          = s_next_id.fetch_add(1, memory_order_relaxed);
+    t->runtime     = 0;
+    t->wait_time   = 0;
+    t->last_run    = 0;
+    t->switches    = 0;
+    t->migrations  = 0;
+    Fpu::reset(&t->fpu);
+
+    // The frame context_switch pops: six callee-saved registers, then the
+    // return address. The two slots above it leave rsp 16-byte aligned at
+    // the trampoline's call, as the ABI wants.
+    u64* sp = reinterpret_cast<u64*>(t->stack + kStackSize);
+    *--sp = 0;
+    *--sp = 0;
+    *--sp = reinterpret_cast<u64>(&thread_trampoline);
+    for (int i = 0; i < 6; ++i) {
+        *--sp = 0;
+    }
+    t->rsp = reinterpret_cast<u64>(sp);
+
+    const u64 flags = io::irqSave();
+    enqueue(cpu == kAnyCpu ? Cpu::currentId() : cpu, *t);
+    io::irqRestore(flags);
+    return t;
+}
+
+void Scheduler::yield() {
+    if (!preemptible()) {
+        InterruptDescriptorTable::kpanic(nullptr, "Scheduler::yield with preemption disabled");
+    }
+    schedule(false);
+}
+
+void Scheduler::park() {
+    if (!preemptible()) {
+        InterruptDescriptorTable::kpanic(nullptr, "Scheduler::park with preemption disabled");
+    }
+    Thread* const self = current();
+    if (self == nullptr || self == s_run_queues[Cpu::currentId()].idle) {
+        io::pause();
+        return;
+    }
+    const u64 flags = io::irqSave();
+
+    // Blocked goes up before the wakeup is checked, and unpark() sets the
+    // wakeup before it looks for Blocked, so one of the two always sees
+    // the other.
+    self->state.store(Thread::State::Blocked, memory_order_seq_cst);
+    if (self->wake_pending.exchange(false, memory_order_seq_cst)) {
+        Thread::State blocked = Thread::State::Blocked;
+        if (self->state.compare_exchange_strong(blocked, Thread::State::Running,
+                                                memory_order_relaxed)) {
+            io::irqRestore(flags);
+            return;
+        }
+        // An unpark() already queued us; schedule() takes it from there.
+    }
+    schedule(false);
+    io::irqRestore(flags);
+}
+
+void Scheduler::unpark(Thread* t) {
+    if (t->wake_pending.exchange(true, memory_order_seq_cst)) {
+        return;
+    }
+    Thread::State blocked = Thread::State::Blocked;
+    if (!t->state.compare_exchange_strong(blocked, Thread::State::Runnable,
+                                          memory_order_seq_cst)) {
+        return;
+    }
+    // The wakeup is spent on this queueing.
+    t->wake_pending.store(false, memory_order_relaxed);
+
+    const u64 flags = io::irqSave();
+    enqueue(t->cpu, *t);
+    io::irqRestore(flags);
+}
+
+bool Scheduler::canBlock() {
+    const Thread* const self = current();
+    return self != nullptr && self != s_run_queues[Cpu::currentId()].idle &&
+           preemptible() && io::irqEnabled();
+}
+
+void Scheduler::exit() {
+    io::cli();
+    current()->state.store(Thread::State::Dead, memory_order_relaxed);
+    schedule(false);
+    __builtin_unreachable();
+}
+
+void Scheduler::interruptExit() {
+    const u64 flags = io::irqSave();
+    RunQueue& rq = s_run_queues[Cpu::currentId()];
+    // The idle thread reports to RCU and reschedules from its own loop.
+    if (preemptible() && current() != rq.idle) {
+        // Interrupted code with a zero preempt count holds no locks and is
+        // outside any RCU read-side section, so this is a quiescent state
+        // even for a thread that never switches.
+        if (rq.tick_quiescent) {
+            rq.tick_quiescent = false;
+            ktl::rcu_quiescent_state();
+        }
+        if (rq.need_resched) {
+            schedule(true);
+        }
+    }
+    io::irqRestore(flags);
+}
+
+Scheduler::Stats Scheduler::stats() {
+    Stats s {
+        .switches        = s_switches.sum(),
+        .preemptions     = s_preemptions.sum(),
+        .steals          = s_steals.sum(),
+        .latency_samples = s_latency_samples.sum(),
+        .latency_total   = s_latency_total.sum(),
+        .latency_max     = 0,
+    };
+    for_each_online_cpu(cpu) {
+        const u64 max = per_cpu(s_latency_max, cpu);
+        s.latency_max = max > s.latency_max ? max : s.latency_max;
+    }
+    return s;
+}
+
+Scheduler::IdleStats Scheduler::idleStats() {
+    IdleStats s {
+        .entries      = s_idle_entries.sum(),
+        .cycles       = s_idle_cycles.sum(),
+        .wake_samples = s_wake_samples.sum(),
+        .wake_total   = s_wake_total.sum(),
+        .wake_max     = 0,
+    };
+    for_each_online_cpu(cpu) {
+        const u64 max = per_cpu(s_wake_max, cpu);
+        s.wake_max = max > s.wake_max ? max : s.wake_max;
+    }
+    return s;
+}
+
+void Scheduler::dumpStats() {
+    const Stats s = stats();
+    Fmt::printf("sched: {} switches, {} preemptions, {} steals\n",
+                s.switches, s.preemptions, s.steals);
+    Fmt::printf("sched: wakeup latency avg {} max {} cycles over {} runs\n",
+                s.latency_samples ? s.latency_total / s.latency_samples : 0,
+                s.latency_max, s.latency_samples);
+    const IdleStats idle = idleStats();
+    Fmt::printf("sched: {} idle waits, wake latency avg {} max {} cycles over {} wakeups\n",
+                idle.entries,
+                idle.wake_samples ? idle.wake_total / idle.wake_samples : 0,
+                idle.wake_max, idle.wake_samples);
+    for_each_online_cpu(cpu) {
+        Fmt::printf("sched: CPU {}: {} switches, {} steals, {} idle waits, idle {} cycles\n",
+                    cpu, s_switches.read(cpu), s_steals.read(cpu),
+                    s_idle_entries.read(cpu), s_idle_cycles.read(cpu));
+    }
+}
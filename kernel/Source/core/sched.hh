@@ -0,0 +1,171 @@
+#ifndef SCHED_HH
+#define SCHED_HH
+
+#include <arch/fpu.hh>
+#include <arch/percpu.hh>
+#include <ktl/atomic>
+#include <ktl/function>
+#include <ktl/list>
+
+// Kernel threads and the scheduler.
+//
+// Every CPU has its own run queue, served round robin. Each CPU's tick is
+// an hrtimer (core/timer.hh) firing kTickHz times a second; once the
+// running thread has had kTimeSliceTicks ticks and another is waiting, the
+// timer interrupt switches to it on the way out, unless the preempt count
+// (core/preempt.hh) says the interrupted code holds a lock or is inside an
+// RCU read-side section.
+//
+// New threads are queued on the spawning CPU, and an idle CPU is kicked
+// with an IPI to come and take one. A CPU that runs out of work steals
+// from the busiest queue before it idles. It prefers threads that have not
+// run for a while: one that was just switched out probably still has its
+// working set in the victim's caches, and moving it only pays off when the
+// victim has a backlog. Pinned threads are never stolen.
+//
+// The context each CPU boots on becomes its idle thread, which runs only
+// when nothing else can. An idle CPU stops its tick, which leaves its
+// LAPIC armed for its next pending timer, and waits in mwait (C1) if the
+// CPU has it, else in hlt; whoever gives it work wakes it, with a store to
+// the line it monitors or a reschedule IPI. All times and statistics are
+// in TSC cycles.
+
+using ThreadEntry = ktl::inplace_function<void()>;
+
+struct Thread {
+    enum class State : u8 {
+        Runnable,
+        Running,
+        Blocked,
+        Dead,
+    };
+
+    // Saved stack pointer while switched out; context_switch in
+    // arch/switch.S relies on it being the first member.
+    u64 rsp = 0;
+
+    // Changed by other CPUs only from Blocked to Runnable, in unpark().
+    ktl::atomic<State> state { State::Runnable };
+    bool               pinned = false;
+
+    // An unpark() that park() has not consumed yet.
+    ktl::atomic<bool> wake_pending { false };
+
+    // Set while some CPU is running the thread or still saving its
+    // registers after switching away from it. A CPU about to switch to the
+    // thread waits for it to clear.
+    ktl::atomic<bool> on_cpu { false };
+
+    // CPU whose run queue holds the thread, or that runs it.
+    u32         cpu  = 0;
+    u32         id   = 0;
+    const char* name = "";
+
+    ThreadEntry    entry;
+    u8*            stack = nullptr;
+    ktl::list_node run_link;
+    FpuState       fpu;
+
+    u64 runtime     = 0;   // cycles spent running
+    u64 wait_time   = 0;   // cycles spent runnable, waiting for a CPU
+    u64 last_run    = 0;   // TSC at the last switch in or out
+    u64 ready_since = 0;   // TSC when it was last queued
+    u64 switches    = 0;
+    u64 migrations  = 0;   // switch-ins on a CPU other than the last one
+};
+
+class Scheduler {
+public:
+    static constexpr u32   kAnyCpu         = ~0u;
+    static constexpr usize kMaxThreads     = 128;
+    static constexpr usize kStackSize      = 16 * 1024;
+    static constexpr u32   kTickHz         = 1000;
+    static constexpr u64   kTickNs         = 1'000'000'000 / kTickHz;
+    static constexpr u32   kTimeSliceTicks = 4;
+
+    struct Stats {
+        u64 switches;
+        u64 preemptions;
+        u64 steals;
+        // Time from being queued to being switched in, over all threads.
+        u64 latency_samples;
+        u64 latency_total;
+        u64 latency_max;
+    };
+
+    struct IdleStats {
+        u64 entries;        // times a CPU started waiting
+        u64 cycles;         // spent waiting
+        // Time from a wakeup request to the CPU running again, for the
+        // waits that ended that way.
+        u64 wake_samples;
+        u64 wake_total;
+        u64 wake_max;
+    };
+
+    // Boot CPU, after Lapic::init() and before Smp::init(): sets up the
+    // thread pool and the tick and reschedule vectors, and makes the
+    // running context the boot CPU's idle thread.
+    static void init();
+
+    // Every AP, before it reaches the init barrier.
+    static void initCpu(u32 cpu);
+
+    // Starts the CPU's tick and runs threads from then on. Called from the
+    // idle thread, i.e. the CPU's boot context.
+    [[noreturn]] static void idleLoop();
+
+    // Queues a new thread on cpu, or on the calling CPU for kAnyCpu, from
+    // where other CPUs may steal it. A thread given an explicit CPU is
+    // pinned there. Returns nullptr when all kMaxThreads are in use.
+    static Thread* spawn(const char* name, ThreadEntry entry, u32 cpu = kAnyCpu);
+
+    // Lets every other runnable thread on this CPU go first. Must not be
+    // called with preemption disabled.
+    static void yield();
+
+    // Ends the calling thread; its slot is reused once another thread has
+    // switched away from its stack.
+    [[noreturn]] static void exit();
+
+    // Blocks the calling thread until unpark(), returning at once if an
+    // unpark() came since the last park(). May also return spuriously, so
+    // callers wait for a condition in a loop:
+    //
+    //     while (!done.load(memory_order_acquire)) {
+    //         Scheduler::park();
+    //     }
+    //
+    // with the waker setting done before unparking. Must not be called
+    // with preemption disabled. The idle thread and the boot context before
+    // init() have nothing to switch to and only pause.
+    static void park();
+
+    // Makes t runnable again if it is parked, or lets its next park()
+    // return at once. Any context, interrupt handlers included.
+    static void unpark(Thread* t);
+
+    // Whether the caller may block: a thread other than an idle thread,
+    // with preemption and interrupts enabled. Anything else waits by
+    // spinning.
+    static bool canBlock();
+
+    // Called by interrupt_dispatch() after the handler has returned, when
+    // the interrupted code had interrupts enabled. If its preempt count is
+    // zero, reports the quiescent state the tick asked for and switches
+    // threads if the time slice is up.
+    static void interruptExit();
+
+    static Thread* current() {
+        return this_cpu_read(s_current);
+    }
+
+    static Stats     stats();
+    static IdleStats idleStats();
+    static void      dumpStats();
+
+    // PER_CPU, defined in core/sched.cc; read it through current().
+    static Thread* s_current;
+};
+
+#endif // SCHED_HH
@@ -0,0 +1,12 @@
+#include <ktl/sched_hooks>
+#include <core/futex.hh>
+
+// The out-of-line half of ktl/sched_hooks.
+
+bool ktl::hooks::futex_wait(const u32* addr, u32 expected, u64 deadline) noexcept {
+    return Futex::wait(addr, expected, deadline);
+}
+
+u32 ktl::hooks::futex_wake(const u32* addr, u32 count) noexcept {
+    return Futex::wake(addr, count);
+}
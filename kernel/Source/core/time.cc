@@ -0,0 +1,46 @@
+#include <limine.h>
+
+#include <core/time.hh>
+#include <arch/cpuid.hh>
+#include <arch/rtc.hh>
+#include <arch/tsc.hh>
+#include <core/format.hh>
+#include <ktl/clock>
+
+namespace {
+
+[[gnu::used, gnu::section(".limine_requests")]] volatile limine_date_at_boot_request s_date_request = {
+    .id       = LIMINE_DATE_AT_BOOT_REQUEST,
+    .revision = 0,
+    .response = nullptr,
+};
+
+constexpr u64 kNsPerSec = 1'000'000'000;
+
+} // namespace
+
+void Time::init() {
+    Tsc::calibrate();
+    ktl::clock::start(Tsc::frequency());
+
+    const char* wall_source = "none";
+    u64 seconds = 0;
+    limine_date_at_boot_response* const date = s_date_request.response;
+    if (date != nullptr && date->timestamp > 0) {
+        seconds     = static_cast<u64>(date->timestamp);
+        wall_source = "bootloader";
+    } else if ((seconds = Rtc::unixSeconds()) != 0) {
+        wall_source = "rtc";
+    }
+    if (seconds != 0) {
+        ktl::clock::set_realtime(seconds * kNsPerSec);
+    }
+
+    if (!Cpuid::hasInvariantTsc()) {
+        Fmt::printf("time: TSC is not invariant, the clock may drift with CPU frequency\n");
+    }
+    if constexpr (kDebugMode) {
+        Fmt::printf("time: TSC {} kHz from {}, wall clock {} s from {}\n",
+                    Tsc::frequency() / 1000, Tsc::frequencySource(), seconds, wall_source);
+    }
+}
@@ -0,0 +1,14 @@
+#ifndef TIME_HH
+#define TIME_HH
+
+// Boot-time setup of ktl::clock (see ktl/clock).
+class Time {
+public:
+    // Boot CPU, before anything wants timestamps: calibrates the TSC,
+    // starts the monotonic clock and seeds the wall clock, from the date
+    // the bootloader read from the firmware (EFI GetTime on UEFI) or else
+    // from the CMOS RTC.
+    static void init();
+};
+
+#endif // TIME_HH
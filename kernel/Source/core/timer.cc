@@ -0,0 +1,215 @@
+#include <core/timer.hh>
+#include <arch/cpu.hh>
+#include <arch/idt.hh>
+#include <arch/io.hh>
+#include <arch/lapic.hh>
+#include <arch/percpu.hh>
+#include <ktl/clock>
+#include <ktl/spinlock>
+
+namespace {
+
+constexpr u64 kNever = ~0ULL;
+constexpr u32 kNoCpu = ~0u;
+
+struct HrTimerKey {
+    static u64 key(const HrTimer& t) { return t.expires; }
+};
+
+struct alignas(64) TimerBase {
+    ktl::SpinLock                                              lock;
+    ktl::timer_wheel<Timer, &Timer::node>                      wheel;
+    ktl::intrusive_rbtree<HrTimer, &HrTimer::node, HrTimerKey> hrtimers;
+    // Timer whose callback is running, for cancel() to wait on.
+    const void* running = nullptr;
+    // Deadline the LAPIC is armed for.
+    u64 programmed = kNever;
+};
+
+constinit TimerBase s_bases[kMaxCpus];
+
+PER_CPU PerCpuCounter s_interrupts;
+PER_CPU PerCpuCounter s_empty;
+PER_CPU PerCpuCounter s_expired;
+PER_CPU PerCpuCounter s_programs;
+
+u64 wheelTick(u64 ns) {
+    return ns / Timers::kWheelTickNs;
+}
+
+// Wheel timers round up, so they never fire early.
+u64 wheelTickAfter(u64 ns) {
+    return ns / Timers::kWheelTickNs + (ns % Timers::kWheelTickNs != 0);
+}
+
+u64 firstDeadline(const TimerBase& base) {
+    const HrTimer* const hr = base.hrtimers.first();
+    const u64 tick  = base.wheel.next_expiry();
+    const u64 wheel = tick == kNever ? kNever : tick * Timers::kWheelTickNs;
+    return hr != nullptr && hr->expires < wheel ? hr->expires : wheel;
+}
+
+// Calling CPU's base only.
+void program(TimerBase& base, u64 deadline) {
+    base.programmed = deadline;
+    if (deadline == kNever) {
+        Lapic::stopTimer();
+    } else {
+        Lapic::armDeadline(Lapic::kTimerVector, ktl::clock::tsc_at(deadline));
+    }
+    s_programs.inc();
+}
+
+// Called with base locked and interrupts disabled. A CPU cancelling its
+// own timer from the callback must not wait for itself.
+void waitForCallback(TimerBase& base, const void* timer, u32 cpu) {
+    if (cpu == Cpu::currentId()) {
+        return;
+    }
+    while (base.running == timer) {
+        base.lock.unlock();
+        io::pause();
+        base.lock.lock();
+    }
+}
+
+void runCallback(TimerBase& base, const void* timer, TimerFunc func, void* data) {
+    base.running = timer;
+    base.lock.unlock();
+    func(data);
+    base.lock.lock();
+    base.running = nullptr;
+    s_expired.inc();
+}
+
+void onInterrupt(registers_ctx*) {
+    Lapic::eoi();
+    s_interrupts.inc();
+
+    TimerBase& base = s_bases[Cpu::currentId()];
+    base.lock.lock();
+    base.programmed = kNever;
+
+    bool any = false;
+    for (;;) {
+        const u64 now = ktl::clock::now();
+        if (HrTimer* const hr = base.hrtimers.first(); hr != nullptr && hr->expires <= now) {
+            base.hrtimers.erase(*hr);
+            runCallback(base, hr, hr->func, hr->data);
+        } else if (Timer* const t = base.wheel.pop_expired(wheelTick(now)); t != nullptr) {
+            runCallback(base, t, t->func, t->data);
+        } else {
+            break;
+        }
+        any = true;
+    }
+    if (!any) {
+        s_empty.inc();
+    }
+
+    // A callback that re-armed its timer may have programmed it already.
+    const u64 next = firstDeadline(base);
+    if (next != base.programmed) {
+        program(base, next);
+    }
+    base.lock.unlock();
+}
+
+} // namespace
+
+void Timers::init() {
+    InterruptDescriptorTable::registerHandler(Lapic::kTimerVector, onInterrupt);
+}
+
+void Timers::arm(Timer& t, u64 deadline) {
+    cancel(t);
+
+    const u64 flags = io::irqSave();
+    const u32 self  = Cpu::currentId();
+    TimerBase& base = s_bases[self];
+    base.lock.lock();
+
+    // An empty wheel has not been advanced since it emptied; bring it up
+    // to date so the new timer gets the finest bucket it can.
+    base.wheel.forward(wheelTick(ktl::clock::now()));
+    base.wheel.insert(t, wheelTickAfter(deadline));
+    t.cpu = self;
+
+    const u64 fire = t.node.expires * kWheelTickNs;
+    if (fire < base.programmed) {
+        program(base, fire);
+    }
+    base.lock.unlock();
+    io::irqRestore(flags);
+}
+
+void Timers::arm(HrTimer& t, u64 deadline) {
+    cancel(t);
+
+    const u64 flags = io::irqSave();
+    const u32 self  = Cpu::currentId();
+    TimerBase& base = s_bases[self];
+    base.lock.lock();
+
+    t.expires = deadline;
+    t.cpu     = self;
+    base.hrtimers.insert(t);
+    if (deadline < base.programmed) {
+        program(base, deadline);
+    }
+    base.lock.unlock();
+    io::irqRestore(flags);
+}
+
+bool Timers::cancel(Timer& t) {
+    const u32 cpu = __atomic_load_n(&t.cpu, __ATOMIC_RELAXED);
+    if (cpu == kNoCpu) {
+        return false;
+    }
+
+    const u64 flags = io::irqSave();
+    TimerBase& base = s_bases[cpu];
+    base.lock.lock();
+    const bool pending = t.pending();
+    if (pending) {
+        base.wheel.erase(t);
+    }
+    waitForCallback(base, &t, cpu);
+    base.lock.unlock();
+    io::irqRestore(flags);
+    return pending;
+}
+
+bool Timers::cancel(HrTimer& t) {
+    const u32 cpu = __atomic_load_n(&t.cpu, __ATOMIC_RELAXED);
+    if (cpu == kNoCpu) {
+        return false;
+    }
+
+    const u64 flags = io::irqSave();
+    TimerBase& base = s_bases[cpu];
+    base.lock.lock();
+    const bool pending = t.pending();
+    if (pending) {
+        const bool first = base.hrtimers.first() == &t;
+        base.hrtimers.erase(t);
+        // Only the owning CPU can reach its LAPIC; a remote cancel leaves
+        // an early interrupt behind.
+        if (first && cpu == Cpu::currentId() && t.expires == base.programmed) {
+            program(base, firstDeadline(base));
+        }
+    }
+    waitForCallback(base, &t, cpu);
+    base.lock.unlock();
+    io::irqRestore(flags);
+    return pending;
+}
+
+Timers::Stats Timers::stats() {
+    return Stats {
+        .interrupts = s_interrupts.sum(),
+        .empty      = s_empty.sum(),
+        .expired    = s_expired.sum(),
+        .programs   = s_programs.sum(),
+    };
+}
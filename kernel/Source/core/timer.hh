@@ -0,0 +1,81 @@
+#ifndef TIMER_HH
+#define TIMER_HH
+
+#include <ktl/rbtree>
+#include <ktl/timer_wheel>
+
+// Per-CPU kernel timers, run from the LAPIC timer in one-shot mode.
+//
+//   Timer    On a hierarchical timing wheel (ktl/timer_wheel) with a
+//            resolution of kWheelTickNs: O(1) arm and cancel however many
+//            are pending. For timeouts that mostly get cancelled before
+//            they fire: I/O, sleeps, retransmits.
+//   HrTimer  In a tree ordered by deadline, to the nanosecond, for the
+//            few that have to be on time, like the scheduler tick.
+//
+// Deadlines are ktl::clock::now() nanoseconds. A timer is armed on the
+// calling CPU and fires there; wheel timers never fire early, but may fire
+// up to a wheel tick late.
+//
+// Each CPU keeps its LAPIC armed for the first deadline it has and only
+// writes it again when that changes: arming a timer that goes first, or
+// cancelling the hrtimer it was armed for. Cancelling a wheel timer leaves
+// it alone; if that timer was first, the interrupt finds nothing due and
+// arms the next deadline instead. Wheel buckets cascade lazily, whenever
+// the CPU next takes the interrupt.
+//
+// Callbacks run in the timer interrupt with interrupts disabled and no
+// timer lock held; they must not block, and may re-arm their own timer.
+// Arming and cancelling the same timer from two CPUs at once is the
+// caller's problem. Without x2APIC nothing ever fires.
+
+using TimerFunc = void (*)(void* data);
+
+struct Timer {
+    ktl::wheel_node node;
+    TimerFunc       func = nullptr;
+    void*           data = nullptr;
+    // CPU it was last armed on.
+    u32 cpu = ~0u;
+
+    bool pending() const { return node.is_linked(); }
+};
+
+struct HrTimer {
+    ktl::rb_node node;
+    u64          expires = 0;
+    TimerFunc    func    = nullptr;
+    void*        data    = nullptr;
+    u32          cpu     = ~0u;
+
+    bool pending() const { return node.is_linked(); }
+};
+
+class Timers {
+public:
+    static constexpr u64 kWheelTickNs = 1'000'000;
+
+    struct Stats {
+        u64 interrupts;
+        u64 empty;        // interrupts with nothing due
+        u64 expired;
+        u64 programs;     // LAPIC deadline writes
+    };
+
+    // Boot CPU, after Lapic::init(): takes over the LAPIC timer vector.
+    static void init();
+
+    // Arms t for deadline on the calling CPU, first cancelling it wherever
+    // it is pending.
+    static void arm(Timer& t, u64 deadline);
+    static void arm(HrTimer& t, u64 deadline);
+
+    // Returns whether t was pending. Either way, t's callback is not
+    // running on another CPU when this returns, so t may be freed.
+    static bool cancel(Timer& t);
+    static bool cancel(HrTimer& t);
+
+    static Stats stats();
+};
+
+#endif // TIMER_HH
@@ -0,0 +1,158 @@
+#include <core/wait.hh>
+#include <arch/io.hh>
+#include <arch/lapic.hh>
+#include <core/sched.hh>
+#include <core/timer.hh>
+#include <ktl/clock>
+
+namespace {
+
+using ktl::memory_order_acquire;
+using ktl::memory_order_relaxed;
+using ktl::memory_order_release;
+using ktl::memory_order_seq_cst;
+
+void unparkThread(void* data) {
+    Scheduler::unpark(static_cast<Thread*>(data));
+}
+
+} // namespace
+
+void Waiter::prepare() {
+    thread = Scheduler::current();
+    woken.store(false, memory_order_relaxed);
+}
+
+bool Waiter::sleep(u64 deadline) {
+    if (!Scheduler::canBlock()) {
+        while (!woken.load(memory_order_acquire) && ktl::clock::now() < deadline) {
+            io::pause();
+        }
+        return woken.load(memory_order_acquire);
+    }
+    if (deadline == kWaitForever) {
+        while (!woken.load(memory_order_acquire)) {
+            Scheduler::park();
+        }
+        return true;
+    }
+    // Without the LAPIC no timer fires; give the CPU away until it is time.
+    if (!Lapic::available()) {
+        while (!woken.load(memory_order_acquire) && ktl::clock::now() < deadline) {
+            Scheduler::yield();
+        }
+        return woken.load(memory_order_acquire);
+    }
+
+    Timer timeout;
+    timeout.func = unparkThread;
+    timeout.data = thread;
+    Timers::arm(timeout, deadline);
+    while (!woken.load(memory_order_acquire) && ktl::clock::now() < deadline) {
+        Scheduler::park();
+    }
+    Timers::cancel(timeout);
+    return woken.load(memory_order_acquire);
+}
+
+void Waiter::wake() {
+    // The waiter may return, and this Waiter go away, as soon as woken is
+    // set.
+    Thread* const t = thread;
+    woken.store(true, memory_order_release);
+    Scheduler::unpark(t);
+}
+
+void WaitQueue::enqueue(Waiter& w) {
+    ktl::IrqAutoLock<ktl::SpinLock> guard(m_lock);
+    m_waiters.push_back(w);
+    // Counted before the waiter looks at its condition, and the waker
+    // fences after making the condition true: one of the two sees the
+    // other.
+    m_sleepers.fetch_add(1, memory_order_seq_cst);
+}
+
+bool WaitQueue::dequeue(Waiter& w) {
+    ktl::IrqAutoLock<ktl::SpinLock> guard(m_lock);
+    if (!w.link.is_linked()) {
+        return true;
+    }
+    m_waiters.remove(w);
+    m_sleepers.fetch_sub(1, memory_order_relaxed);
+    return false;
+}
+
+u32 WaitQueue::wake(u32 count) {
+    ktl::atomic_thread_fence(memory_order_seq_cst);
+    if (m_sleepers.load(memory_order_relaxed) == 0) {
+        return 0;
+    }
+
+    ktl::IrqAutoLock<ktl::SpinLock> guard(m_lock);
+    u32 woken = 0;
+    while (woken < count) {
+        Waiter* const w = m_waiters.pop_front();
+        if (w == nullptr) {
+            break;
+        }
+        m_sleepers.fetch_sub(1, memory_order_relaxed);
+        w->wake();
+        ++woken;
+    }
+    return woken;
+}
+
+void Completion::complete() {
+    u32 done = m_done.load(memory_order_relaxed);
+    while (done != kAll) {
+        if (m_done.compare_exchange_weak(done, done + 1, memory_order_release, memory_order_relaxed)) {
+            break;
+        }
+    }
+    m_queue.wakeOne();
+}
+
+void Completion::completeAll() {
+    m_done.store(kAll, memory_order_release);
+    m_queue.wakeAll();
+}
+
+bool Completion::tryWait() {
+    u32 done = m_done.load(memory_order_acquire);
+    while (done != 0) {
+        if (done == kAll) {
+            return true;
+        }
+        if (m_done.compare_exchange_weak(done, done - 1, memory_order_acquire, memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Semaphore::tryDown() {
+    u32 count = m_count.load(memory_order_relaxed);
+    while (count != 0) {
+        if (m_count.compare_exchange_weak(count, count - 1, memory_order_acquire, memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Semaphore::up(u32 count) {
+    m_count.fetch_add(count, memory_order_release);
+    m_queue.wake(count);
+}
+
+void sleep_until(u64 deadline) {
+    // On no queue, so nothing wakes it before deadline.
+    Waiter w;
+    w.prepare();
+    w.sleep(deadline);
+}
+
+void sleep_for(u64 ns) {
+    const u64 now = ktl::clock::now();
+    sleep_until(ns > kWaitForever - now ? kWaitForever : now + ns);
+}
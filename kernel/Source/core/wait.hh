@@ -0,0 +1,168 @@
+#ifndef WAIT_HH
+#define WAIT_HH
+
+#include <ktl/atomic>
+#include <ktl/list>
+#include <ktl/spinlock>
+
+// Sleeping until something happens, instead of spinning for it.
+//
+//   WaitQueue   Threads waiting for a condition on some object; whoever
+//               makes it true wakes one or all of them.
+//   Completion  A one-shot or repeatable "done" event.
+//   Semaphore   A counting semaphore.
+//
+// Futexes (core/futex.hh) wait on a word in memory instead, in a table
+// hashed by its address, so a word needs no queue of its own.
+//
+// Waiters park through the scheduler and are woken one by one: a waker
+// takes exactly the waiters it means to wake off the queue before it
+// unparks them. Waking a queue nobody sleeps on is one fence and a load.
+// Deadlines are ktl::clock::now() nanoseconds, run on a wheel timer
+// (core/timer.hh). Where Scheduler::canBlock() says the caller may not
+// block (interrupt handlers, the idle thread, preemption or interrupts
+// disabled, early boot) a wait spins instead.
+
+struct Thread;
+
+inline constexpr u64 kWaitForever = ~0ULL;
+
+// A thread sleeping on a WaitQueue or a futex.
+struct Waiter {
+    ktl::list_node    link;
+    const void*       key    = nullptr;   // futex address
+    Thread*           thread = nullptr;
+    ktl::atomic<bool> woken { false };
+
+    // Makes the calling thread the one waiting; before queueing.
+    void prepare();
+
+    // Blocks until wake() or deadline, whichever is first; returns whether
+    // the waiter was woken.
+    bool sleep(u64 deadline);
+
+    // Called by the waker once it has taken the waiter off its queue,
+    // with the queue still locked, so a waiter that gives up at its
+    // deadline and finds itself off the queue knows it was woken.
+    void wake();
+};
+
+using WaiterList = ktl::intrusive_list<Waiter, &Waiter::link>;
+
+class WaitQueue {
+public:
+    constexpr WaitQueue() = default;
+    WaitQueue(const WaitQueue&) = delete;
+    WaitQueue& operator=(const WaitQueue&) = delete;
+
+    // Blocks until cond() returns true, or deadline passes; returns the
+    // last cond(). cond runs on the waiting thread without the queue
+    // locked, may run more than once, and may consume what it checks for.
+    // A waker makes it true first and then calls wake().
+    template<typename Cond>
+    bool wait(Cond&& cond, u64 deadline = kWaitForever) {
+        if (cond()) {
+            return true;
+        }
+        Waiter w;
+        for (;;) {
+            // A waiter woken for a condition someone else consumed goes
+            // back on the queue; it must not look woken already.
+            w.prepare();
+            enqueue(w);
+            if (cond()) {
+                dequeue(w);
+                return true;
+            }
+            const bool timed_out = !w.sleep(deadline);
+            const bool woken     = dequeue(w);
+            if (cond()) {
+                return true;
+            }
+            if (timed_out) {
+                // A wakeup meant for this waiter goes to the next one.
+                if (woken) {
+                    wake(1);
+                }
+                return false;
+            }
+        }
+    }
+
+    // Wakes up to count waiters, oldest first, and returns how many.
+    u32 wake(u32 count);
+    u32 wakeOne() { return wake(1); }
+    u32 wakeAll() { return wake(~0u); }
+
+private:
+    void enqueue(Waiter& w);
+    // Returns whether a waker took w off the queue.
+    bool dequeue(Waiter& w);
+
+    ktl::SpinLock    m_lock;
+    WaiterList       m_waiters;
+    ktl::atomic<u32> m_sleepers { 0 };
+};
+
+class Completion {
+public:
+    constexpr Completion() = default;
+
+    // Lets one wait() through, now or later.
+    void complete();
+
+    // Lets every wait() through until reinit().
+    void completeAll();
+
+    // Blocks until complete(), and consumes it. Returns false if deadline
+    // passed first.
+    bool wait(u64 deadline = kWaitForever) {
+        return m_queue.wait([this] { return tryWait(); }, deadline);
+    }
+
+    // Consumes a complete() if there is one.
+    bool tryWait();
+
+    bool done() const { return m_done.load(ktl::memory_order_acquire) != 0; }
+
+    void reinit() { m_done.store(0, ktl::memory_order_relaxed); }
+
+private:
+    static constexpr u32 kAll = ~0u;
+
+    WaitQueue        m_queue;
+    ktl::atomic<u32> m_done { 0 };
+};
+
+class Semaphore {
+public:
+    constexpr explicit Semaphore(u32 count = 0) : m_count(count) {}
+
+    // Takes one unit, blocking until there is one.
+    void down() {
+        m_queue.wait([this] { return tryDown(); });
+    }
+
+    // As down(), but gives up at deadline; returns whether it took one.
+    bool downUntil(u64 deadline) {
+        return m_queue.wait([this] { return tryDown(); }, deadline);
+    }
+
+    bool tryDown();
+
+    // Returns count units, waking as many waiters.
+    void up(u32 count = 1);
+
+    u32 value() const { return m_count.load(ktl::memory_order_relaxed); }
+
+private:
+    WaitQueue        m_queue;
+    ktl::atomic<u32> m_count;
+};
+
+// Sleeps the calling thread until ktl::clock::now() reaches deadline, or
+// for ns nanoseconds, on a wheel timer: up to a wheel tick late.
+void sleep_until(u64 deadline);
+void sleep_for(u64 ns);
+
+#endif // WAIT_HH
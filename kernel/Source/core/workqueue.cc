@@ -0,0 +1,359 @@
+#include <core/workqueue.hh>
+#include <arch/cpu.hh>
+#include <arch/idt.hh>
+#include <arch/smp.hh>
+#include <core/format.hh>
+#include <ktl/bitset>
+#include <ktl/ring>
+
+namespace {
+
+using ktl::memory_order_acq_rel;
+using ktl::memory_order_acquire;
+using ktl::memory_order_relaxed;
+using ktl::memory_order_release;
+
+using WorkList = ktl::intrusive_list<Work, &Work::link>;
+
+constexpr usize kDequeSize = 256;
+constexpr u32   kMaxJobs   = 16;
+constexpr u32   kNoJob     = ~0u;
+
+// Slices carry chunk indices in kChunkBits each, so a job has fewer than
+// kMaxChunks chunks; parallelFor() widens the grain of larger ranges.
+constexpr u32 kChunkBits = 30;
+constexpr u64 kMaxChunks = 1ULL << kChunkBits;
+
+// Chunks [first, last) of job `job`, packed into a word for the deques.
+struct Slice {
+    u32 job;
+    u64 first;
+    u64 last;
+
+    u64 pack() const {
+        return (static_cast<u64>(job) << (2 * kChunkBits)) | (first << kChunkBits) | last;
+    }
+
+    static Slice unpack(u64 packed) {
+        return Slice {
+            .job   = static_cast<u32>(packed >> (2 * kChunkBits)),
+            .first = (packed >> kChunkBits) & (kMaxChunks - 1),
+            .last  = packed & (kMaxChunks - 1),
+        };
+    }
+};
+
+// One parallelFor() call. Chunk i covers grain elements from
+// begin + i * grain, the last one cut off at end.
+struct Job {
+    const ktl::function_ref<void(u64, u64)>* fn = nullptr;
+    u64 begin = 0;
+    u64 end   = 0;
+    u64 grain = 0;
+    ktl::atomic<u64> remaining { 0 };   // chunks not run yet
+
+    // done and waiter are only touched under lock, so the last worker is
+    // through with the job before the caller sees it done and reuses it.
+    ktl::SpinLock lock;
+    bool          done   = false;
+    Thread*       waiter = nullptr;
+
+    // Every worker's first slice, queued as ordinary work.
+    Work seeds[kMaxCpus];
+    u64  seed_slices[kMaxCpus] = {};
+};
+
+struct alignas(64) Queues {
+    ktl::SpinLock    lock;
+    WorkList         lists[Workqueue::kPriorities];
+    ktl::atomic<u32> queued { 0 };
+};
+
+struct alignas(64) Worker {
+    ktl::ws_deque<u64, kDequeSize> slices;
+    Queues                         pinned;
+    Thread*                        thread = nullptr;
+};
+
+constinit Worker s_workers[kMaxCpus];
+constinit Queues s_shared;
+constinit Job    s_jobs[kMaxJobs];
+
+ktl::bitset<kMaxJobs> s_jobs_used;
+// Workers that found nothing to do and parked, or are about to.
+ktl::bitset<kMaxCpus> s_parked;
+ktl::atomic<bool>     s_started { false };
+
+void wake(u32 cpu) {
+    if (s_parked.atomic_test_and_reset(cpu)) {
+        Scheduler::unpark(s_workers[cpu].thread);
+    }
+}
+
+void wakeAny() {
+    for (usize cpu = s_parked.find_first_set(); cpu != s_parked.npos;
+         cpu = s_parked.find_next_set(cpu + 1)) {
+        if (s_parked.atomic_test_and_reset(cpu)) {
+            Scheduler::unpark(s_workers[cpu].thread);
+            return;
+        }
+    }
+}
+
+void push(Queues& q, Work& w, u32 priority) {
+    ktl::IrqAutoLock<ktl::SpinLock> guard(q.lock);
+    q.lists[priority].push_back(w);
+    q.queued.fetch_add(1, memory_order_release);
+}
+
+Work* take(Queues& q, u32 priority) {
+    if (q.queued.load(memory_order_acquire) == 0) {
+        return nullptr;
+    }
+    ktl::IrqAutoLock<ktl::SpinLock> guard(q.lock);
+    Work* const w = q.lists[priority].pop_front();
+    if (w != nullptr) {
+        q.queued.fetch_sub(1, memory_order_relaxed);
+    }
+    return w;
+}
+
+void finishGroup(WorkGroup& g) {
+    ktl::IrqAutoLock<ktl::SpinLock> guard(g.lock);
+    if (--g.pending == 0 && g.waiter != nullptr) {
+        Scheduler::unpark(g.waiter);
+    }
+}
+
+void runWork(Work& w) {
+    // w belongs to its submitter again once func returns.
+    WorkGroup* const group = w.group;
+    w.func(w.data);
+    if (group != nullptr) {
+        finishGroup(*group);
+    }
+}
+
+void finishJob(Job& job, u64 chunks) {
+    if (job.remaining.fetch_sub(chunks, memory_order_acq_rel) != chunks) {
+        return;
+    }
+    ktl::IrqAutoLock<ktl::SpinLock> guard(job.lock);
+    job.done = true;
+    if (job.waiter != nullptr) {
+        Scheduler::unpark(job.waiter);
+    }
+}
+
+// Halves the slice, leaving the upper halves for thieves, until one chunk
+// is left or the deque is full, then runs what remains.
+void runSlice(Worker& self, u64 packed) {
+    Slice s = Slice::unpack(packed);
+    Job& job = s_jobs[s.job];
+    while (s.last - s.first > 1) {
+        const u64 mid = s.first + (s.last - s.first) / 2;
+        if (!self.slices.try_push(Slice { s.job, mid, s.last }.pack())) {
+            break;
+        }
+        wakeAny();
+        s.last = mid;
+    }
+
+    const u64 first = job.begin + s.first * job.grain;
+    const u64 last  = job.begin + s.last * job.grain;
+    (*job.fn)(first, last < job.end ? last : job.end);
+    finishJob(job, s.last - s.first);
+}
+
+void runSeed(void* data) {
+    runSlice(s_workers[Cpu::currentId()], *static_cast<u64*>(data));
+}
+
+bool steal(u32 self, u64& slice) {
+    for (u32 cpu = Smp::nextOnlineAfter(self); cpu != self; cpu = Smp::nextOnlineAfter(cpu)) {
+        if (s_workers[cpu].slices.try_steal(slice)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// High-priority work first, then slices of jobs already running, then the
+// rest of the work, then slices stolen from other workers.
+bool runOne(u32 cpu) {
+    Worker& self = s_workers[cpu];
+    for (u32 priority = 0; priority < Workqueue::kPriorities; ++priority) {
+        Work* w = take(self.pinned, priority);
+        if (w == nullptr) {
+            w = take(s_shared, priority);
+        }
+        if (w != nullptr) {
+            runWork(*w);
+            return true;
+        }
+        u64 slice;
+        if (priority == 0 && self.slices.try_pop(slice)) {
+            runSlice(self, slice);
+            return true;
+        }
+    }
+    u64 slice;
+    if (steal(cpu, slice)) {
+        runSlice(self, slice);
+        return true;
+    }
+    return false;
+}
+
+// Runs one item, or parks until submit() or a new slice wakes the worker.
+// The parked bit goes up before the last look at the queues, so work
+// queued after that look finds it set.
+void runOrPark(u32 cpu) {
+    if (runOne(cpu)) {
+        return;
+    }
+    s_parked.atomic_set(cpu);
+    if (runOne(cpu)) {
+        s_parked.atomic_reset(cpu);
+        return;
+    }
+    Scheduler::park();
+    s_parked.atomic_reset(cpu);
+}
+
+bool onWorker(u32 cpu) {
+    return s_started.load(memory_order_acquire) && Scheduler::current() == s_workers[cpu].thread;
+}
+
+// Waiting on a worker keeps its CPU's work flowing, or the work waited on
+// might be queued right behind the waiter.
+void waitStep() {
+    const u32 cpu = Cpu::currentId();
+    if (onWorker(cpu)) {
+        runOrPark(cpu);
+    } else {
+        Scheduler::park();
+    }
+}
+
+u32 claimJob() {
+    for (u32 slot = 0; slot < kMaxJobs; ++slot) {
+        if (!s_jobs_used.atomic_test_and_set(slot)) {
+            return slot;
+        }
+    }
+    return kNoJob;
+}
+
+void runSerial(u64 begin, u64 end, u64 grain, ktl::function_ref<void(u64, u64)> fn) {
+    for (u64 first = begin; first < end; ) {
+        const u64 last = end - first > grain ? first + grain : end;
+        fn(first, last);
+        first = last;
+    }
+}
+
+} // namespace
+
+void Workqueue::init() {
+    for_each_online_cpu(cpu) {
+        Thread* const t = Scheduler::spawn("worker", [cpu] {
+            for (;;) {
+                runOrPark(cpu);
+            }
+        }, cpu);
+        if (t == nullptr) {
+            InterruptDescriptorTable::kpanic(nullptr, "workqueue: no thread for CPU {}'s worker", cpu);
+        }
+        s_workers[cpu].thread = t;
+    }
+    s_started.store(true, memory_order_release);
+
+    if constexpr (kDebugMode) {
+        Fmt::printf("workqueue: {} workers\n", Smp::cpuCount());
+    }
+}
+
+void Workqueue::submit(Work& w, Priority priority, u32 cpu) {
+    if (w.group != nullptr) {
+        ktl::IrqAutoLock<ktl::SpinLock> guard(w.group->lock);
+        ++w.group->pending;
+    }
+    if (!s_started.load(memory_order_acquire)) {
+        runWork(w);
+        return;
+    }
+
+    const u32 prio = static_cast<u32>(priority);
+    if (cpu == Scheduler::kAnyCpu) {
+        push(s_shared, w, prio);
+        wakeAny();
+    } else {
+        push(s_workers[cpu].pinned, w, prio);
+        wake(cpu);
+    }
+}
+
+void Workqueue::wait(WorkGroup& g) {
+    for (;;) {
+        {
+            ktl::IrqAutoLock<ktl::SpinLock> guard(g.lock);
+            if (g.pending == 0) {
+                g.waiter = nullptr;
+                return;
+            }
+            g.waiter = Scheduler::current();
+        }
+        waitStep();
+    }
+}
+
+void Workqueue::parallelFor(u64 begin, u64 end, u64 grain,
+                            ktl::function_ref<void(u64, u64)> fn, Priority priority) {
+    if (begin >= end) {
+        return;
+    }
+    const u64 count = end - begin;
+    grain = grain == 0 ? 1 : grain;
+    if (count / grain >= kMaxChunks - 1) {
+        grain = count / (kMaxChunks - 2);
+    }
+    const u64 chunks = count / grain + (count % grain != 0);
+
+    const u32 slot = chunks > 1 && s_started.load(memory_order_acquire) ? claimJob() : kNoJob;
+    if (slot == kNoJob) {
+        runSerial(begin, end, grain, fn);
+        return;
+    }
+
+    Job& job = s_jobs[slot];
+    job.fn     = &fn;
+    job.begin  = begin;
+    job.end    = end;
+    job.grain  = grain;
+    job.done   = false;
+    job.waiter = Scheduler::current();
+    job.remaining.store(chunks, memory_order_relaxed);
+
+    const u32 cpus  = Smp::cpuCount();
+    const u32 parts = chunks < cpus ? static_cast<u32>(chunks) : cpus;
+    u32 cpu = Smp::nextOnline(0);
+    for (u32 i = 0; i < parts; ++i, cpu = Smp::nextOnline(cpu + 1)) {
+        job.seed_slices[i] = Slice { slot, chunks * i / parts, chunks * (i + 1) / parts }.pack();
+        job.seeds[i].func  = runSeed;
+        job.seeds[i].data  = &job.seed_slices[i];
+        job.seeds[i].group = nullptr;
+        submit(job.seeds[i], priority, cpu);
+    }
+
+    for (;;) {
+        {
+            ktl::IrqAutoLock<ktl::SpinLock> guard(job.lock);
+            if (job.done) {
+                break;
+            }
+        }
+        waitStep();
+    }
+    s_jobs_used.atomic_reset(slot);
+}
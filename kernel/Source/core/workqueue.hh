@@ -0,0 +1,72 @@
+#ifndef WORKQUEUE_HH
+#define WORKQUEUE_HH
+
+#include <core/sched.hh>
+#include <ktl/function>
+#include <ktl/spinlock>
+
+// Deferred and parallel work, run by one worker thread per CPU.
+//
+// Work items are queued by priority, either on a given CPU or on a shared
+// queue any worker may take them from. A worker runs everything of a
+// higher priority before anything of a lower one, and parks when there is
+// nothing left.
+//
+// parallelFor() splits a range over all workers. Each gets an equal part
+// and keeps halving it: the upper half goes on the worker's work-stealing
+// deque (ktl/ring), the lower half is worked on, down to grain-sized
+// chunks. A worker that runs dry steals from the top of another's deque,
+// where the largest pieces are, so an uneven range still finishes about
+// together on every CPU. Pieces of a running parallelFor() come after
+// High work and before the rest.
+
+using WorkFunc = void (*)(void* data);
+
+// A set of work items to wait for.
+struct WorkGroup {
+    ktl::SpinLock lock;
+    u32           pending = 0;
+    Thread*       waiter  = nullptr;
+};
+
+struct Work {
+    ktl::list_node link;
+    WorkFunc       func  = nullptr;
+    void*          data  = nullptr;
+    WorkGroup*     group = nullptr;
+};
+
+class Workqueue {
+public:
+    enum class Priority : u8 {
+        High,
+        Normal,
+        Low,
+    };
+
+    static constexpr u32 kPriorities = 3;
+
+    // Boot CPU, after Smp::init(): starts a worker on every online CPU.
+    // Until then work runs on the caller.
+    static void init();
+
+    // Queues w to run once on cpu's worker, or on any worker for kAnyCpu.
+    // w must not be queued already and must stay alive until it has run.
+    // With a group, counts w in it until its function returns. Any
+    // context, interrupt handlers included.
+    static void submit(Work& w, Priority priority = Priority::Normal,
+                       u32 cpu = Scheduler::kAnyCpu);
+
+    // Waits until every item submitted with g has run. A worker waiting
+    // runs other work meanwhile instead of parking.
+    static void wait(WorkGroup& g);
+
+    // Calls fn(first, last) over disjoint subranges covering [begin, end),
+    // each of about grain elements, on all CPUs, and returns when all have
+    // run. fn must be safe to run concurrently with itself.
+    static void parallelFor(u64 begin, u64 end, u64 grain,
+                            ktl::function_ref<void(u64, u64)> fn,
+                            Priority priority = Priority::Normal);
+};
+
+#endif // WORKQUEUE_HH
@@ -0,0 +1,124 @@
+#include <ktl/bench>
+#include <arch/io.hh>
+#include <arch/tsc.hh>
+#include <core/format.hh>
+
+// Output is line-oriented so the log can be scraped (see bench-json in the
+// repository root):
+//
+//   BENCH-START overhead=<cycles> count=<n>
+//   BENCH name=<name> iters=<n> min=<c> median=<c> p99=<c> [<counter>=<n>]
+//   BENCH-DONE
+//
+// Cycle counts are per operation with two decimals, already corrected for
+// the cost of the timestamp reads themselves.
+
+namespace {
+
+using Log = FmtBase<SerialCOM2>;
+
+constexpr usize kSamples       = 101;
+constexpr usize kWarmupSamples = 5;
+constexpr u64   kTargetCycles  = 200'000;
+constexpr u64   kMaxIters      = 1ULL << 24;
+
+u64 s_overhead = 0;
+u64 s_samples[kSamples];
+
+const char* s_counter_name  = nullptr;
+u64         s_counter_value = 0;
+
+u64 measure(const ktl::bench::Benchmark& b, u64 iters) {
+    const u64 flags = io::irqSave();
+    const u64 start = Tsc::readOrdered();
+    b.fn(iters);
+    const u64 end = Tsc::readOrdered();
+    io::irqRestore(flags);
+
+    const u64 elapsed = end - start;
+    return elapsed > s_overhead ? elapsed - s_overhead : 0;
+}
+
+// Smallest back-to-back distance of two ordered reads; anything above it in
+// a sample is the benchmark body.
+u64 calibrate() {
+    u64 best = static_cast<u64>(-1);
+    for (usize i = 0; i < 1000; ++i) {
+        const u64 a = Tsc::readOrdered();
+        const u64 b = Tsc::readOrdered();
+        if (b - a < best) {
+            best = b - a;
+        }
+    }
+    return best;
+}
+
+void sortSamples(u64* v, usize n) {
+    for (usize i = 1; i < n; ++i) {
+        const u64 x = v[i];
+        usize j = i;
+        for (; j > 0 && v[j - 1] > x; --j) {
+            v[j] = v[j - 1];
+        }
+        v[j] = x;
+    }
+}
+
+void printCycles(const char* key, u64 hundredths) {
+    Log::printf(" {}={}.{:02}", key, hundredths / 100, hundredths % 100);
+}
+
+bool run(const ktl::bench::Benchmark& b) {
+    // Double the batch until one sample is long enough that rdtsc jitter
+    // stops mattering, then throw away a few samples to settle caches.
+    s_counter_name = nullptr;
+    u64 iters = 1;
+    while (measure(b, iters) < kTargetCycles && iters < kMaxIters) {
+        iters *= 2;
+    }
+
+    for (usize i = 0; i < kWarmupSamples; ++i) {
+        measure(b, iters);
+    }
+
+    for (usize i = 0; i < kSamples; ++i) {
+        s_samples[i] = measure(b, iters) * 100 / iters;
+    }
+    sortSamples(s_samples, kSamples);
+
+    Log::printf("BENCH name={} iters={}", b.name, iters);
+    printCycles("min",    s_samples[0]);
+    printCycles("median", s_samples[kSamples / 2]);
+    printCycles("p99",    s_samples[kSamples * 99 / 100]);
+    if (s_counter_name) {
+        Log::printf(" {}={}", s_counter_name, s_counter_value);
+    }
+    Log::print("\n");
+
+    return s_samples[kSamples - 1] != 0;
+}
+
+} // namespace
+
+void ktl::bench::counter(const char* name, u64 value) {
+    s_counter_name  = name;
+    s_counter_value = value;
+}
+
+bool ktl::bench::runAll() {
+    s_overhead = calibrate();
+
+    const usize count = static_cast<usize>(__bench_end - __bench_start);
+    Log::printf("BENCH-START overhead={} count={}\n", s_overhead, count);
+
+    bool ok = true;
+    for (const Benchmark* b = __bench_start; b != __bench_end; ++b) {
+        if (!run(*b)) {
+            Log::printf("BENCH-ERROR name={} reason=zero-duration\n", b->name);
+            ok = false;
+        }
+    }
+
+    Log::print("BENCH-DONE\n");
+    return ok;
+}
@@ -0,0 +1,37 @@
+#include <ktl/clock>
+
+namespace {
+
+constexpr u64 kNsPerSec = 1'000'000'000;
+
+} // namespace
+
+ktl::seqlocked<ktl::clock::detail::params> ktl::clock::detail::g_params;
+
+void ktl::clock::start(u64 frequency) {
+    using namespace detail;
+
+    // Both factors stay in 64 bits: 1e9 << 32 is below 2^62, and the
+    // inverse is split so no intermediate exceeds that either.
+    const u64 mult     = (kNsPerSec << kShift) / frequency;
+    const u64 inv_mult = ((frequency / kNsPerSec) << kShift)
+                       + ((frequency % kNsPerSec) << kShift) / kNsPerSec;
+
+    g_params.update([&](params& p) {
+        const u64 tsc = Tsc::read();
+        // Carry the time already counted over into the new base, so a
+        // recalibration does not step now().
+        const u64 elapsed = p.mult ? scale(tsc - p.base_tsc, p.mult) : 0;
+        p.base_tsc         = tsc - scale(elapsed, inv_mult);
+        p.mult             = mult;
+        p.inv_mult         = inv_mult;
+        p.frequency        = frequency;
+    });
+}
+
+void ktl::clock::set_realtime(u64 unix_ns) {
+    const u64 monotonic = now();
+    detail::g_params.update([&](detail::params& p) {
+        p.realtime_offset = unix_ns - monotonic;
+    });
+}
@@ -0,0 +1,157 @@
+#include <ktl/rcu>
+#include <ktl/spinlock>
+#include <arch/cpu.hh>
+#include <arch/io.hh>
+
+namespace {
+
+using namespace ktl;
+
+struct alignas(64) RcuCpu {
+    // Latest grace period this CPU has passed a quiescent state for.
+    atomic<u64>  qs_seq;
+    atomic<bool> idle;
+    atomic<bool> online;
+};
+
+// Number of the most recently started grace period.
+atomic<u64> s_gp_seq;
+
+RcuCpu s_cpus[kMaxCpus];
+
+// Callbacks are batched in two stages: `next` collects new callbacks while
+// the `wait` batch waits for grace period s_wait_gp. When that one ends the
+// wait batch runs, and the next batch starts a new grace period.
+SpinLock   s_callbacks;
+rcu_head*  s_next_head = nullptr;
+rcu_head** s_next_tail = &s_next_head;
+rcu_head*  s_wait_head = nullptr;
+u64        s_wait_gp   = 0;
+
+void reportQuiescent(u32 cpu) {
+    s_cpus[cpu].qs_seq.store(s_gp_seq.load(memory_order_acquire), memory_order_release);
+}
+
+bool passedQuiescent(u32 cpu, u64 gp) {
+    const RcuCpu& c = s_cpus[cpu];
+    return !c.online.load(memory_order_seq_cst) ||
+           c.idle.load(memory_order_seq_cst) ||
+           c.qs_seq.load(memory_order_acquire) >= gp;
+}
+
+bool gracePeriodDone(u64 gp) {
+    for (u32 cpu = 0; cpu < kMaxCpus; ++cpu) {
+        if (!passedQuiescent(cpu, gp)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+u64 startGracePeriod() {
+    return s_gp_seq.fetch_add(1, memory_order_seq_cst) + 1;
+}
+
+void runCallbacks(rcu_head* list) {
+    while (list) {
+        rcu_head* next = list->next;
+        list->func(list);
+        list = next;
+    }
+}
+
+void advanceCallbacks() {
+    rcu_head* done = nullptr;
+
+    const u64 flags = s_callbacks.lock_irqsave();
+    if (s_wait_head && gracePeriodDone(s_wait_gp)) {
+        done = s_wait_head;
+        s_wait_head = nullptr;
+    }
+    if (!s_wait_head && s_next_head) {
+        s_wait_head = s_next_head;
+        s_wait_gp   = startGracePeriod();
+        s_next_head = nullptr;
+        s_next_tail = &s_next_head;
+    }
+    s_callbacks.unlock_irqrestore(flags);
+
+    runCallbacks(done);
+}
+
+} // namespace
+
+void ktl::synchronize_rcu() {
+    const u32 self = Cpu::currentId();
+    const u64 gp = startGracePeriod();
+
+    s_cpus[self].qs_seq.store(gp, memory_order_release);
+
+    for (u32 cpu = 0; cpu < kMaxCpus; ++cpu) {
+        while (!passedQuiescent(cpu, gp)) {
+            io::pause();
+        }
+    }
+
+    // Any callbacks waiting on an earlier grace period are due as well.
+    advanceCallbacks();
+}
+
+void ktl::call_rcu(rcu_head* head, void (*func)(rcu_head*)) {
+    head->func = func;
+    head->next = nullptr;
+
+    const u64 flags = s_callbacks.lock_irqsave();
+    *s_next_tail = head;
+    s_next_tail = &head->next;
+    s_callbacks.unlock_irqrestore(flags);
+}
+
+bool ktl::rcu_pending() {
+    const u64 flags = s_callbacks.lock_irqsave();
+    const bool pending = s_wait_head != nullptr || s_next_head != nullptr;
+    s_callbacks.unlock_irqrestore(flags);
+    return pending;
+}
+
+void ktl::rcu_quiescent_state() {
+    reportQuiescent(Cpu::currentId());
+    advanceCallbacks();
+}
+
+void ktl::rcu_idle_enter() {
+    const u32 self = Cpu::currentId();
+    reportQuiescent(self);
+    advanceCallbacks();
+    s_cpus[self].idle.store(true, memory_order_seq_cst);
+}
+
+void ktl::rcu_idle_exit() {
+    s_cpus[Cpu::currentId()].idle.store(false, memory_order_seq_cst);
+}
+
+bool ktl::rcu_irq_enter() {
+    RcuCpu& c = s_cpus[Cpu::currentId()];
+    // Only this CPU writes its idle flag, and not while this runs.
+    if (!c.idle.load(memory_order_relaxed)) {
+        return false;
+    }
+    c.idle.store(false, memory_order_seq_cst);
+    return true;
+}
+
+void ktl::rcu_irq_exit(bool was_idle) {
+    if (was_idle) {
+        s_cpus[Cpu::currentId()].idle.store(true, memory_order_seq_cst);
+    }
+}
+
+void ktl::rcu_cpu_online(u32 cpu) {
+    s_cpus[cpu].qs_seq.store(s_gp_seq.load(memory_order_acquire), memory_order_relaxed);
+    s_cpus[cpu].idle.store(false, memory_order_relaxed);
+    s_cpus[cpu].online.store(true, memory_order_seq_cst);
+}
+
+void ktl::rcu_cpu_offline(u32 cpu) {
+    s_cpus[cpu].online.store(false, memory_order_seq_cst);
+}
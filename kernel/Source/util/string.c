@@ -4,38 +4,239 @@
 
 #include <util/string.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <limits.h>
 
 #ifndef LLONG_MAX
-#define LLONG_MAX (sizeof(long long) * CHAR_BIT - 1)
+#define LLONG_MAX __LONG_LONG_MAX__
 #endif
 #ifndef LLONG_MIN
 #define LLONG_MIN (-LLONG_MAX - 1)
 #endif
 
+#define STRING_PAGE_SIZE 4096
+#define STRING_ERMS_THRESHOLD 256
+
+#define STRING_FEAT_PROBED ( 1u << 0 )
+#define STRING_FEAT_ERMS   ( 1u << 1 )
+#define STRING_FEAT_FSRM   ( 1u << 2 )
+
+typedef uint64_t __attribute__(( may_alias, aligned( 1 ) )) u64_unaligned;
+typedef uint32_t __attribute__(( may_alias, aligned( 1 ) )) u32_unaligned;
+typedef uint16_t __attribute__(( may_alias, aligned( 1 ) )) u16_unaligned;
+typedef uint64_t __attribute__(( may_alias )) u64_aliased;
+
+static unsigned string_features;
+
+/* CPUID.(EAX=7,ECX=0):EBX[9] is ERMS, EDX[4] is FSRM. Probed lazily because
+ * memcpy and friends may run before anything else has been initialized. */
+static unsigned string_probe_features( void ) {
+	unsigned features = __atomic_load_n( &string_features, __ATOMIC_RELAXED );
+	if ( features & STRING_FEAT_PROBED ) {
+		return features;
+	}
+
+	features = STRING_FEAT_PROBED;
+	uint32_t eax, ebx, ecx, edx;
+	__asm__ volatile ( "cpuid" : "=a"( eax ), "=b"( ebx ), "=c"( ecx ), "=d"( edx ) : "a"( 0 ), "c"( 0 ) );
+	if ( eax >= 7 ) {
+		__asm__ volatile ( "cpuid" : "=a"( eax ), "=b"( ebx ), "=c"( ecx ), "=d"( edx ) : "a"( 7 ), "c"( 0 ) );
+		if ( ebx & ( 1u << 9 ) ) features |= STRING_FEAT_ERMS;
+		if ( edx & ( 1u << 4 ) ) features |= STRING_FEAT_FSRM;
+	}
+
+	__atomic_store_n( &string_features, features, __ATOMIC_RELAXED );
+	return features;
+}
+
+static inline void string_rep_movsb( void* dest, const void* src, size_t n ) {
+	__asm__ volatile ( "rep movsb" : "+D"( dest ), "+S"( src ), "+c"( n ) : : "memory" );
+}
+
+static inline void string_rep_movsq( void* dest, const void* src, size_t n ) {
+	__asm__ volatile ( "rep movsq" : "+D"( dest ), "+S"( src ), "+c"( n ) : : "memory" );
+}
+
+static inline void string_rep_stosb( void* dest, unsigned char c, size_t n ) {
+	__asm__ volatile ( "rep stosb" : "+D"( dest ), "+c"( n ) : "a"( c ) : "memory" );
+}
+
+static inline void string_rep_stosq( void* dest, uint64_t v, size_t n ) {
+	__asm__ volatile ( "rep stosq" : "+D"( dest ), "+c"( n ) : "a"( v ) : "memory" );
+}
+
+static inline bool string_is_page( const void* p, size_t n ) {
+	return n == STRING_PAGE_SIZE && ( (uintptr_t)p & ( STRING_PAGE_SIZE - 1 ) ) == 0;
+}
+
+#define STRING_ONES  0x0101010101010101ULL
+#define STRING_HIGHS 0x8080808080808080ULL
+
+/* Word-at-a-time scanning. The scanners below only ever load aligned words,
+ * so they never touch a page the string does not already reach into. Bytes
+ * of the first word that precede the string are forced non-zero. */
+
+/* Sets the high bit of every zero byte in x. Bytes above the first zero may
+ * also be flagged (borrow), which is fine since only the lowest one is used. */
+static inline uint64_t string_zero_bytes( uint64_t x ) {
+	return ( x - STRING_ONES ) & ~x & STRING_HIGHS;
+}
+
+static inline size_t string_first_byte( uint64_t zero_mask ) {
+	return (size_t)__builtin_ctzll( zero_mask ) / 8;
+}
+
+static inline uint64_t string_low_bytes( uintptr_t count ) {
+	return count ? ~0ULL >> ( 64 - count * 8 ) : 0;
+}
+
+/* Copies of up to 16 bytes use two possibly overlapping loads so every size
+ * is handled without a loop. Both loads happen before either store, which
+ * keeps this safe for memmove as well. */
+static inline void string_copy_small( unsigned char* d, const unsigned char* s, size_t n ) {
+	if ( n >= 8 ) {
+		uint64_t head = *(const u64_unaligned*)s;
+		uint64_t tail = *(const u64_unaligned*)( s + n - 8 );
+		*(u64_unaligned*)d = head;
+		*(u64_unaligned*)( d + n - 8 ) = tail;
+	} else if ( n >= 4 ) {
+		uint32_t head = *(const u32_unaligned*)s;
+		uint32_t tail = *(const u32_unaligned*)( s + n - 4 );
+		*(u32_unaligned*)d = head;
+		*(u32_unaligned*)( d + n - 4 ) = tail;
+	} else if ( n >= 2 ) {
+		uint16_t head = *(const u16_unaligned*)s;
+		uint16_t tail = *(const u16_unaligned*)( s + n - 2 );
+		*(u16_unaligned*)d = head;
+		*(u16_unaligned*)( d + n - 2 ) = tail;
+	} else if ( n ) {
+		*d = *s;
+	}
+}
+
+/* Forward copy for n > 16: align the destination to 8 bytes, move 32 bytes
+ * per iteration, then finish with the unaligned head and tail words. Those
+ * are loaded up front and stored last so memmove can use this when dest is
+ * below an overlapping src. */
+static void string_copy_forward( unsigned char* d, const unsigned char* s, size_t n ) {
+	uint64_t head_word = *(const u64_unaligned*)s;
+	uint64_t tail_word = *(const u64_unaligned*)( s + n - 8 );
+	unsigned char* head_dest = d;
+	unsigned char* tail_dest = d + n - 8;
+
+	size_t head = ( 8 - ( (uintptr_t)d & 7 ) ) & 7;
+	d += head;
+	s += head;
+	n -= head;
+
+	while ( n >= 32 ) {
+		uint64_t a = ( (const u64_unaligned*)s )[ 0 ];
+		uint64_t b = ( (const u64_unaligned*)s )[ 1 ];
+		uint64_t c = ( (const u64_unaligned*)s )[ 2 ];
+		uint64_t e = ( (const u64_unaligned*)s )[ 3 ];
+		( (u64_aliased*)d )[ 0 ] = a;
+		( (u64_aliased*)d )[ 1 ] = b;
+		( (u64_aliased*)d )[ 2 ] = c;
+		( (u64_aliased*)d )[ 3 ] = e;
+		d += 32;
+		s += 32;
+		n -= 32;
+	}
+	while ( n >= 8 ) {
+		*(u64_aliased*)d = *(const u64_unaligned*)s;
+		d += 8;
+		s += 8;
+		n -= 8;
+	}
+
+	*(u64_unaligned*)tail_dest = tail_word;
+	*(u64_unaligned*)head_dest = head_word;
+}
+
+/* Backward copy for overlapping memmove with dest > src: mirror image of
+ * string_copy_forward, aligning the end of the destination instead. */
+static void string_copy_backward( unsigned char* d, const unsigned char* s, size_t n ) {
+	uint64_t head_word = *(const u64_unaligned*)s;
+	uint64_t tail_word = *(const u64_unaligned*)( s + n - 8 );
+	unsigned char* head_dest = d;
+	unsigned char* tail_dest = d + n - 8;
+
+	unsigned char* de = d + n;
+	const unsigned char* se = s + n;
+	size_t tail = (uintptr_t)de & 7;
+	de -= tail;
+	se -= tail;
+	n -= tail;
+
+	while ( n >= 32 ) {
+		uint64_t a = ( (const u64_unaligned*)se )[ -1 ];
+		uint64_t b = ( (const u64_unaligned*)se )[ -2 ];
+		uint64_t c = ( (const u64_unaligned*)se )[ -3 ];
+		uint64_t e = ( (const u64_unaligned*)se )[ -4 ];
+		( (u64_aliased*)de )[ -1 ] = a;
+		( (u64_aliased*)de )[ -2 ] = b;
+		( (u64_aliased*)de )[ -3 ] = c;
+		( (u64_aliased*)de )[ -4 ] = e;
+		de -= 32;
+		se -= 32;
+		n -= 32;
+	}
+	while ( n >= 8 ) {
+		de -= 8;
+		se -= 8;
+		n -= 8;
+		*(u64_aliased*)de = *(const u64_unaligned*)se;
+	}
+
+	*(u64_unaligned*)tail_dest = tail_word;
+	*(u64_unaligned*)head_dest = head_word;
+}
+
 void* memcpy( void* dest, const void* src, size_t n ) {
 	unsigned char* d = (unsigned char*)( dest );
 	const unsigned char* s = (const unsigned char*)( src );
-	while ( n-- ) {
-		*d++ = *s++;
+
+	if ( n <= 16 ) {
+		string_copy_small( d, s, n );
+		return dest;
+	}
+
+	unsigned features = string_probe_features();
+	if ( string_is_page( d, n ) && string_is_page( s, n ) ) {
+		if ( features & STRING_FEAT_ERMS ) {
+			string_rep_movsb( d, s, n );
+		} else {
+			string_rep_movsq( d, s, n / 8 );
+		}
+		return dest;
+	}
+
+	if ( ( features & STRING_FEAT_FSRM ) ||
+		 ( ( features & STRING_FEAT_ERMS ) && n >= STRING_ERMS_THRESHOLD ) ) {
+		string_rep_movsb( d, s, n );
+		return dest;
 	}
+
+	string_copy_forward( d, s, n );
 	return dest;
 }
 
 void* memmove( void* dest, const void* src, size_t n ) {
 	unsigned char* d = (unsigned char*)( dest );
 	const unsigned char* s = (const unsigned char*)( src );
-	if ( d < s ) {
-		while ( n-- ) {
-			*d++ = *s++;
-		}
-	} else {
-		d += n;
-		s += n;
-		while ( n-- ) {
-			*--d = *--s;
-		}
+
+	if ( n <= 16 ) {
+		string_copy_small( d, s, n );
+		return dest;
 	}
+
+	/* Non-overlapping, or overlapping with dest below src: a forward copy
+	 * never overwrites source bytes it has not read yet. */
+	if ( (uintptr_t)d - (uintptr_t)s >= n ) {
+		return memcpy( dest, src, n );
+	}
+
+	string_copy_backward( d, s, n );
 	return dest;
 }
 
@@ -47,8 +248,8 @@ char* strcpy( char* dest, const char* src ) {
 
 char* strncpy( char* dest, const char* src, size_t n ) {
 	char* d = dest;
-	while ( n && ( *d++ = *src++ ) != '\0' ) {
-		--n;
+	for ( ; n && *src; --n ) {
+		*d++ = *src++;
 	}
 	while ( n-- ) {
 		*d++ = '\0';
@@ -89,11 +290,55 @@ int memcmp( const void* s1, const void* s2, size_t n ) {
 }
 
 int strcmp( const char* s1, const char* s2 ) {
-	while ( *s1 && ( *s1 == *s2 ) ) {
-		s1++;
-		s2++;
+	const unsigned char* p1 = (const unsigned char*)s1;
+	const unsigned char* p2 = (const unsigned char*)s2;
+
+	while ( (uintptr_t)p1 & 7 ) {
+		if ( *p1 != *p2 || !*p1 ) {
+			return *p1 - *p2;
+		}
+		p1++;
+		p2++;
+	}
+
+	/* p1 is aligned now. If p2 is too, compare whole words; otherwise build
+	 * each p2 word from two aligned loads, and only load the second one once
+	 * the first has been shown not to contain the terminator. */
+	uintptr_t shift = ( (uintptr_t)p2 & 7 ) * 8;
+	if ( shift == 0 ) {
+		for ( ;; ) {
+			uint64_t a = *(const u64_aliased*)p1;
+			uint64_t b = *(const u64_aliased*)p2;
+			if ( a != b || string_zero_bytes( a ) ) {
+				break;
+			}
+			p1 += 8;
+			p2 += 8;
+		}
+	} else {
+		const u64_aliased* w2 = (const u64_aliased*)( p2 - shift / 8 );
+		uint64_t lo = *w2;
+		for ( ;; ) {
+			if ( string_zero_bytes( lo | string_low_bytes( shift / 8 ) ) ) {
+				break;
+			}
+			uint64_t hi = *++w2;
+			uint64_t a = *(const u64_aliased*)p1;
+			uint64_t b = ( lo >> shift ) | ( hi << ( 64 - shift ) );
+			if ( a != b || string_zero_bytes( a ) ) {
+				break;
+			}
+			p1 += 8;
+			p2 += 8;
+			lo = hi;
+		}
 	}
-	return *(unsigned char*)s1 - *(unsigned char*)s2;
+
+	while ( *p1 && *p1 == *p2 ) {
+		p1++;
+		p2++;
+	}
+	return *p1 - *p2;
 }
 
 int strncmp( const char* s1, const char* s2, size_t n ) {
@@ -107,24 +352,47 @@ int strncmp( const char* s1, const char* s2, size_t n ) {
 }
 
 void* memchr( const void* s, int c, size_t n ) {
+	if ( !n ) {
+		return nullptr;
+	}
+
 	const unsigned char* p = (const unsigned char*)( s );
-	while ( n-- ) {
-		if ( *p == c ) {
-			return (void*)p;
+	uintptr_t misalign = (uintptr_t)p & 7;
+	const u64_aliased* w = (const u64_aliased*)( p - misalign );
+	uint64_t pattern = STRING_ONES * (unsigned char)c;
+	uint64_t x = ( *w ^ pattern ) | string_low_bytes( misalign );
+	size_t scanned = 8 - misalign;
+
+	for ( ;; ) {
+		uint64_t z = string_zero_bytes( x );
+		if ( z ) {
+			const unsigned char* hit = (const unsigned char*)w + string_first_byte( z );
+			return (size_t)( hit - p ) < n ? (void*)hit : nullptr;
 		}
-		p++;
+		if ( scanned >= n ) {
+			return nullptr;
+		}
+		x = *++w ^ pattern;
+		scanned += 8;
 	}
-	return nullptr;
 }
 
 char* strchr( const char* s, int c ) {
-	while ( *s ) {
-		if ( *s == c ) {
-			return (char*)s;
+	uintptr_t misalign = (uintptr_t)s & 7;
+	const u64_aliased* w = (const u64_aliased*)( s - misalign );
+	uint64_t pattern = STRING_ONES * (unsigned char)c;
+	uint64_t low = string_low_bytes( misalign );
+	uint64_t x = *w;
+
+	for ( ;; ) {
+		uint64_t z = string_zero_bytes( x | low ) | string_zero_bytes( ( x ^ pattern ) | low );
+		if ( z ) {
+			const char* hit = (const char*)w + string_first_byte( z );
+			return *hit == (char)c ? (char*)hit : nullptr;
 		}
-		s++;
+		x = *++w;
+		low = 0;
 	}
-	return c == 0 ? (char*)s : nullptr;
 }
 
 char* strrchr( const char* s, int c ) {
@@ -138,32 +406,100 @@ char* strrchr( const char* s, int c ) {
 }
 
 size_t strlen( const char* s ) {
-	const char* p = s;
-	while ( *p ) {
-		p++;
+	uintptr_t misalign = (uintptr_t)s & 7;
+	const u64_aliased* w = (const u64_aliased*)( s - misalign );
+	uint64_t x = *w | string_low_bytes( misalign );
+
+	for ( ;; ) {
+		uint64_t z = string_zero_bytes( x );
+		if ( z ) {
+			return (size_t)( (const char*)w + string_first_byte( z ) - s );
+		}
+		x = *++w;
 	}
-	return p - s;
 }
 
 size_t strnlen( const char* s, size_t maxlen ) {
-	const char* p = s;
-	if (maxlen == (size_t)-1) {
-		while ( *p ) {
-			p++;
-		}
-		return p - s;
+	if ( !maxlen ) {
+		return 0;
 	}
-	while ( *p && maxlen-- ) {
-		p++;
+
+	uintptr_t misalign = (uintptr_t)s & 7;
+	const u64_aliased* w = (const u64_aliased*)( s - misalign );
+	uint64_t x = *w | string_low_bytes( misalign );
+	size_t scanned = 8 - misalign;
+
+	for ( ;; ) {
+		uint64_t z = string_zero_bytes( x );
+		if ( z ) {
+			size_t len = (size_t)( (const char*)w + string_first_byte( z ) - s );
+			return len < maxlen ? len : maxlen;
+		}
+		if ( scanned >= maxlen ) {
+			return maxlen;
+		}
+		x = *++w;
+		scanned += 8;
 	}
-	return p - s;
 }
 
 void* memset( void* s, int c, size_t n ) {
 	unsigned char* p = (unsigned char*)( s );
-	while ( n-- ) {
-		*p++ = c;
+	unsigned char b = (unsigned char)c;
+	uint64_t v = 0x0101010101010101ULL * b;
+
+	if ( n <= 16 ) {
+		if ( n >= 8 ) {
+			*(u64_unaligned*)p = v;
+			*(u64_unaligned*)( p + n - 8 ) = v;
+		} else if ( n >= 4 ) {
+			*(u32_unaligned*)p = (uint32_t)v;
+			*(u32_unaligned*)( p + n - 4 ) = (uint32_t)v;
+		} else {
+			while ( n-- ) {
+				*p++ = b;
+			}
+		}
+		return s;
+	}
+
+	unsigned features = string_probe_features();
+	if ( string_is_page( p, n ) ) {
+		if ( features & STRING_FEAT_ERMS ) {
+			string_rep_stosb( p, b, n );
+		} else {
+			string_rep_stosq( p, v, n / 8 );
+		}
+		return s;
+	}
+
+	if ( ( features & STRING_FEAT_FSRM ) ||
+		 ( ( features & STRING_FEAT_ERMS ) && n >= STRING_ERMS_THRESHOLD ) ) {
+		string_rep_stosb( p, b, n );
+		return s;
+	}
+
+	unsigned char* tail = p + n - 8;
+	size_t head = ( 8 - ( (uintptr_t)p & 7 ) ) & 7;
+	*(u64_unaligned*)p = v;
+	p += head;
+	n -= head;
+
+	while ( n >= 32 ) {
+		( (u64_aliased*)p )[ 0 ] = v;
+		( (u64_aliased*)p )[ 1 ] = v;
+		( (u64_aliased*)p )[ 2 ] = v;
+		( (u64_aliased*)p )[ 3 ] = v;
+		p += 32;
+		n -= 32;
+	}
+	while ( n >= 8 ) {
+		*(u64_aliased*)p = v;
+		p += 8;
+		n -= 8;
 	}
+
+	*(u64_unaligned*)tail = v;
 	return s;
 }
 
@@ -302,54 +638,15 @@ int toupper( int c ) {
 }
 
 int atoi( const char* str ) {
-	int res = 0;
-	int sign = 1;
-	while ( isspace( *str ) ) ++str;
-	if ( *str == '-' ) {
-		sign = -1;
-		++str;
-	} else if ( *str == '+' ) {
-		++str;
-	}
-	while ( isdigit( *str ) ) {
-		res = res * 10 + ( *str - '0' );
-		++str;
-	}
-	return sign * res;
+	return (int)strtol( str, nullptr, 10 );
 }
 
 long atol( const char* str ) {
-	long res = 0;
-	int sign = 1;
-	while ( isspace( *str ) ) ++str;
-	if ( *str == '-' ) {
-		sign = -1;
-		++str;
-	} else if ( *str == '+' ) {
-		++str;
-	}
-	while ( isdigit( *str ) ) {
-		res = res * 10 + ( *str - '0' );
-		++str;
-	}
-	return sign * res;
+	return strtol( str, nullptr, 10 );
 }
 
 long long atoll( const char* str ) {
-	long long res = 0;
-	int sign = 1;
-	while ( isspace( *str ) ) ++str;
-	if ( *str == '-' ) {
-		sign = -1;
-		++str;
-	} else if ( *str == '+' ) {
-		++str;
-	}
-	while ( isdigit( *str ) ) {
-		res = res * 10 + ( *str - '0' );
-		++str;
-	}
-	return sign * res;
+	return strtoll( str, nullptr, 10 );
 }
 
 static char* reverse( char* str, int length ) {
@@ -431,122 +728,85 @@ char* lltoa( long long num, char* str, int base ) {
 	return reverse( str, i );
 }
 
-long strtol( const char* str, char** endptr, int base ) {
-	if ( base < 0 || base == 1 || base > 36 ) {
-		return 0;
-	}
-
-	const char* start = str;
-	while ( isspace( *str ) ) {
-		++str;
-	}
-
-	int sign = 1;
-	if ( *str == '-' ) {
-		sign = -1;
-		++str;
-	} else if ( *str == '+' ) {
-		++str;
-	}
-
-	long result = 0;
-	long limit = sign == -1 ? LONG_MIN : LONG_MAX;
-	long overflow_threshold = limit / base;
-
-	bool valid = false;
-	while ( *str ) {
-		int digit = 0;
-		if ( isdigit( *str ) ) {
-			digit = *str - '0';
-		} else if ( isalpha( *str ) ) {
-			digit = tolower( *str ) - 'a' + 10;
-		} else {
-			break;
-		}
-
-		if ( digit >= base ) {
-			break;
-		}
-
-		if ( result < overflow_threshold || ( result == overflow_threshold && digit > limit % base ) ) {
-			result = sign == -1 ? LONG_MIN : LONG_MAX;
-			valid = true;
-			break;
-		}
-
-		result = result * base + digit;
-		valid = true;
-		++str;
-	}
-
-	if ( !valid ) {
-		str = start;
-		result = 0;
+/* Value of c as a digit in any base up to 36, or 36 if it is none. */
+static int string_digit( char c ) {
+	if ( isdigit( c ) ) {
+		return c - '0';
 	}
-
-	if ( endptr ) {
-		*endptr = (char*)( str );
+	if ( isalpha( c ) ) {
+		return tolower( c ) - 'a' + 10;
 	}
-
-	return sign * result;
+	return 36;
 }
 
-long long strtoll( const char* str, char** endptr, int base ) {
+/* The common part of strtol and strtoll: parses an optionally signed number
+ * and returns its magnitude, clamped to max (or max + 1 when negative). With
+ * base 0 the prefix picks it: 0x for 16, 0 for 8, else 10. Digits past an
+ * overflow are still consumed, so *endptr ends up after the number. */
+static unsigned long long string_parse( const char* str, char** endptr, int base,
+                                        unsigned long long max, bool* negative ) {
+	const char* s = str;
+	*negative = false;
 	if ( base < 0 || base == 1 || base > 36 ) {
+		if ( endptr ) {
+			*endptr = (char*)str;
+		}
 		return 0;
 	}
 
-	const char* start = str;
-	while ( isspace( *str ) ) {
-		++str;
+	while ( isspace( *s ) ) {
+		++s;
 	}
-
-	int sign = 1;
-	if ( *str == '-' ) {
-		sign = -1;
-		++str;
-	} else if ( *str == '+' ) {
-		++str;
+	if ( *s == '-' ) {
+		*negative = true;
+		++s;
+	} else if ( *s == '+' ) {
+		++s;
 	}
 
-	long long result = 0;
-	long long limit = sign == -1 ? LLONG_MIN : LLONG_MAX;
-	long long overflow_threshold = limit / base;
-
-	bool valid = false;
-	while ( *str ) {
-		int digit = 0;
-		if ( isdigit( *str ) ) {
-			digit = *str - '0';
-		} else if ( isalpha( *str ) ) {
-			digit = tolower( *str ) - 'a' + 10;
-		} else {
-			break;
-		}
+	if ( ( base == 0 || base == 16 ) && s[ 0 ] == '0' && ( s[ 1 ] == 'x' || s[ 1 ] == 'X' ) &&
+	     string_digit( s[ 2 ] ) < 16 ) {
+		s += 2;
+		base = 16;
+	} else if ( base == 0 ) {
+		base = s[ 0 ] == '0' ? 8 : 10;
+	}
 
+	unsigned long long limit = max + ( *negative ? 1 : 0 );
+	unsigned long long result = 0;
+	bool any = false;
+	bool overflow = false;
+	for ( ;; ++s ) {
+		int digit = string_digit( *s );
 		if ( digit >= base ) {
 			break;
 		}
-
-		if ( result < overflow_threshold || ( result == overflow_threshold && digit > limit % base ) ) {
-			result = sign == -1 ? LLONG_MIN : LLONG_MAX;
-			valid = true;
-			break;
+		any = true;
+		if ( result > ( limit - (unsigned)digit ) / (unsigned)base ) {
+			overflow = true;
+		} else {
+			result = result * (unsigned)base + (unsigned)digit;
 		}
-
-		result = result * base + digit;
-		valid = true;
-		++str;
-	}
-
-	if ( !valid ) {
-		str = start;
-		result = 0;
 	}
 
 	if ( endptr ) {
-		*endptr = (char*)( str );
+		*endptr = (char*)( any ? s : str );
 	}
+	if ( !any ) {
+		*negative = false;
+		return 0;
+	}
+	return overflow ? limit : result;
+}
 
-	return sign * result;
-}
\ No newline at end of file
+long strtol( const char* str, char** endptr, int base ) {
+	bool negative;
+	unsigned long long m = string_parse( str, endptr, base, LONG_MAX, &negative );
+	return negative ? -(long)( m - 1 ) - 1 : (long)m;
+}
+
+long long strtoll( const char* str, char** endptr, int base ) {
+	bool negative;
+	unsigned long long m = string_parse( str, endptr, base, LLONG_MAX, &negative );
+	return negative ? -(long long)( m - 1 ) - 1 : (long long)m;
+}
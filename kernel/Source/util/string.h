@@ -7,6 +7,10 @@
 
 #include <stddef.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void* memcpy( void* dest, const void* src, size_t n );
 void* memmove( void* dest, const void* src, size_t n );
 char* strcpy( char* dest, const char* src );
@@ -50,4 +54,8 @@ char* lltoa( long long num, char* str, int base );
 long strtol( const char* str, char** endptr, int base );
 long long strtoll( const char* str, char** endptr, int base );
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif //STRING_H
\ No newline at end of file